@@ -0,0 +1,308 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/decodeahead.h"
+#include "audio/audiostream.h"
+
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+namespace Audio {
+
+class DecodeAheadStream;
+
+/**
+ * Runs the decoding of all decode-ahead streams from a single timer
+ * callback. The timer manager does not allow installing one callback
+ * several times, hence the streams are kept in a list instead of each
+ * installing its own timer.
+ */
+class DecodeAheadWorker : public Common::Singleton<DecodeAheadWorker> {
+public:
+	void addStream(DecodeAheadStream *stream);
+
+	/**
+	 * Remove a stream from the worker. When this returns, the worker is
+	 * guaranteed not to touch the stream anymore.
+	 */
+	void removeStream(DecodeAheadStream *stream);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+
+	DecodeAheadWorker() : _installed(false) {}
+
+	static void timerProc(void *refCon);
+	void run();
+
+	typedef Common::List<DecodeAheadStream *> StreamList;
+	StreamList _streams;
+	bool _installed;
+
+	// The timer thread walks the list while the engine adds and the mixer
+	// thread removes streams
+	Common::Mutex _mutex;
+	Common::Mutex _installMutex;
+};
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::DecodeAheadWorker);
+}
+
+namespace Audio {
+
+enum {
+	// How often the worker runs, in microseconds
+	kDecodeAheadInterval = 10000
+};
+
+class DecodeAheadStream : public SeekableAudioStream {
+public:
+	DecodeAheadStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint bufferMsecs);
+	~DecodeAheadStream();
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool isStereo() const { return _isStereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const;
+	bool seek(const Timestamp &where);
+	Timestamp getLength() const { return _length; }
+
+	/** Decode into the ring buffer; called from the worker. */
+	void decodeAhead();
+
+private:
+	/** Copy up to numSamples decoded samples out of the ring buffer. */
+	int readRing(int16 *buffer, int numSamples);
+
+	SeekableAudioStream *_parent;
+	const DisposeAfterUse::Flag _disposeAfterUse;
+
+	const bool _isStereo;
+	const int _rate;
+	const Timestamp _length;
+
+	int16 *_ring;
+	uint _ringSize;
+	uint _readPos;
+	uint _writePos;
+	uint _filled;
+
+	// Set when the parent stream has no more data to decode
+	bool _parentEnd;
+
+	// Guards all accesses to the parent stream, including the part of the
+	// ring buffer being decoded into. Only the holder of this mutex may
+	// advance the write position.
+	Common::Mutex _parentMutex;
+
+	// Guards the ring buffer positions, which are shared between the
+	// worker and the mixer thread
+	mutable Common::Mutex _ringMutex;
+};
+
+DecodeAheadStream::DecodeAheadStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint bufferMsecs)
+	: _parent(parent), _disposeAfterUse(disposeAfterUse),
+	  _isStereo(parent->isStereo()), _rate(parent->getRate()), _length(parent->getLength()),
+	  _readPos(0), _writePos(0), _filled(0), _parentEnd(parent->endOfData()) {
+
+	const uint channels = _isStereo ? 2 : 1;
+	_ringSize = MAX<uint>((uint)((uint64)_rate * bufferMsecs / 1000), 1024) * channels;
+	_ring = new int16[_ringSize];
+
+	DecodeAheadWorker::instance().addStream(this);
+}
+
+DecodeAheadStream::~DecodeAheadStream() {
+	DecodeAheadWorker::instance().removeStream(this);
+
+	delete[] _ring;
+	if (_disposeAfterUse == DisposeAfterUse::YES)
+		delete _parent;
+}
+
+int DecodeAheadStream::readRing(int16 *buffer, int numSamples) {
+	Common::StackLock lock(_ringMutex);
+
+	int samples = MIN<int>(numSamples, _filled);
+	const int total = samples;
+
+	while (samples > 0) {
+		const int len = MIN<int>(samples, _ringSize - _readPos);
+		memcpy(buffer, _ring + _readPos, len * sizeof(int16));
+
+		buffer += len;
+		samples -= len;
+		_readPos += len;
+		if (_readPos == _ringSize)
+			_readPos = 0;
+	}
+
+	_filled -= total;
+	return total;
+}
+
+int DecodeAheadStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = 0;
+
+	while (samples < numSamples) {
+		samples += readRing(buffer + samples, numSamples - samples);
+		if (samples == numSamples)
+			break;
+
+		// The ring buffer ran dry. Wait for the worker to finish what it is
+		// decoding right now; if that doesn't help, decode directly.
+		Common::StackLock lock(_parentMutex);
+
+		{
+			Common::StackLock ringLock(_ringMutex);
+			if (_filled)
+				continue;
+			if (_parentEnd)
+				break;
+		}
+
+		const int len = _parent->readBuffer(buffer + samples, numSamples - samples);
+
+		Common::StackLock ringLock(_ringMutex);
+		if (len > 0)
+			samples += len;
+		if (len <= 0 || _parent->endOfData()) {
+			_parentEnd = true;
+			break;
+		}
+	}
+
+	return samples;
+}
+
+bool DecodeAheadStream::endOfData() const {
+	Common::StackLock lock(_ringMutex);
+	return _parentEnd && !_filled;
+}
+
+bool DecodeAheadStream::seek(const Timestamp &where) {
+	Common::StackLock lock(_parentMutex);
+
+	const bool result = _parent->seek(where);
+
+	Common::StackLock ringLock(_ringMutex);
+	_readPos = _writePos = _filled = 0;
+	_parentEnd = !result || _parent->endOfData();
+
+	return result;
+}
+
+void DecodeAheadStream::decodeAhead() {
+	Common::StackLock lock(_parentMutex);
+
+	uint writePos, space;
+	{
+		Common::StackLock ringLock(_ringMutex);
+		if (_parentEnd)
+			return;
+
+		writePos = _writePos;
+		space = _ringSize - _filled;
+	}
+
+	// Don't keep the timer thread busy for too long in one go; at a quarter
+	// of the ring buffer per run the worker still decodes far faster than
+	// realtime.
+	space = MIN(space, _ringSize / 4);
+	if (_isStereo)
+		space &= ~1;
+
+	while (space > 0) {
+		// Decode straight into the free part of the ring buffer. The mixer
+		// thread only ever reads the filled part, so this needs no lock.
+		const uint len = MIN(space, _ringSize - writePos);
+		const int decoded = _parent->readBuffer(_ring + writePos, len);
+
+		Common::StackLock ringLock(_ringMutex);
+		if (decoded > 0) {
+			writePos += decoded;
+			if (writePos == _ringSize)
+				writePos = 0;
+			_writePos = writePos;
+			_filled += decoded;
+			space -= decoded;
+		}
+
+		if (decoded <= 0 || _parent->endOfData()) {
+			_parentEnd = true;
+			break;
+		}
+
+		if ((uint)decoded < len)
+			break;
+	}
+}
+
+void DecodeAheadWorker::addStream(DecodeAheadStream *stream) {
+	{
+		Common::StackLock lock(_mutex);
+		_streams.push_back(stream);
+	}
+
+	// The timer manager calls us with its own mutex held, so _mutex must not
+	// be held while installing the callback. It then stays installed:
+	// removing it when the last stream is deleted would call into the timer
+	// manager from the mixer thread, which may deadlock with other timer
+	// callbacks using the mixer.
+	Common::StackLock lock(_installMutex);
+	if (!_installed) {
+		g_system->getTimerManager()->installTimerProc(&timerProc, kDecodeAheadInterval, this, "DecodeAheadWorker");
+		_installed = true;
+	}
+}
+
+void DecodeAheadWorker::removeStream(DecodeAheadStream *stream) {
+	Common::StackLock lock(_mutex);
+	_streams.remove(stream);
+}
+
+void DecodeAheadWorker::timerProc(void *refCon) {
+	((DecodeAheadWorker *)refCon)->run();
+}
+
+void DecodeAheadWorker::run() {
+	Common::StackLock lock(_mutex);
+
+	for (StreamList::iterator i = _streams.begin(); i != _streams.end(); ++i)
+		(*i)->decodeAhead();
+}
+
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint bufferMsecs) {
+	if (!parent)
+		return 0;
+
+	return new DecodeAheadStream(parent, disposeAfterUse, bufferMsecs);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,58 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_DECODEAHEAD_H
+#define AUDIO_DECODEAHEAD_H
+
+#include "common/scummsys.h"
+#include "common/types.h"
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/**
+ * Wrap a stream so that it is decoded ahead of playback.
+ *
+ * Decoders like FLAC and Vorbis normally do all their work in readBuffer,
+ * i.e. inside the mixer callback. The returned stream instead decodes the
+ * wrapped stream from a timer callback into a ring buffer, and the mixer
+ * merely copies the decoded samples. Should the ring buffer ever run dry,
+ * the samples are decoded directly, so the output is always the same as
+ * that of the wrapped stream.
+ *
+ * Seeking the returned stream flushes the ring buffer; decoding then
+ * continues from the new position.
+ *
+ * @param parent	the stream to decode ahead
+ * @param disposeAfterUse	whether to delete the parent stream along
+ *                      with the returned stream
+ * @param bufferMsecs	how much audio to decode ahead, in milliseconds
+ * @return a new SeekableAudioStream, or 0 if parent was 0
+ */
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *parent,
+                                           DisposeAfterUse::Flag disposeAfterUse,
+                                           uint bufferMsecs = 500);
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,232 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/decodedcache.h"
+#include "audio/audiostream.h"
+
+#include "common/debug.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::DecodedAudioCache);
+}
+
+namespace Audio {
+
+struct DecodedAudioCache::CachedSound {
+	int16 *samples;
+	uint32 numSamples;	///< number of int16 samples (not frames)
+	int rate;
+	bool stereo;
+
+	CachedSound() : samples(0), numSamples(0), rate(0), stereo(false) {}
+	~CachedSound() { free(samples); }
+
+	uint32 getMemorySize() const { return numSamples * sizeof(int16); }
+};
+
+/**
+ * A stream playing a sound from the decoded audio cache.
+ */
+class CachedAudioStream : public SeekableAudioStream {
+public:
+	CachedAudioStream(DecodedAudioCache &cache, const Common::SharedPtr<DecodedAudioCache::CachedSound> &sound)
+		: _cache(cache), _sound(sound), _pos(0) {}
+
+	~CachedAudioStream() {
+		// The last reference may be released here, from the mixer thread
+		Common::StackLock lock(_cache._mutex);
+		_sound.reset();
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = MIN<int>(numSamples, _sound->numSamples - _pos);
+		memcpy(buffer, _sound->samples + _pos, samples * sizeof(int16));
+		_pos += samples;
+		return samples;
+	}
+
+	bool isStereo() const { return _sound->stereo; }
+	int getRate() const { return _sound->rate; }
+	bool endOfData() const { return _pos >= _sound->numSamples; }
+
+	bool seek(const Timestamp &where) {
+		const uint32 channels = _sound->stereo ? 2 : 1;
+		const uint32 pos = where.convertToFramerate(_sound->rate).totalNumberOfFrames() * channels;
+		if (pos > _sound->numSamples)
+			return false;
+		_pos = pos;
+		return true;
+	}
+
+	Timestamp getLength() const {
+		return Timestamp(0, _sound->numSamples / (_sound->stereo ? 2 : 1), _sound->rate);
+	}
+
+private:
+	DecodedAudioCache &_cache;
+	Common::SharedPtr<DecodedAudioCache::CachedSound> _sound;
+	uint32 _pos;
+};
+
+DecodedAudioCache::DecodedAudioCache() : _maxMemory(4 * 1024 * 1024), _memoryUsed(0), _useCounter(0) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+DecodedAudioCache::~DecodedAudioCache() {
+	clear();
+}
+
+Common::String DecodedAudioCache::makeKey(const Common::String &name, uint32 offset, uint32 params) {
+	return Common::String::format("%s:%u:%u", name.c_str(), offset, params);
+}
+
+SeekableAudioStream *DecodedAudioCache::getStream(const Common::String &name, uint32 offset, uint32 params) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator it = _entries.find(makeKey(name, offset, params));
+	if (it == _entries.end()) {
+		_stats.misses++;
+		return 0;
+	}
+
+	_stats.hits++;
+	it->_value.lastUse = ++_useCounter;
+	return new CachedAudioStream(*this, it->_value.sound);
+}
+
+SeekableAudioStream *DecodedAudioCache::addStream(const Common::String &name, uint32 offset, uint32 params, SeekableAudioStream *stream) {
+	if (!stream)
+		return 0;
+
+	const int channels = stream->isStereo() ? 2 : 1;
+	const uint32 maxSize = _maxMemory / 4;
+
+	// Don't even start decoding sounds which are known to be too large
+	const Timestamp length = stream->getLength();
+	if ((uint64)length.convertToFramerate(stream->getRate()).totalNumberOfFrames() * channels * sizeof(int16) > maxSize)
+		return stream;
+
+	// Decode the whole sound. The length is only used as a hint, since
+	// not every decoder knows the exact length of its stream.
+	Common::SharedPtr<CachedSound> sound(new CachedSound());
+	sound->rate = stream->getRate();
+	sound->stereo = stream->isStereo();
+
+	uint32 capacity = 0;
+	bool cacheSound = true;
+	while (!stream->endOfData()) {
+		if (sound->numSamples + 2048 > capacity) {
+			capacity = MAX<uint32>(capacity * 2, 8192);
+			if (cacheSound && capacity * sizeof(int16) > maxSize) {
+				// Too large after all
+				if (stream->rewind())
+					return stream;
+
+				// What has been read is lost to the stream, so decode the
+				// rest as well, but don't keep the sound in the cache
+				warning("DecodedAudioCache: Could not rewind %s, playing it uncached", makeKey(name, offset, params).c_str());
+				cacheSound = false;
+			}
+			sound->samples = (int16 *)realloc(sound->samples, capacity * sizeof(int16));
+		}
+
+		const int samples = stream->readBuffer(sound->samples + sound->numSamples, 2048);
+		if (samples <= 0)
+			break;
+		sound->numSamples += samples;
+	}
+
+	delete stream;
+
+	// Give back the unused part of the buffer
+	if (sound->numSamples)
+		sound->samples = (int16 *)realloc(sound->samples, sound->numSamples * sizeof(int16));
+
+	Common::StackLock lock(_mutex);
+
+	if (!cacheSound) {
+		SeekableAudioStream *uncachedStream = new CachedAudioStream(*this, sound);
+		sound.reset();
+		return uncachedStream;
+	}
+
+	const Common::String key = makeKey(name, offset, params);
+	EntryMap::iterator it = _entries.find(key);
+	if (it != _entries.end()) {
+		_memoryUsed -= it->_value.sound->getMemorySize();
+		_entries.erase(it);
+	}
+
+	evict(sound->getMemorySize());
+
+	Entry &entry = _entries[key];
+	entry.sound = sound;
+	entry.lastUse = ++_useCounter;
+	_memoryUsed += sound->getMemorySize();
+
+	debug(5, "DecodedAudioCache: Added %s (%d bytes, %d bytes in use)", key.c_str(), sound->getMemorySize(), _memoryUsed);
+
+	SeekableAudioStream *cachedStream = new CachedAudioStream(*this, sound);
+	// Drop our reference while still holding the lock
+	sound.reset();
+	return cachedStream;
+}
+
+void DecodedAudioCache::evict(uint32 neededMemory) {
+	// Drop the least recently used sounds until the new one fits
+	while (!_entries.empty() && _memoryUsed + neededMemory > _maxMemory) {
+		EntryMap::iterator oldest = _entries.begin();
+		for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+			if (it->_value.lastUse < oldest->_value.lastUse)
+				oldest = it;
+		}
+
+		debug(5, "DecodedAudioCache: Evicting %s", oldest->_key.c_str());
+		_memoryUsed -= oldest->_value.sound->getMemorySize();
+		_entries.erase(oldest);
+		_stats.evictions++;
+	}
+}
+
+void DecodedAudioCache::setMaxMemory(uint32 bytes) {
+	Common::StackLock lock(_mutex);
+	_maxMemory = bytes;
+	evict(0);
+}
+
+void DecodedAudioCache::clear() {
+	Common::StackLock lock(_mutex);
+	_entries.clear();
+	_memoryUsed = 0;
+}
+
+DecodedAudioCache::Stats DecodedAudioCache::getStats() const {
+	Common::StackLock lock(_mutex);
+	Stats stats = _stats;
+	stats.memoryUsed = _memoryUsed;
+	stats.sounds = _entries.size();
+	return stats;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,138 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_DECODEDCACHE_H
+#define AUDIO_DECODEDCACHE_H
+
+#include "common/scummsys.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/str.h"
+#include "common/types.h"
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/**
+ * A cache for the decoded PCM data of short sounds which are played
+ * over and over again, like sound effects.
+ *
+ * Sounds are identified by the name of the file (or archive member)
+ * they come from, their offset in it and an engine specific value
+ * describing how they are decoded (e.g. the RawFlags or the ADPCM type).
+ * Cached sounds are handed out as streams playing from the shared
+ * decoded buffer, so playing a cached sound neither reads nor decodes
+ * anything.
+ *
+ * The cache is limited to a memory budget; when it is exceeded, the
+ * sounds which were least recently used are dropped. Streams which are
+ * still playing a dropped sound keep its data alive until they are
+ * deleted.
+ *
+ * Typical use:
+ * @code
+ * Audio::SeekableAudioStream *stream = DecodedAudioCacheMan.getStream(name, offset, flags);
+ * if (!stream)
+ *     stream = DecodedAudioCacheMan.addStream(name, offset, flags, makeVOCStream(...));
+ * @endcode
+ */
+class DecodedAudioCache : public Common::Singleton<DecodedAudioCache> {
+public:
+	struct CachedSound;
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+		uint32 memoryUsed;
+		uint32 sounds;
+	};
+
+	/**
+	 * Return a new stream playing the cached sound, or 0 if the
+	 * sound is not cached.
+	 */
+	SeekableAudioStream *getStream(const Common::String &name, uint32 offset, uint32 params);
+
+	/**
+	 * Decode the given stream into the cache and return a stream playing
+	 * the cached data instead. The passed stream is deleted in that case.
+	 *
+	 * If the sound is too large to be cached (more than a quarter of the
+	 * memory budget), the passed stream is returned unchanged, rewound to
+	 * its start. If it cannot be rewound, the sound is decoded completely
+	 * anyway and played from memory without being cached.
+	 *
+	 * @param name	name of the file or archive member the sound comes from
+	 * @param offset	offset of the sound data in that file
+	 * @param params	engine specific decoding parameters
+	 * @param stream	the decoder stream for the sound; may be 0
+	 */
+	SeekableAudioStream *addStream(const Common::String &name, uint32 offset, uint32 params, SeekableAudioStream *stream);
+
+	/** Set the memory budget of the cache in bytes (default: 4 MB). */
+	void setMaxMemory(uint32 bytes);
+	uint32 getMaxMemory() const { return _maxMemory; }
+
+	/** Drop all cached sounds, e.g. when an engine quits. */
+	void clear();
+
+	Stats getStats() const;
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	friend class CachedAudioStream;
+
+	DecodedAudioCache();
+	~DecodedAudioCache();
+
+	struct Entry {
+		Common::SharedPtr<CachedSound> sound;
+		uint32 lastUse;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(const Common::String &name, uint32 offset, uint32 params);
+	void evict(uint32 neededMemory);
+
+	EntryMap _entries;
+	uint32 _maxMemory;
+	uint32 _memoryUsed;
+	uint32 _useCounter;
+	Stats _stats;
+
+	// Streams handed out are deleted by the mixer thread, while the engine
+	// adds and looks up sounds, so the reference counts need protection
+	mutable Common::Mutex _mutex;
+};
+
+} // End of namespace Audio
+
+/** Shortcut for accessing the decoded audio cache. */
+#define DecodedAudioCacheMan (::Audio::DecodedAudioCache::instance())
+
+#endif
@@ -46,14 +46,72 @@ ADPCMStream::ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Fl
 		_endpos(_startpos + size),
 		_channels(channels),
 		_blockAlign(blockAlign),
-		_rate(rate) {
+		_rate(rate),
+		_blockData(0),
+		_blockDataSize(0),
+		_blockSamples(0),
+		_blockMaxSamples(0) {
 
 	reset();
 }
 
+ADPCMStream::~ADPCMStream() {
+	delete[] _blockData;
+	delete[] _blockSamples;
+}
+
 void ADPCMStream::reset() {
 	memset(&_status, 0, sizeof(_status));
 	_blockPos[0] = _blockPos[1] = _blockAlign; // To make sure first header is read
+	_blockSampleCount = _blockSamplePos = 0;
+}
+
+uint32 ADPCMStream::readData(byte *data, uint32 size) {
+	const int32 left = _endpos - _stream->pos();
+	if (left <= 0)
+		return 0;
+
+	return _stream->read(data, MIN<uint32>(size, left));
+}
+
+void ADPCMStream::allocateBlock(uint32 dataSize, int maxSamples) {
+	delete[] _blockData;
+	delete[] _blockSamples;
+
+	_blockDataSize = dataSize;
+	_blockData = new byte[dataSize];
+	_blockMaxSamples = maxSamples;
+	_blockSamples = new int16[maxSamples];
+	_blockSampleCount = _blockSamplePos = 0;
+}
+
+int ADPCMStream::readBlocks(int16 *buffer, const int numSamples) {
+	int samples = 0;
+
+	while (samples < numSamples) {
+		// Hand out what is left of the last block first
+		if (_blockSamplePos < _blockSampleCount) {
+			const int len = MIN(numSamples - samples, _blockSampleCount - _blockSamplePos);
+			memcpy(buffer + samples, _blockSamples + _blockSamplePos, len * sizeof(int16));
+			samples += len;
+			_blockSamplePos += len;
+			continue;
+		}
+
+		const uint32 size = readData(_blockData, _blockDataSize);
+		if (!size)
+			break;
+
+		// Decode straight into the caller's buffer if the whole block fits
+		if (numSamples - samples >= _blockMaxSamples) {
+			samples += decodeBlock(_blockData, size, buffer + samples);
+		} else {
+			_blockSampleCount = decodeBlock(_blockData, size, _blockSamples);
+			_blockSamplePos = 0;
+		}
+	}
+
+	return samples;
 }
 
 bool ADPCMStream::rewind() {
@@ -68,20 +126,31 @@ bool ADPCMStream::rewind() {
 
 
 int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
-			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
-			_decodedSampleCount = 2;
-		}
+	int samples = 0;
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+	// Return the sample left over from the last byte
+	if (_decodedSampleCount && samples < numSamples) {
+		buffer[samples++] = _decodedSamples[1];
+		_decodedSampleCount = 0;
+	}
+
+	// Decode as many whole bytes as fit in one go
+	byte data[512];
+	while (numSamples - samples >= 2) {
+		const uint32 size = readData(data, MIN<uint32>(sizeof(data), (numSamples - samples) / 2));
+		if (!size)
+			break;
+
+		decodeOKIBlock(data, size, buffer + samples);
+		samples += size * 2;
+	}
+
+	// An odd number of samples was asked for
+	if (samples < numSamples && !endOfData()) {
+		const byte code = _stream->readByte();
+		buffer[samples++] = decodeOKI((code >> 4) & 0x0f);
+		_decodedSamples[1] = decodeOKI((code >> 0) & 0x0f);
+		_decodedSampleCount = 1;
 	}
 
 	return samples;
@@ -115,25 +184,62 @@ int16 Oki_ADPCMStream::decodeOKI(byte code) {
 	return samp * 16;
 }
 
+void Oki_ADPCMStream::decodeOKIBlock(const byte *data, uint32 size, int16 *output) {
+	// Same as decodeOKI(), with the state kept in locals
+	int32 last = _status.ima_ch[0].last;
+	int32 stepIndex = _status.ima_ch[0].stepIndex;
+
+	for (uint32 i = 0; i < size * 2; ++i) {
+		const byte code = (i & 1) ? (data[i >> 1] & 0x0f) : (data[i >> 1] >> 4);
+		const int32 E = (2 * (code & 0x7) + 1) * okiStepSize[stepIndex] / 8;
+		const int32 sign = -(int32)(code >> 3);
+
+		// Clip the values to +/- 2^11 (supposed to be 12 bits)
+		last = CLIP<int32>(last + ((E ^ sign) - sign), -2048, 2047);
+		stepIndex = CLIP<int32>(stepIndex + _stepAdjustTable[code], 0, ARRAYSIZE(okiStepSize) - 1);
+
+		// * 16 effectively converts 12-bit input to 16-bit output
+		output[i] = last * 16;
+	}
+
+	_status.ima_ch[0].last = last;
+	_status.ima_ch[0].stepIndex = stepIndex;
+}
+
 
 #pragma mark -
 
 
 int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
-			_decodedSampleCount = 2;
-		}
+	int samples = 0;
+
+	// Return the sample left over from the last byte
+	if (_decodedSampleCount && samples < numSamples) {
+		buffer[samples++] = _decodedSamples[1];
+		_decodedSampleCount = 0;
+	}
+
+	// Decode as many whole bytes as fit in one go. Each byte holds one
+	// sample for each channel in stereo streams.
+	byte data[512];
+	while (numSamples - samples >= 2) {
+		const uint32 size = readData(data, MIN<uint32>(sizeof(data), (numSamples - samples) / 2));
+		if (!size)
+			break;
+
+		if (_channels == 2)
+			decodeIMAStereoBlock(data, size, buffer + samples);
+		else
+			decodeIMABlock(data, size, buffer + samples, 1, 0, false);
+		samples += size * 2;
+	}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+	// An odd number of samples was asked for
+	if (samples < numSamples && !endOfData()) {
+		const byte code = _stream->readByte();
+		buffer[samples++] = decodeIMA((code >> 4) & 0x0f, 0);
+		_decodedSamples[1] = decodeIMA((code >> 0) & 0x0f, _channels == 2 ? 1 : 0);
+		_decodedSampleCount = 1;
 	}
 
 	return samples;
@@ -146,63 +252,40 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	// Need to write at least one samples per channel
 	assert((numSamples % _channels) == 0);
 
-	// Current sample positions
-	int samples[2] = { 0, 0};
-
-	// Number of samples per channel
-	int chanSamples = numSamples / _channels;
+	return readBlocks(buffer, numSamples);
+}
 
+int Apple_ADPCMStream::decodeBlock(const byte *data, uint32 size, int16 *output) {
+	// The blocks may be cut short at the end of the data. Each channel's
+	// block starts at a multiple of _blockAlign, so the last channel is cut
+	// first. Only decode as much as every channel has.
+	uint32 blockSize = _blockAlign;
 	for (int i = 0; i < _channels; i++) {
-		_stream->seek(_streamPos[i]);
-
-		while ((samples[i] < chanSamples) &&
-		       // Last byte read and a new one needed
-		       !((_stream->eos() || (_stream->pos() >= _endpos)) && (_chunkPos[i] == 0))) {
-
-			if (_blockPos[i] == _blockAlign) {
-				// 2 byte header per block
-				uint16 temp = _stream->readUint16BE();
-
-				// First 9 bits are the upper bits of the predictor
-				_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
-				// Lower 7 bits are the step index
-				_status.ima_ch[i].stepIndex =          temp & 0x007F;
-
-				// Clip the step index
-				_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
-
-				_blockPos[i] = 2;
-			}
-
-			if (_chunkPos[i] == 0) {
-				// Decode data
-				byte data = _stream->readByte();
-				_buffer[i][0] = decodeIMA(data &  0x0F, i);
-				_buffer[i][1] = decodeIMA(data >>    4, i);
-			}
+		const uint32 start = i * _blockAlign;
+		blockSize = MIN<uint32>(blockSize, size > start ? size - start : 0);
+	}
+	if (blockSize <= 2)
+		return 0;
 
-			// The original is interleaved block-wise, we want it sample-wise
-			buffer[_channels * samples[i] + i] = _buffer[i][_chunkPos[i]];
+	for (int i = 0; i < _channels; i++) {
+		const byte *block = data + i * _blockAlign;
 
-			if (++_chunkPos[i] > 1) {
-				// We're about to decode the next byte, so advance the block position
-				_chunkPos[i] = 0;
-				_blockPos[i]++;
-			}
+		// 2 byte header per block
+		uint16 temp = READ_BE_UINT16(block);
 
-			samples[i]++;
+		// First 9 bits are the upper bits of the predictor
+		_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
+		// Lower 7 bits are the step index
+		_status.ima_ch[i].stepIndex =          temp & 0x007F;
 
-			if (_channels == 2)
-				if (_blockPos[i] == _blockAlign)
-					// We're at the end of the block.
-					// Since the channels are interleaved, skip the next block
-					_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+		// Clip the step index
+		_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
 
-			_streamPos[i] = _stream->pos();
-		}
+		// The original is interleaved block-wise, we want it sample-wise
+		decodeIMABlock(block + 2, blockSize - 2, output + i, _channels, i, true);
 	}
 
-	return samples[0] + samples[1];
+	return (blockSize - 2) * 2 * _channels;
 }
 
 
@@ -213,42 +296,34 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	// Need to write at least one sample per channel
 	assert((numSamples % _channels) == 0);
 
-	int samples = 0;
+	return readBlocks(buffer, numSamples);
+}
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
-
-			_blockPos[0] = _channels * 4;
-		}
+int MSIma_ADPCMStream::decodeBlock(const byte *data, uint32 size, int16 *output) {
+	if (size < (uint32)_channels * 4)
+		return 0;
 
-		// Decode a set of samples
-		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
-			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
-			}
-		}
+	for (int i = 0; i < _channels; i++) {
+		// read block header
+		_status.ima_ch[i].last = (int16)READ_LE_UINT16(data);
+		_status.ima_ch[i].stepIndex = (int16)READ_LE_UINT16(data + 2);
+		data += 4;
+	}
 
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
-			}
+	// The stream encodes four bytes per channel at a time. A set cut
+	// short at the end of the data is dropped.
+	const uint32 sets = (size - _channels * 4) / (_channels * 4);
 
-			samples += _channels;
+	for (uint32 set = 0; set < sets; set++) {
+		for (int i = 0; i < _channels; i++) {
+			decodeIMABlock(data, 4, output + i, _channels, i, true);
+			data += 4;
 		}
+
+		output += 8 * _channels;
 	}
 
-	return samples;
+	return sets * 8 * _channels;
 }
 
 
@@ -287,44 +362,40 @@ int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 }
 
 int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	return readBlocks(buffer, numSamples);
+}
+
+int MS_ADPCMStream::decodeBlock(const byte *data, uint32 size, int16 *output) {
 	int i;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			if (_blockPos[0] == _blockAlign) {
-				// read block header
-				for (i = 0; i < _channels; i++) {
-					_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
-					_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
-					_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
-				}
-
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].delta = _stream->readSint16LE();
-
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].sample1 = _stream->readSint16LE();
-
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
-
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
-
-				_blockPos[0] = _channels * 7;
-			} else {
-				data = _stream->readByte();
-				_blockPos[0]++;
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
-			}
-		}
+	if (size < (uint32)_channels * 7)
+		return 0;
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+	// read block header
+	for (i = 0; i < _channels; i++) {
+		_status.ch[i].predictor = CLIP(*data++, (byte)0, (byte)6);
+		_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
+		_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
+	}
+
+	for (i = 0; i < _channels; i++, data += 2)
+		_status.ch[i].delta = (int16)READ_LE_UINT16(data);
+
+	for (i = 0; i < _channels; i++, data += 2)
+		_status.ch[i].sample1 = (int16)READ_LE_UINT16(data);
+
+	// The header holds the first two samples of each channel
+	int samples = 0;
+	for (i = 0; i < _channels; i++, data += 2)
+		output[samples++] = _status.ch[i].sample2 = (int16)READ_LE_UINT16(data);
+
+	for (i = 0; i < _channels; i++)
+		output[samples++] = _status.ch[i].sample1;
+
+	ADPCMChannelStatus *second = &_status.ch[_channels - 1];
+	for (const byte *end = data + size - _channels * 7; data < end; data++) {
+		output[samples++] = decodeMS(&_status.ch[0], (*data >> 4) & 0x0f);
+		output[samples++] = decodeMS(second, *data & 0x0f);
 	}
 
 	return samples;
@@ -433,6 +504,51 @@ int16 Ima_ADPCMStream::decodeIMA(byte code, int channel) {
 	return samp;
 }
 
+// Same as decodeIMA(), with the state kept in locals. Both ways of
+// negating are the same; this one doesn't need a branch.
+static inline int16 decodeIMANibble(byte code, int32 &last, int32 &stepIndex) {
+	const int32 E = (2 * (code & 0x7) + 1) * Ima_ADPCMStream::_imaTable[stepIndex] / 8;
+	const int32 sign = -(int32)(code >> 3);
+
+	last = CLIP<int32>(last + ((E ^ sign) - sign), -32768, 32767);
+	stepIndex = CLIP<int32>(stepIndex + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(Ima_ADPCMStream::_imaTable) - 1);
+
+	return last;
+}
+
+void Ima_ADPCMStream::decodeIMABlock(const byte *data, uint32 size, int16 *output, int stride, int channel, bool lowNibbleFirst) {
+	int32 last = _status.ima_ch[channel].last;
+	int32 stepIndex = _status.ima_ch[channel].stepIndex;
+	const int firstShift = lowNibbleFirst ? 0 : 4;
+	const int secondShift = 4 - firstShift;
+
+	for (uint32 i = 0; i < size; i++) {
+		output[0] = decodeIMANibble((data[i] >> firstShift) & 0x0f, last, stepIndex);
+		output[stride] = decodeIMANibble((data[i] >> secondShift) & 0x0f, last, stepIndex);
+		output += stride * 2;
+	}
+
+	_status.ima_ch[channel].last = last;
+	_status.ima_ch[channel].stepIndex = stepIndex;
+}
+
+void Ima_ADPCMStream::decodeIMAStereoBlock(const byte *data, uint32 size, int16 *output) {
+	int32 lastLeft = _status.ima_ch[0].last;
+	int32 stepIndexLeft = _status.ima_ch[0].stepIndex;
+	int32 lastRight = _status.ima_ch[1].last;
+	int32 stepIndexRight = _status.ima_ch[1].stepIndex;
+
+	for (uint32 i = 0; i < size; i++) {
+		*output++ = decodeIMANibble((data[i] >> 4) & 0x0f, lastLeft, stepIndexLeft);
+		*output++ = decodeIMANibble(data[i] & 0x0f, lastRight, stepIndexRight);
+	}
+
+	_status.ima_ch[0].last = lastLeft;
+	_status.ima_ch[0].stepIndex = stepIndexLeft;
+	_status.ima_ch[1].last = lastRight;
+	_status.ima_ch[1].stepIndex = stepIndexRight;
+}
+
 RewindableAudioStream *makeADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, ADPCMType type, int rate, int channels, uint32 blockAlign) {
 	// If size is 0, report the entire size of the stream
 	if (!size)
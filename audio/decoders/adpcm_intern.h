@@ -57,12 +57,49 @@ protected:
 		} ima_ch[2];
 	} _status;
 
+	// Block based formats decode a whole block at a time. When the caller
+	// asks for less than a block, the rest is kept here.
+	byte *_blockData;
+	uint32 _blockDataSize;
+	int16 *_blockSamples;
+	int _blockMaxSamples;
+	int _blockSampleCount;
+	int _blockSamplePos;
+
 	virtual void reset();
 
+	/**
+	 * Read up to size bytes of ADPCM data in one go, without reading past
+	 * the end of the ADPCM data. Returns the number of bytes read.
+	 */
+	uint32 readData(byte *data, uint32 size);
+
+	/**
+	 * Set up the buffers for decoding whole blocks with readBlocks().
+	 *
+	 * @param dataSize	the number of bytes decoded in one go
+	 * @param maxSamples	the number of samples decoded from dataSize bytes
+	 */
+	void allocateBlock(uint32 dataSize, int maxSamples);
+
+	/**
+	 * Decode a block of size bytes, which is only smaller than the block
+	 * size at the end of the data, into output. Returns the number of
+	 * samples decoded.
+	 */
+	virtual int decodeBlock(const byte *data, uint32 size, int16 *output) { return 0; }
+
+	/**
+	 * readBuffer() implementation for block based formats: decodes whole
+	 * blocks with decodeBlock(), straight into the buffer when they fit.
+	 */
+	int readBlocks(int16 *buffer, const int numSamples);
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
+	~ADPCMStream();
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && _blockSamplePos == _blockSampleCount; }
 	virtual bool isStereo() const { return _channels == 2; }
 	virtual int getRate() const { return _rate; }
 
@@ -89,6 +126,7 @@ public:
 
 protected:
 	int16 decodeOKI(byte);
+	void decodeOKIBlock(const byte *data, uint32 size, int16 *output);
 
 private:
 	uint8 _decodedSampleCount;
@@ -99,6 +137,18 @@ class Ima_ADPCMStream : public ADPCMStream {
 protected:
 	int16 decodeIMA(byte code, int channel = 0); // Default to using the left channel/using one channel
 
+	/**
+	 * Decode size bytes of IMA ADPCM data of one channel, two samples per
+	 * byte, storing the samples stride samples apart in output.
+	 */
+	void decodeIMABlock(const byte *data, uint32 size, int16 *output, int stride, int channel, bool lowNibbleFirst);
+
+	/**
+	 * Decode size bytes of stereo IMA ADPCM data with one sample per
+	 * channel in each byte, the left one in the upper nibble.
+	 */
+	void decodeIMAStereoBlock(const byte *data, uint32 size, int16 *output);
+
 public:
 	Ima_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {}
@@ -125,26 +175,19 @@ private:
 
 class Apple_ADPCMStream : public Ima_ADPCMStream {
 protected:
-	// Apple QuickTime IMA ADPCM
-	int32 _streamPos[2];
-	int16 _buffer[2][2];
-	uint8 _chunkPos[2];
-
-	void reset() {
-		Ima_ADPCMStream::reset();
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
-		_streamPos[0] = 0;
-		_streamPos[1] = _blockAlign;
-	}
+	// Apple QuickTime IMA ADPCM. The blocks of the channels alternate, so
+	// one block of each channel is decoded at a time.
+	int decodeBlock(const byte *data, uint32 size, int16 *output);
 
 public:
 	Apple_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
-		_streamPos[0] = 0;
-		_streamPos[1] = _blockAlign;
+
+		if (blockAlign <= 2)
+			error("Apple_ADPCMStream(): invalid blockAlign");
+
+		// 2 byte header per block
+		allocateBlock(_blockAlign * _channels, (_blockAlign - 2) * 2 * _channels);
 	}
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
@@ -162,21 +205,14 @@ public:
 		if (blockAlign % (_channels * 4))
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		// 4 byte header per channel
+		allocateBlock(_blockAlign, (_blockAlign - _channels * 4) * 2);
 	}
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
-	void reset() {
-		Ima_ADPCMStream::reset();
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
-	}
-
-private:
-	int16 _buffer[2][8];
-	int _samplesLeft[2];
+protected:
+	int decodeBlock(const byte *data, uint32 size, int16 *output);
 };
 
 class MS_ADPCMStream : public ADPCMStream {
@@ -205,20 +241,21 @@ public:
 		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {
 		if (blockAlign == 0)
 			error("MS_ADPCMStream(): blockAlign isn't specified for MS ADPCM");
+
+		if (blockAlign < (uint32)_channels * 7)
+			error("MS_ADPCMStream(): invalid blockAlign");
+
 		memset(&_status, 0, sizeof(_status));
-		_decodedSampleCount = 0;
-	}
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+		// 7 byte header per channel, which holds two samples
+		allocateBlock(_blockAlign, _channels * 2 + (_blockAlign - _channels * 7) * 2);
+	}
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
-
-private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[4];
+	int decodeBlock(const byte *data, uint32 size, int16 *output);
 };
 
 // Duck DK3 IMA ADPCM Decoder
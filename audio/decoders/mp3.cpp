@@ -24,7 +24,9 @@
 
 #ifdef USE_MAD
 
+#include "common/array.h"
 #include "common/debug.h"
+#include "common/endian.h"
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
@@ -59,7 +61,6 @@ protected:
 	State _state;
 
 	Timestamp _length;
-	mad_timer_t _totalTime;
 
 	mad_stream _stream;
 	mad_frame _frame;
@@ -72,6 +73,25 @@ protected:
 	// This buffer contains a slab of input data
 	byte _buf[BUFFER_SIZE + MAD_BUFFER_GUARD];
 
+	// Offset of _buf in _inStream
+	uint32 _bufOffset;
+
+	/**
+	 * The frames are indexed lazily, whenever a seek goes beyond the
+	 * indexed part of the stream. When the stream has no Xing/VBRI header
+	 * to get its length from, the whole stream is indexed on creation.
+	 */
+	struct FrameIndexEntry {
+		uint32 offset;	///< offset of the frame in _inStream
+		uint32 sample;	///< first sample of the frame
+	};
+
+	Common::Array<FrameIndexEntry> _frameIndex;
+	uint32 _indexedSamples;		///< end of the last indexed frame, in samples
+	uint32 _indexScanOffset;	///< offset of the data following the last indexed frame
+	bool _indexComplete;		///< whether the whole stream has been indexed
+	bool _indexError;			///< whether indexing stopped on an unrecoverable error
+
 public:
 	MP3Stream(Common::SeekableReadStream *inStream,
 	               DisposeAfterUse::Flag dispose);
@@ -89,9 +109,12 @@ protected:
 	void decodeMP3Data();
 	void readMP3Data();
 
-	void initStream();
-	void readHeader();
+	void initStream(uint32 offset = 0);
 	void deinitStream();
+
+	uint32 getFrameOffset() const { return _bufOffset + (_stream.this_frame - _buf); }
+	uint32 readFrameCount() const;
+	void indexFrames(uint32 untilSample);
 };
 
 MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag dispose) :
@@ -99,42 +122,139 @@ MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag
 	_posInFrame(0),
 	_state(MP3_STATE_INIT),
 	_length(0, 1000),
-	_totalTime(mad_timer_zero) {
+	_bufOffset(0),
+	_indexedSamples(0),
+	_indexScanOffset(0),
+	_indexComplete(false),
+	_indexError(false) {
 
 	// The MAD_BUFFER_GUARD must always contain zeros (the reason
 	// for this is that the Layer III Huffman decoder of libMAD
 	// may read a few bytes beyond the end of the input buffer).
 	memset(_buf + BUFFER_SIZE, 0, MAD_BUFFER_GUARD);
 
-	// Calculate the length of the stream
-	initStream();
-
-	while (_state != MP3_STATE_EOS)
-		readHeader();
+	// Decode the first chunk of data. This is necessary so that _frame
+	// is setup and isStereo() and getRate() return correct results.
+	decodeMP3Data();
 
 	// To rule out any invalid sample rate to be encountered here, say in case the
 	// MP3 stream is invalid, we just check the MAD error code here.
 	// We need to assure this, since else we might trigger an assertion in Timestamp
 	// (When getRate() returns 0 or a negative number to be precise).
-	// Note that we allow "MAD_ERROR_BUFLEN" as error code here, since according
-	// to mad.h it is also set on EOF.
-	if ((_stream.error == MAD_ERROR_NONE || _stream.error == MAD_ERROR_BUFLEN) && getRate() > 0)
-		_length = Timestamp(mad_timer_count(_totalTime, MAD_UNITS_MILLISECONDS), getRate());
-
-	deinitStream();
+	if (_state == MP3_STATE_EOS || getRate() <= 0)
+		return;
 
-	// Reinit stream
-	_state = MP3_STATE_INIT;
+	// Calculate the length of the stream. Files written by most encoders
+	// carry the number of frames in a Xing/Info or VBRI header, otherwise
+	// every frame header has to be looked at.
+	uint32 frameCount = readFrameCount();
+	if (frameCount) {
+		// The header frame is not included in the count, but it decodes
+		// to a frame of silence
+		_length = Timestamp(0, (frameCount + 1) * 32 * MAD_NSBSAMPLES(&_frame.header), getRate());
+	} else {
+		indexFrames(0xFFFFFFFF);
 
-	// Decode the first chunk of data. This is necessary so that _frame
-	// is setup and isStereo() and getRate() return correct results.
-	decodeMP3Data();
+		if (!_indexError)
+			_length = Timestamp(0, _indexedSamples, getRate());
+	}
 }
 
 MP3Stream::~MP3Stream() {
 	deinitStream();
 }
 
+uint32 MP3Stream::readFrameCount() const {
+	const byte *frame = _stream.this_frame;
+	const uint32 size = _stream.bufend - frame;
+
+	// The Xing header follows the side information
+	uint32 xingOffset;
+	if (_frame.header.flags & MAD_FLAG_LSF_EXT)
+		xingOffset = (MAD_NCHANNELS(&_frame.header) == 2) ? 4 + 17 : 4 + 9;
+	else
+		xingOffset = (MAD_NCHANNELS(&_frame.header) == 2) ? 4 + 32 : 4 + 17;
+
+	if (size >= xingOffset + 12 && (!memcmp(frame + xingOffset, "Xing", 4) || !memcmp(frame + xingOffset, "Info", 4))) {
+		// The frame count is only present when flag 1 is set
+		if (READ_BE_UINT32(frame + xingOffset + 4) & 1)
+			return READ_BE_UINT32(frame + xingOffset + 8);
+		return 0;
+	}
+
+	// The VBRI header is always found 32 bytes after the frame header
+	if (size >= 4 + 32 + 18 && !memcmp(frame + 4 + 32, "VBRI", 4))
+		return READ_BE_UINT32(frame + 4 + 32 + 14);
+
+	return 0;
+}
+
+void MP3Stream::indexFrames(uint32 untilSample) {
+	if (_indexComplete || _indexedSamples > untilSample)
+		return;
+
+	// Headers are read with a separate MAD stream and buffer, so the state
+	// of the decoder is not disturbed
+	const int32 pos = _inStream->pos();
+	_inStream->seek(_indexScanOffset, SEEK_SET);
+
+	byte *buf = new byte[BUFFER_SIZE + MAD_BUFFER_GUARD];
+	memset(buf + BUFFER_SIZE, 0, MAD_BUFFER_GUARD);
+	uint32 bufOffset = _indexScanOffset;
+
+	mad_stream stream;
+	mad_header header;
+	mad_stream_init(&stream);
+	mad_header_init(&header);
+	stream.error = MAD_ERROR_BUFLEN;
+
+	while (_indexedSamples <= untilSample) {
+		if (stream.error == MAD_ERROR_BUFLEN) {
+			// Load more data, preserving what is left in the buffer
+			uint32 remaining = 0;
+			if (stream.next_frame) {
+				remaining = stream.bufend - stream.next_frame;
+				memmove(buf, stream.next_frame, remaining);
+			}
+
+			bufOffset = _inStream->pos() - remaining;
+			uint32 size = _inStream->eos() ? 0 : _inStream->read(buf + remaining, BUFFER_SIZE - remaining);
+			if (size == 0) {
+				_indexComplete = true;
+				break;
+			}
+
+			mad_stream_buffer(&stream, buf, size + remaining);
+		}
+
+		stream.error = MAD_ERROR_NONE;
+
+		if (mad_header_decode(&header, &stream) == -1) {
+			if (stream.error == MAD_ERROR_BUFLEN || MAD_RECOVERABLE(stream.error)) {
+				continue;
+			} else {
+				warning("MP3Stream: Unrecoverable error in mad_header_decode (%s)", mad_stream_errorstr(&stream));
+				_indexComplete = _indexError = true;
+				break;
+			}
+		}
+
+		FrameIndexEntry entry;
+		entry.offset = bufOffset + (stream.this_frame - buf);
+		entry.sample = _indexedSamples;
+		_frameIndex.push_back(entry);
+
+		_indexedSamples += 32 * MAD_NSBSAMPLES(&header);
+		_indexScanOffset = bufOffset + (stream.next_frame - buf);
+	}
+
+	mad_header_finish(&header);
+	mad_stream_finish(&stream);
+	delete[] buf;
+
+	_inStream->seek(pos, SEEK_SET);
+}
+
 void MP3Stream::decodeMP3Data() {
 	do {
 		if (_state == MP3_STATE_INIT)
@@ -195,6 +315,8 @@ void MP3Stream::readMP3Data() {
 		memmove(_buf, _stream.next_frame, remaining);
 	}
 
+	_bufOffset = _inStream->pos() - remaining;
+
 	// Try to read the next block
 	uint32 size = _inStream->read(_buf + remaining, BUFFER_SIZE - remaining);
 	if (size <= 0) {
@@ -215,23 +337,58 @@ bool MP3Stream::seek(const Timestamp &where) {
 		return false;
 	}
 
-	const uint32 time = where.msecs();
+	const uint32 sample = where.convertToFramerate(getRate()).totalNumberOfFrames();
 
-	mad_timer_t destination;
-	mad_timer_set(&destination, time / 1000, time % 1000, 1000);
+	indexFrames(sample);
 
-	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _totalTime) < 0)
-		initStream();
+	// The index only ends before the sample if all frames have been indexed,
+	// so this is the end of the stream, which is still a valid position
+	if (sample > _indexedSamples) {
+		_state = MP3_STATE_EOS;
+		return false;
+	} else if (sample == _indexedSamples) {
+		_state = MP3_STATE_EOS;
+		return true;
+	}
 
-	while (mad_timer_compare(destination, _totalTime) > 0 && _state != MP3_STATE_EOS)
-		readHeader();
+	// Find the frame containing the sample
+	uint lo = 0, hi = _frameIndex.size() - 1;
+	while (lo < hi) {
+		uint mid = (lo + hi + 1) / 2;
+		if (_frameIndex[mid].sample <= sample)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
 
-	decodeMP3Data();
+	// The output of a frame depends on the two frames before it, through
+	// the overlap of the IMDCT and the synthesis filter. Those two have to
+	// decode correctly, and Layer III frames may take up to 511 bytes of
+	// their data from the frames before them (the bit reservoir). So go back
+	// until there is enough data in front of them. Only the header, CRC and
+	// side information are left out of a frame, at their largest size.
+	const FrameIndexEntry &target = _frameIndex[lo];
+	uint start = lo > 2 ? lo - 2 : 0;
+	uint32 reservoir = 0;
+	while (start > 0 && reservoir < 511) {
+		start--;
+		const uint32 frameSize = _frameIndex[start + 1].offset - _frameIndex[start].offset;
+		reservoir += frameSize > 38 ? frameSize - 38 : 0;
+	}
+
+	initStream(_frameIndex[start].offset);
+
+	do {
+		decodeMP3Data();
+	} while (_state != MP3_STATE_EOS && getFrameOffset() < target.offset);
+
+	if (_state != MP3_STATE_EOS && getFrameOffset() == target.offset)
+		_posInFrame = MIN<uint>(sample - target.sample, _synth.pcm.length);
 
 	return (_state != MP3_STATE_EOS);
 }
 
-void MP3Stream::initStream() {
+void MP3Stream::initStream(uint32 offset) {
 	if (_state != MP3_STATE_INIT)
 		deinitStream();
 
@@ -241,8 +398,7 @@ void MP3Stream::initStream() {
 	mad_synth_init(&_synth);
 
 	// Reset the stream data
-	_inStream->seek(0, SEEK_SET);
-	_totalTime = mad_timer_zero;
+	_inStream->seek(offset, SEEK_SET);
 	_posInFrame = 0;
 
 	// Update state
@@ -252,42 +408,6 @@ void MP3Stream::initStream() {
 	readMP3Data();
 }
 
-void MP3Stream::readHeader() {
-	if (_state != MP3_STATE_READY)
-		return;
-
-	// If necessary, load more data into the stream decoder
-	if (_stream.error == MAD_ERROR_BUFLEN)
-		readMP3Data();
-
-	while (_state != MP3_STATE_EOS) {
-		_stream.error = MAD_ERROR_NONE;
-
-		// Decode the next header. Note: mad_frame_decode would do this for us, too.
-		// However, for seeking we don't want to decode the full frame (else it would
-		// be far too slow). Hence we perform this explicitly in a separate step.
-		if (mad_header_decode(&_frame.header, &_stream) == -1) {
-			if (_stream.error == MAD_ERROR_BUFLEN) {
-				readMP3Data();  // Read more data
-				continue;
-			} else if (MAD_RECOVERABLE(_stream.error)) {
-				debug(6, "MP3Stream: Recoverable error in mad_header_decode (%s)", mad_stream_errorstr(&_stream));
-				continue;
-			} else {
-				warning("MP3Stream: Unrecoverable error in mad_header_decode (%s)", mad_stream_errorstr(&_stream));
-				break;
-			}
-		}
-
-		// Sum up the total playback time so far
-		mad_timer_add(&_totalTime, _frame.header.duration);
-		break;
-	}
-
-	if (_stream.error != MAD_ERROR_NONE)
-		_state = MP3_STATE_EOS;
-}
-
 void MP3Stream::deinitStream() {
 	if (_state == MP3_STATE_INIT)
 		return;
@@ -44,7 +44,9 @@ _centerPitchWheelOnUnload(false),
 _sendSustainOffOnNotesOff(false),
 _numTracks(0),
 _activeTrack(255),
-_abortParse(0) {
+_abortParse(0),
+_useTimeline(false),
+_timelineTrack(0) {
 	memset(_activeNotes, 0, sizeof(_activeNotes));
 	memset(_tracks, 0, sizeof(_tracks));
 	_nextEvent.start = NULL;
@@ -218,7 +220,7 @@ void MidiParser::onTimer() {
 				// as well as sending it to the output device.
 				if (_autoLoop) {
 					jumpToTick(0);
-					parseNextEvent(_nextEvent);
+					fetchNextEvent(_nextEvent);
 				} else {
 					stopPlaying();
 					_driver->metaEvent(info.ext.type, info.ext.data, (uint16)info.length);
@@ -245,7 +247,7 @@ void MidiParser::onTimer() {
 
 		if (!_abortParse) {
 			_position._lastEventTime = eventTime;
-			parseNextEvent(_nextEvent);
+			fetchNextEvent(_nextEvent);
 		}
 	}
 
@@ -321,7 +323,80 @@ bool MidiParser::setTrack(int track) {
 	memset(_activeNotes, 0, sizeof(_activeNotes));
 	_activeTrack = track;
 	_position._playPos = _tracks[track];
-	parseNextEvent(_nextEvent);
+	if (_useTimeline && _timelineTrack != _tracks[track])
+		buildTimeline();
+	fetchNextEvent(_nextEvent);
+	return true;
+}
+
+void MidiParser::buildTimeline() {
+	_timeline.clear();
+	_timelineTicks.clear();
+	_timelineTempos.clear();
+	_timelineTrack = _position._playPos;
+
+	// Decode the whole track once, so that neither onTimer() nor jumping
+	// have to parse the raw track data again
+	Tracker startPos(_position);
+	EventInfo info;
+	uint32 tick = 0;
+
+	do {
+		parseNextEvent(info);
+		if (!isTimelineEvent(info)) {
+			_timeline.clear();
+			_timelineTicks.clear();
+			_timelineTempos.clear();
+			break;
+		}
+
+		tick += info.delta;
+		if (info.event == 0xFF && info.ext.type == 0x51 && info.length >= 3)
+			_timelineTempos.push_back(_timeline.size());
+
+		_timeline.push_back(info);
+		_timelineTicks.push_back(tick);
+	} while (info.event >= 0x80 && !(info.event == 0xFF && info.ext.type == 0x2F));
+
+	_position = startPos;
+}
+
+bool MidiParser::jumpInTimeline(uint32 tick) {
+	// Find the first event at or after the target tick; all the events
+	// before it are skipped
+	uint first = 0, last = _timelineTicks.size();
+	while (first < last) {
+		const uint middle = (first + last) / 2;
+		if (_timelineTicks[middle] < tick)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	// Jumping past the End of Track fails
+	if (first >= _timeline.size())
+		return false;
+
+	// The time of an event depends on all the tempo changes before it, so
+	// walk through those. Events which are not fired have no other effect.
+	uint32 tempoTick = 0;
+	uint32 tempoTime = 0;
+	for (uint i = 0; i < _timelineTempos.size() && _timelineTempos[i] < first; ++i) {
+		const EventInfo &info = _timeline[_timelineTempos[i]];
+		const uint32 eventTick = _timelineTicks[_timelineTempos[i]];
+
+		tempoTime += (eventTick - tempoTick) * _psecPerTick;
+		tempoTick = eventTick;
+		setTempo(info.ext.data[0] << 16 | info.ext.data[1] << 8 | info.ext.data[2]);
+	}
+
+	_position._lastEventTick = first ? _timelineTicks[first - 1] : 0;
+	_position._lastEventTime = tempoTime + (_position._lastEventTick - tempoTick) * _psecPerTick;
+	_position._playTick = tick;
+	_position._playTime = _position._lastEventTime + (tick - _position._lastEventTick) * _psecPerTick;
+
+	_position._playEvent = first;
+	fetchNextEvent(_nextEvent);
 	return true;
 }
 
@@ -344,7 +419,7 @@ void MidiParser::hangAllActiveNotes() {
 				break;
 		if (i == 128)
 			break;
-		parseNextEvent(_nextEvent);
+		fetchNextEvent(_nextEvent);
 		advanceTick += _nextEvent.delta;
 		if (_nextEvent.command() == 0x8) {
 			if (tempActive[_nextEvent.basic.param1] & (1 << _nextEvent.channel())) {
@@ -375,8 +450,14 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 
 	resetTracking();
 	_position._playPos = _tracks[_activeTrack];
-	parseNextEvent(_nextEvent);
-	if (tick > 0) {
+	fetchNextEvent(_nextEvent);
+	if (tick > 0 && !fireEvents && !_timeline.empty()) {
+		if (!jumpInTimeline(tick)) {
+			_position = currentPos;
+			_nextEvent = currentEvent;
+			return false;
+		}
+	} else if (tick > 0) {
 		while (true) {
 			EventInfo &info = _nextEvent;
 			if (_position._lastEventTick + info.delta >= tick) {
@@ -420,7 +501,7 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 				}
 			}
 
-			parseNextEvent(_nextEvent);
+			fetchNextEvent(_nextEvent);
 		}
 	}
 
@@ -451,6 +532,11 @@ void MidiParser::unloadMusic() {
 	_activeTrack = 255;
 	_abortParse = true;
 
+	_timeline.clear();
+	_timelineTicks.clear();
+	_timelineTempos.clear();
+	_timelineTrack = 0;
+
 	if (_centerPitchWheelOnUnload) {
 		// Center the pitch wheels in preparation for the next piece of
 		// music. It's not safe to do this from within allNotesOff(),
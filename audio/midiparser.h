@@ -26,6 +26,7 @@
 #define AUDIO_MIDIPARSER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/endian.h"
 
 class MidiDriver_BASE;
@@ -50,6 +51,7 @@ class MidiDriver_BASE;
  */
 struct Tracker {
 	byte * _playPos;        ///< A pointer to the next event to be parsed
+	uint32 _playEvent;      ///< Index of the next event in the pre-decoded timeline, if there is one
 	uint32 _playTime;       ///< Current time in microseconds; may be in between event times
 	uint32 _playTick;       ///< Current MIDI tick; may be in between event ticks
 	uint32 _lastEventTime; ///< The time, in microseconds, of the last event that was parsed
@@ -61,6 +63,7 @@ struct Tracker {
 	/// Copy constructor for each duplication of Tracker information.
 	Tracker(const Tracker &copy) :
 	_playPos(copy._playPos),
+	_playEvent(copy._playEvent),
 	_playTime(copy._playTime),
 	_playTick(copy._playTick),
 	_lastEventTime(copy._lastEventTime),
@@ -71,6 +74,7 @@ struct Tracker {
 	/// Clears all data; used by the constructor for initialization.
 	void clear() {
 		_playPos = 0;
+		_playEvent = 0;
 		_playTime = 0;
 		_playTick = 0;
 		_lastEventTime = 0;
@@ -288,12 +292,46 @@ protected:
 	                        ///< simulated events in certain formats.
 	bool   _abortParse;    ///< If a jump or other operation interrupts parsing, flag to abort.
 
+	bool   _useTimeline;   ///< Pre-decode the active track into _timeline. Only for formats
+	                        ///< whose parseNextEvent has no side effects.
+	byte  *_timelineTrack; ///< The track data _timeline was built from.
+	Common::Array<EventInfo> _timeline;   ///< All events of the active track, in order. Empty if
+	                                       ///< the track is parsed while playing.
+	Common::Array<uint32> _timelineTicks;  ///< The absolute tick of each event in _timeline.
+	Common::Array<uint32> _timelineTempos; ///< Indices of the tempo events in _timeline.
+
 protected:
 	static uint32 readVLQ(byte * &data);
 	virtual void resetTracking();
 	virtual void allNotesOff();
 	virtual void parseNextEvent(EventInfo &info) = 0;
 
+	/**
+	 * Whether an event may be pre-decoded into the timeline. Formats with
+	 * events which act while being parsed (e.g. loops) return false for
+	 * those, and tracks containing them are parsed while playing instead.
+	 */
+	virtual bool isTimelineEvent(const EventInfo &info) const { return true; }
+
+	virtual void buildTimeline();
+	bool jumpInTimeline(uint32 tick);
+
+	/**
+	 * Get the next event of the active track, from the timeline if there
+	 * is one, otherwise by parsing it.
+	 */
+	void fetchNextEvent(EventInfo &info) {
+		if (_timeline.empty()) {
+			parseNextEvent(info);
+			return;
+		}
+
+		info = _timeline[_position._playEvent];
+		// Past the End of Track event there is nothing left to decode
+		if (_position._playEvent + 1 < _timeline.size())
+			++_position._playEvent;
+	}
+
 	void activeNote(byte channel, byte note, bool active);
 	void hangingNote(byte channel, byte note, uint32 ticksLeft, bool recycle = true);
 	void hangAllActiveNotes();
@@ -52,14 +52,45 @@ protected:
 		_loopCount = -1;
 	}
 
+	void buildTimeline();
+	bool isTimelineEvent(const EventInfo &info) const;
+
 public:
-	MidiParser_XMIDI(XMidiCallbackProc proc, void *data) : _callbackProc(proc), _callbackData(data), _loopCount(-1) {}
+	MidiParser_XMIDI(XMidiCallbackProc proc, void *data) : _callbackProc(proc), _callbackData(data), _loopCount(-1) {
+		_useTimeline = true;
+	}
 	~MidiParser_XMIDI() { }
 
 	bool loadMusic(byte *data, uint32 size);
 };
 
 
+void MidiParser_XMIDI::buildTimeline() {
+	// Loops and callbacks are handled while parsing, so they must not be
+	// triggered by pre-decoding. Tracks using them aren't pre-decoded.
+	XMidiCallbackProc callbackProc = _callbackProc;
+	const int loopCount = _loopCount;
+
+	_callbackProc = 0;
+	MidiParser::buildTimeline();
+	_callbackProc = callbackProc;
+	_loopCount = loopCount;
+}
+
+bool MidiParser_XMIDI::isTimelineEvent(const EventInfo &info) const {
+	if ((info.event & 0xF0) != 0xB0)
+		return true;
+
+	switch (info.basic.param1) {
+	case 0x74:	// XMIDI_CONTROLLER_FOR_LOOP
+	case 0x75:	// XMIDI_CONTORLLER_NEXT_BREAK
+	case 0x77:	// XMIDI_CONTROLLER_CALLBACK_TRIG
+		return false;
+	default:
+		return true;
+	}
+}
+
 // This is a special XMIDI variable length quantity
 uint32 MidiParser_XMIDI::readVLQ2(byte * &pos) {
 	uint32 value = 0;
@@ -52,9 +52,11 @@ public:
 	 * @param len  number of sample *pairs*. So a value of
 	 *             10 means that the buffer contains twice 10 sample, each
 	 *             16 bits, for a total of 40 bytes.
+	 * @param decodeTime if not 0, the time spent decoding the stream is
+	 *             added to it, in milliseconds
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int16 *data, uint len, uint32 *decodeTime = 0);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -167,18 +169,228 @@ private:
 	Common::DisposablePtr<AudioStream> _stream;
 };
 
+#pragma mark -
+#pragma mark --- Output timing ---
+#pragma mark -
+
+void OutputTiming::reset(uint rate, uint bufferedFrames) {
+	_rate = rate;
+	_bufferedFrames = bufferedFrames;
+
+	_callbacks = 0;
+	_lateCallbacks = 0;
+	_firstTime = 0;
+	_lastTime = 0;
+	_lastFrames = 0;
+	_maxInterval = 0;
+	_maxJitter = 0;
+}
+
+void OutputTiming::addCallback(uint32 time, uint frames) {
+	if (_callbacks == 0) {
+		_firstTime = time;
+	} else if (_rate) {
+		// The device asks for more data once it has used up the data of the
+		// previous callback, so that is what the interval is compared with.
+		// Note that the timestamps only have a resolution of 1 ms.
+		const uint32 interval = (time - _lastTime) * 1000;
+		const uint32 period = getDuration(_lastFrames);
+		const uint32 jitter = (interval > period) ? interval - period : period - interval;
+
+		_maxInterval = MAX(_maxInterval, interval);
+		_maxJitter = MAX(_maxJitter, jitter);
+
+		// Allow for the resolution of the timestamps
+		if (_bufferedFrames && interval > getDuration(_bufferedFrames) + 1000)
+			_lateCallbacks++;
+	}
+
+	_lastTime = time;
+	_lastFrames = frames;
+	_callbacks++;
+}
+
+uint OutputTiming::getLatency() const {
+	if (!_rate)
+		return 0;
+
+	return (_bufferedFrames * 1000 + _rate / 2) / _rate;
+}
+
+uint32 OutputTiming::getDuration(uint frames) const {
+	if (!_rate)
+		return 0;
+
+	return (uint32)((uint64)frames * 1000000 / _rate);
+}
+
+uint32 OutputTiming::getAveragePeriod() const {
+	if (_callbacks < 2)
+		return 0;
+
+	return (_lastTime - _firstTime) * 1000 / (_callbacks - 1);
+}
+
+bool OutputTiming::isStable() const {
+	if (_callbacks < 2 || !_rate)
+		return false;
+
+	// Allow for the resolution of the timestamps
+	return _maxInterval <= getDuration(_bufferedFrames) + 1000;
+}
+
+#pragma mark -
+#pragma mark --- Profiling ---
+#pragma mark -
+
+/**
+ * Passes the samples of a channel's stream through to the rate converter,
+ * measuring the time spent decoding them.
+ */
+class ProfilingAudioStream : public AudioStream {
+public:
+	ProfilingAudioStream(AudioStream &stream) : _stream(stream), _decodeTime(0) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const uint32 start = g_system->getUnrecordedMillis();
+		const int samples = _stream.readBuffer(buffer, numSamples);
+		_decodeTime += g_system->getUnrecordedMillis() - start;
+		return samples;
+	}
+
+	bool isStereo() const { return _stream.isStereo(); }
+	int getRate() const { return _stream.getRate(); }
+	bool endOfData() const { return _stream.endOfData(); }
+	bool endOfStream() const { return _stream.endOfStream(); }
+
+	uint32 getDecodeTime() const { return _decodeTime; }
+
+private:
+	AudioStream &_stream;
+	uint32 _decodeTime;
+};
+
+void MixerProfile::reset() {
+	_firstCallback = _timing.getCallbackCount();
+	_firstLateCallback = _timing.getLateCallbackCount();
+
+	_callbackTime = 0;
+	_maxCallbackTime = 0;
+	_slowCallbacks = 0;
+	memset(_histogram, 0, sizeof(_histogram));
+	memset(_types, 0, sizeof(_types));
+
+	for (uint i = 0; i < _channels.size(); ++i) {
+		(Stats &)_channels[i] = Stats();
+		_channels[i].used = false;
+		_channels[i].type = Mixer::kPlainSoundType;
+		_channels[i].id = -1;
+	}
+}
+
+void MixerProfile::setChannel(uint slot, Mixer::SoundType type, int id) {
+	assert(slot < _channels.size());
+
+	ChannelStats &stats = _channels[slot];
+	(Stats &)stats = Stats();
+	stats.used = true;
+	stats.type = type;
+	stats.id = id;
+}
+
+void MixerProfile::addChannelMix(uint slot, uint frames, uint32 decodeTime, uint32 mixTime) {
+	assert(slot < _channels.size());
+
+	// The two clock readings around the decoding may differ from the ones
+	// around the whole mixing by a millisecond
+	const uint32 convertTime = (mixTime > decodeTime) ? mixTime - decodeTime : 0;
+
+	Stats *const stats[2] = { &_channels[slot], &_types[_channels[slot].type] };
+	for (int i = 0; i < 2; ++i) {
+		stats[i]->mixCount++;
+		stats[i]->frames += frames;
+		stats[i]->decodeTime += decodeTime;
+		stats[i]->convertTime += convertTime;
+	}
+}
+
+void MixerProfile::addCallback(uint32 duration, uint frames) {
+	uint bucket = 0;
+	while (bucket < kHistogramBuckets - 1 && duration >= (1U << bucket))
+		++bucket;
+	_histogram[bucket]++;
+
+	// Compare in microseconds to not lose the fractional milliseconds
+	// of the periods
+	const uint32 period = _timing.getDuration(frames);
+	if (period && duration * 1000 > period)
+		_slowCallbacks++;
+
+	_callbackTime += duration;
+	_maxCallbackTime = MAX(_maxCallbackTime, duration);
+}
+
+static Common::String formatStats(const MixerProfile::Stats &stats) {
+	return Common::String::format("%8u %9u %7u %8u",
+	                              stats.mixCount, stats.frames, stats.decodeTime, stats.convertTime);
+}
+
+Common::String MixerProfile::getReport() const {
+	static const char *const typeNames[kMaxSoundTypes] = { "plain", "music", "sfx", "speech" };
+
+	Common::String report = Common::String::format("%u callbacks, %u ms in total, %u ms at most, %u too slow, %u late\n",
+	                                               getCallbackCount(), _callbackTime, _maxCallbackTime,
+	                                               _slowCallbacks, getLateCallbackCount());
+
+	report += "Callback duration:";
+	for (uint i = 0; i < kHistogramBuckets; ++i) {
+		if (i == 0)
+			report += Common::String::format(" 0 ms: %u", _histogram[i]);
+		else if (i == 1)
+			report += Common::String::format(", 1 ms: %u", _histogram[i]);
+		else if (i == kHistogramBuckets - 1)
+			report += Common::String::format(", %u+ ms: %u", 1U << (i - 1), _histogram[i]);
+		else
+			report += Common::String::format(", %u-%u ms: %u", 1U << (i - 1), (1U << i) - 1, _histogram[i]);
+	}
+	report += "\n";
+
+	report += "Slot Type   Id      Mixes    Frames  Decode  Convert\n";
+	for (uint i = 0; i < _channels.size(); ++i) {
+		const ChannelStats &stats = _channels[i];
+		if (!stats.used)
+			continue;
+
+		report += Common::String::format("%4u %-6s %4d ", i, typeNames[stats.type], stats.id);
+		report += formatStats(stats) + "\n";
+	}
+
+	for (uint i = 0; i < kMaxSoundTypes; ++i) {
+		if (!_types[i].mixCount)
+			continue;
+
+		report += Common::String::format("all  %-6s      ", typeNames[i]);
+		report += formatStats(_types[i]) + "\n";
+	}
+
+	return report;
+}
+
 #pragma mark -
 #pragma mark --- Mixer ---
 #pragma mark -
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(), _profiling(false), _profile(NUM_CHANNELS, _timing) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
+
+	_timing.reset(sampleRate, 0);
+	_profile.reset();
 }
 
 MixerImpl::~MixerImpl() {
@@ -194,6 +406,39 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+uint MixerImpl::getOutputLatency() const {
+	return _timing.getLatency();
+}
+
+void MixerImpl::setOutputBufferSize(uint frames) {
+	Common::StackLock lock(_mutex);
+	_timing.reset(_sampleRate, frames);
+	_profile.reset();
+}
+
+OutputTiming MixerImpl::getOutputTiming() {
+	Common::StackLock lock(_mutex);
+	return _timing;
+}
+
+void MixerImpl::setProfiling(bool enable) {
+	Common::StackLock lock(_mutex);
+
+	if (enable) {
+		_profile.reset();
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_channels[i])
+				_profile.setChannel(i, _channels[i]->getType(), _channels[i]->getId());
+	}
+
+	_profiling = enable;
+}
+
+Common::String MixerImpl::getProfileReport() {
+	Common::StackLock lock(_mutex);
+	return _profile.getReport();
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -209,6 +454,8 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	}
 
 	_channels[index] = chan;
+	if (_profiling)
+		_profile.setChannel(index, chan->getType(), chan->getId());
 
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
@@ -277,6 +524,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	const uint32 callbackTime = g_system->getUnrecordedMillis();
+	_timing.addCallback(callbackTime, len);
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
@@ -288,13 +538,23 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 				delete _channels[i];
 				_channels[i] = 0;
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				if (_profiling) {
+					uint32 decodeTime = 0;
+					const uint32 start = g_system->getUnrecordedMillis();
+					tmp = _channels[i]->mix(buf, len, &decodeTime);
+					_profile.addChannelMix(i, len, decodeTime, g_system->getUnrecordedMillis() - start);
+				} else {
+					tmp = _channels[i]->mix(buf, len);
+				}
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+	if (_profiling)
+		_profile.addCallback(g_system->getUnrecordedMillis() - callbackTime, len);
+
 	return res;
 }
 
@@ -595,7 +855,7 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int16 *data, uint len, uint32 *decodeTime) {
 	assert(_stream);
 
 	int res = 0;
@@ -607,7 +867,13 @@ int Channel::mix(int16 *data, uint len) {
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis();
 		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		if (decodeTime) {
+			ProfilingAudioStream stream(*_stream);
+			res = _converter->flow(stream, data, len, _volL, _volR);
+			*decodeTime += stream.getDecodeTime();
+		} else {
+			res = _converter->flow(*_stream, data, len, _volL, _volR);
+		}
 		_samplesDecoded += res;
 	}
 
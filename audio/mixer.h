@@ -25,6 +25,7 @@
 
 #include "common/types.h"
 #include "common/noncopyable.h"
+#include "common/str.h"
 
 namespace Audio {
 
@@ -277,6 +278,32 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Query the latency of the audio output, i.e. how long it takes until
+	 * mixed audio can be heard. Engines can use this to keep subtitles,
+	 * lip-sync or video in step with what is audible.
+	 *
+	 * @return the output latency in milliseconds, 0 if unknown
+	 */
+	virtual uint getOutputLatency() const { return 0; }
+
+	/**
+	 * Enable or disable the collection of statistics about the cost of
+	 * mixing each channel. Enabling it starts a new measurement. This is
+	 * meant for debugging, as the measuring itself takes some time.
+	 * Mixers which cannot profile ignore this.
+	 */
+	virtual void setProfiling(bool enable) {}
+
+	/** Check whether statistics about the mixing are collected. */
+	virtual bool isProfiling() const { return false; }
+
+	/**
+	 * Return a human readable summary of the statistics collected since
+	 * profiling was enabled.
+	 */
+	virtual Common::String getProfileReport() { return Common::String(); }
 };
 
 
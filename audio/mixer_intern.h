@@ -24,11 +24,188 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
+#include "common/str.h"
 #include "audio/mixer.h"
 
 namespace Audio {
 
+/**
+ * Statistics about the audio callbacks of a backend.
+ *
+ * Backends tell how many sample frames are buffered between the mixer and
+ * the speaker, from which the output latency is derived. Every callback is
+ * timestamped, which shows how regular the callbacks are, i.e. whether the
+ * device could be starved when running with the current period size.
+ */
+class OutputTiming {
+public:
+	OutputTiming() { reset(0, 0); }
+
+	/**
+	 * Start a new measurement.
+	 *
+	 * @param rate           the output sample rate in Hz
+	 * @param bufferedFrames the number of sample frames buffered between
+	 *                       the mixer and the speaker
+	 */
+	void reset(uint rate, uint bufferedFrames);
+
+	/**
+	 * Record an audio callback.
+	 *
+	 * @param time   the time of the callback in milliseconds
+	 * @param frames the number of sample frames requested
+	 */
+	void addCallback(uint32 time, uint frames);
+
+	/** Return the output latency in milliseconds. */
+	uint getLatency() const;
+
+	/** Return the number of sample frames buffered after the mixer. */
+	uint getBufferedFrames() const { return _bufferedFrames; }
+
+	/** Return the average time between two callbacks in microseconds. */
+	uint32 getAveragePeriod() const;
+
+	/** Return the largest difference between a callback interval and the nominal period, in microseconds. */
+	uint32 getMaxJitter() const { return _maxJitter; }
+
+	/** Return the number of callbacks recorded since the last reset. */
+	uint32 getCallbackCount() const { return _callbacks; }
+
+	/**
+	 * Return the number of callbacks which arrived later than the buffered
+	 * audio lasted, i.e. after the output had run dry. Only counted when
+	 * the number of buffered frames is known.
+	 */
+	uint32 getLateCallbackCount() const { return _lateCallbacks; }
+
+	/** Return how long the given number of sample frames last, in microseconds. */
+	uint32 getDuration(uint frames) const;
+
+	/**
+	 * Check whether the callbacks have been regular enough: none of them
+	 * arrived later than the buffered audio would have lasted.
+	 */
+	bool isStable() const;
+
+private:
+	uint _rate;
+	uint _bufferedFrames;
+
+	uint32 _callbacks;
+	uint32 _lateCallbacks;
+	uint32 _firstTime;
+	uint32 _lastTime;
+	uint _lastFrames;
+	uint32 _maxInterval;
+	uint32 _maxJitter;
+};
+
+/**
+ * Statistics about the cost of mixing, for tracking down audio glitches.
+ *
+ * For every mixer slot the time spent decoding (i.e. in the readBuffer()
+ * method of the stream) and converting (in RateConverter::flow(), minus the
+ * decoding) is accumulated, along with a histogram of the duration of the
+ * whole mixer callback and a count of underruns. The callbacks themselves,
+ * and whether they arrived in time, are tracked by the OutputTiming of the
+ * mixer; the profile only reports what happened since its last reset.
+ *
+ * All times are measured with OSystem::getUnrecordedMillis(). Single
+ * measurements are thus very coarse, but as the callbacks are not in step
+ * with the clock, the sums over many callbacks are still accurate.
+ */
+class MixerProfile {
+public:
+	enum {
+		kMaxSoundTypes = 4,
+
+		/**
+		 * The callback durations are sorted into power of two buckets:
+		 * 0 ms, 1 ms, 2-3 ms, 4-7 ms and so on, up to 64 ms and more.
+		 */
+		kHistogramBuckets = 8
+	};
+
+	struct Stats {
+		uint32 mixCount;
+		uint32 frames;
+		uint32 decodeTime;
+		uint32 convertTime;
+	};
+
+	struct ChannelStats : Stats {
+		bool used;
+		Mixer::SoundType type;
+		int id;
+	};
+
+	/**
+	 * @param numChannels the number of mixer slots to keep statistics for
+	 * @param timing      the timing of the output the callbacks are made for
+	 */
+	MixerProfile(uint numChannels, const OutputTiming &timing) : _timing(timing) { _channels.resize(numChannels); reset(); }
+
+	/**
+	 * Start a new measurement. Must also be called after the output timing
+	 * has been reset.
+	 */
+	void reset();
+
+	/** Record that a new channel now plays in the given mixer slot. */
+	void setChannel(uint slot, Mixer::SoundType type, int id);
+
+	/**
+	 * Record the mixing of a channel.
+	 *
+	 * @param slot       the mixer slot of the channel
+	 * @param frames     the number of sample frames mixed
+	 * @param decodeTime the time spent decoding in milliseconds
+	 * @param mixTime    the time spent mixing the channel in milliseconds,
+	 *                   including the decoding
+	 */
+	void addChannelMix(uint slot, uint frames, uint32 decodeTime, uint32 mixTime);
+
+	/**
+	 * Record the duration of a mixer callback, after it has been added to
+	 * the output timing. A callback which took longer than the audio it
+	 * produced lasts is counted as too slow.
+	 *
+	 * @param duration the duration of the callback in milliseconds
+	 * @param frames   the number of sample frames requested
+	 */
+	void addCallback(uint32 duration, uint frames);
+
+	uint32 getCallbackCount() const { return _timing.getCallbackCount() - _firstCallback; }
+	uint32 getCallbackTime() const { return _callbackTime; }
+	uint32 getMaxCallbackTime() const { return _maxCallbackTime; }
+	uint32 getHistogramCount(uint bucket) const { return _histogram[bucket]; }
+	uint32 getSlowCallbackCount() const { return _slowCallbacks; }
+	uint32 getLateCallbackCount() const { return _timing.getLateCallbackCount() - _firstLateCallback; }
+
+	const ChannelStats &getChannelStats(uint slot) const { return _channels[slot]; }
+	const Stats &getTypeStats(Mixer::SoundType type) const { return _types[type]; }
+
+	/** Return a human readable summary of the statistics. */
+	Common::String getReport() const;
+
+private:
+	const OutputTiming &_timing;
+	uint32 _firstCallback;
+	uint32 _firstLateCallback;
+
+	uint32 _callbackTime;
+	uint32 _maxCallbackTime;
+	uint32 _histogram[kHistogramBuckets];
+	uint32 _slowCallbacks;
+
+	Common::Array<ChannelStats> _channels;
+	Stats _types[kMaxSoundTypes];
+};
+
 /**
  * The (default) implementation of the ScummVM audio mixing subsystem.
  *
@@ -70,6 +247,10 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	OutputTiming _timing;
+
+	bool _profiling;
+	MixerProfile _profile;
 
 public:
 
@@ -117,6 +298,11 @@ public:
 	virtual int getVolumeForSoundType(SoundType type) const;
 
 	virtual uint getOutputRate() const;
+	virtual uint getOutputLatency() const;
+
+	virtual void setProfiling(bool enable);
+	virtual bool isProfiling() const { return _profiling; }
+	virtual Common::String getProfileReport();
 
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
@@ -139,6 +325,17 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Tell the mixer how many sample frames the backend and the audio
+	 * device buffer after mixCallback() returned, e.g. the size of the
+	 * device buffer plus any intermediate buffers. This is used to report
+	 * the output latency, and resets the callback statistics.
+	 */
+	void setOutputBufferSize(uint frames);
+
+	/** Return the statistics about the calls to mixCallback(). */
+	OutputTiming getOutputTiming();
 };
 
 
@@ -41,6 +41,7 @@ Paula::Paula(bool stereo, int rate, uint interruptFreq) :
 	_timerBase = 1;
 	_playing = false;
 	_end = true;
+	_bandLimited = false;
 }
 
 Paula::~Paula() {
@@ -57,6 +58,9 @@ void Paula::clearVoice(byte voice) {
 	_voice[voice].volume = 0;
 	_voice[voice].offset = Offset(0);
 	_voice[voice].dmaCount = 0;
+	_voice[voice].blepLevel = 0;
+	_voice[voice].blepCarry = 0;
+	_voice[voice].blepPhase = 0;
 }
 
 int Paula::readBuffer(int16 *buffer, const int numSamples) {
@@ -68,35 +72,112 @@ int Paula::readBuffer(int16 *buffer, const int numSamples) {
 	}
 
 	if (_stereo)
-		return readBufferIntern<true>(buffer, numSamples);
+		return _bandLimited ? readBufferIntern<true, true>(buffer, numSamples) : readBufferIntern<true, false>(buffer, numSamples);
 	else
-		return readBufferIntern<false>(buffer, numSamples);
+		return _bandLimited ? readBufferIntern<false, true>(buffer, numSamples) : readBufferIntern<false, false>(buffer, numSamples);
 }
 
+/**
+ * Compute how many output samples can be generated from the sample data
+ * before the offset runs past its end. This allows the mix loops below to
+ * run without checking the bounds for every single sample.
+ */
+inline int samplesUntilEnd(const Paula::Offset &offset, frac_t rate, uint bufSize, int neededSamples) {
+	if (offset.int_off >= bufSize)
+		return 0;
+
+	const uint64 remaining = ((uint64)(bufSize - offset.int_off) << FRAC_BITS) - offset.rem_off;
+	const uint64 samples = (remaining + rate - 1) / rate;
+	return (samples < (uint64)neededSamples) ? (int)samples : neededSamples;
+}
 
 template<bool stereo>
 inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning) {
-	int samples;
-	for (samples = 0; samples < neededSamples && offset.int_off < bufSize; ++samples) {
-		const int32 tmp = ((int32) data[offset.int_off]) * volume;
+	const int samples = samplesUntilEnd(offset, rate, bufSize, neededSamples);
+
+	// Scaling by the product of volume and panning gives exactly the
+	// same result as scaling by them one after the other.
+	const int32 volLeft = volume * (255 - panning);
+	const int32 volRight = volume * panning;
+
+	uint32 intOff = offset.int_off;
+	frac_t remOff = offset.rem_off;
+
+	for (int i = 0; i < samples; ++i) {
+		const int32 tmp = data[intOff];
+		if (stereo) {
+			*buf++ += (tmp * volLeft) >> 7;
+			*buf++ += (tmp * volRight) >> 7;
+		} else
+			*buf++ += tmp * volume;
+
+		// Step to next source sample
+		remOff += rate;
+		intOff += remOff >> FRAC_BITS;
+		remOff &= FRAC_LO_MASK;
+	}
+
+	offset.int_off = intOff;
+	offset.rem_off = remOff;
+
+	return samples;
+}
+
+/**
+ * Band-limited variant of mixBuffer(). Each change of the voice output is
+ * smoothed over two output samples with a second order polynomial BLEP. As
+ * the correction also applies to the sample before the step, the output of
+ * the voice is delayed by one sample.
+ */
+template<bool stereo>
+inline int mixBufferBandLimited(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning,
+                                int32 &level, int32 &carry, frac_t &phase) {
+	const int samples = samplesUntilEnd(offset, rate, bufSize, neededSamples);
+
+	uint32 intOff = offset.int_off;
+	frac_t remOff = offset.rem_off;
+
+	for (int i = 0; i < samples; ++i) {
+		const int32 cur = data[intOff] * volume;
+		const int32 step = cur - level;
+
+		int32 tmp = level + carry;
+		carry = 0;
+
+		if (step) {
+			// The step happened 'phase' output samples ago. Its residual is
+			// step / 2 * phase^2 before it and -step / 2 * (1 - phase)^2 after it.
+			const frac_t rest = FRAC_ONE - phase;
+			tmp += (((step * phase) >> FRAC_BITS) * phase) >> (FRAC_BITS + 1);
+			carry = -((((step * rest) >> FRAC_BITS) * rest) >> (FRAC_BITS + 1));
+			level = cur;
+		}
+
 		if (stereo) {
 			*buf++ += (tmp * (255 - panning)) >> 7;
 			*buf++ += (tmp * (panning)) >> 7;
 		} else
 			*buf++ += tmp;
 
-		// Step to next source sample
-		offset.rem_off += rate;
-		if (offset.rem_off >= (frac_t)FRAC_ONE) {
-			offset.int_off += fracToInt(offset.rem_off);
-			offset.rem_off &= FRAC_LO_MASK;
+		// Step to next source sample, and remember how long ago (in
+		// output samples) the source sample changed
+		remOff += rate;
+		if (remOff >= (frac_t)FRAC_ONE) {
+			intOff += remOff >> FRAC_BITS;
+			remOff &= FRAC_LO_MASK;
+			phase = (frac_t)(((uint32)remOff << FRAC_BITS) / (uint32)rate);
+		} else {
+			phase = 0;
 		}
 	}
 
+	offset.int_off = intOff;
+	offset.rem_off = remOff;
+
 	return samples;
 }
 
-template<bool stereo>
+template<bool stereo, bool bandLimited>
 int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 	int samples = _stereo ? numSamples / 2 : numSamples;
 	while (samples > 0) {
@@ -115,8 +196,11 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 		// Loop over the four channels of the emulated Paula chip
 		for (int voice = 0; voice < NUM_VOICES; voice++) {
 			// No data, or paused -> skip channel
-			if (!_voice[voice].data || (_voice[voice].period <= 0))
+			if (!_voice[voice].data || (_voice[voice].period <= 0)) {
+				_voice[voice].blepLevel = 0;
+				_voice[voice].blepCarry = 0;
 				continue;
+			}
 
 			// The Paula chip apparently run at 7.0937892 MHz in the PAL
 			// version and at 7.1590905 MHz in the NTSC version. We divide this
@@ -142,7 +226,10 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 			// by the OS/2 version of Hopkins FBI.
 
 			// Mix the generated samples into the output buffer
-			neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
+			if (bandLimited)
+				neededSamples -= mixBufferBandLimited<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning, ch.blepLevel, ch.blepCarry, ch.blepPhase);
+			else
+				neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
 
 			// Wrap around if necessary
 			if (ch.offset.int_off >= ch.length) {
@@ -164,7 +251,10 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 				// Repeat as long as necessary.
 				while (neededSamples > 0) {
 					// Mix the generated samples into the output buffer
-					neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
+					if (bandLimited)
+						neededSamples -= mixBufferBandLimited<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning, ch.blepLevel, ch.blepCarry, ch.blepPhase);
+					else
+						neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning);
 
 					if (ch.offset.int_off >= ch.length) {
 						// Wrap around. See also the note above.
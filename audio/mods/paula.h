@@ -74,6 +74,15 @@ public:
 	void stopPlay() { _playing = false; }
 	void pausePlay(bool pause) { _playing = !pause; }
 
+	/**
+	 * Enable band-limited output. Instead of jumping from one sample value
+	 * to the next, every step of a voice is smoothed with a polynomial BLEP,
+	 * which removes most of the aliasing of the plain sample-and-hold
+	 * output. This costs some speed and delays the output by one sample.
+	 */
+	void setBandLimited(bool enable) { Common::StackLock lock(_mutex); _bandLimited = enable; }
+	bool isBandLimited() const { return _bandLimited; }
+
 // AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
 	bool isStereo() const { return _stereo; }
@@ -91,6 +100,11 @@ protected:
 		Offset offset;
 		byte panning; // For stereo mixing: 0 = far left, 255 = far right
 		int dmaCount;
+
+		// State of the band-limited mixer
+		int32 blepLevel;	// last (volume scaled) sample value of the voice
+		int32 blepCarry;	// correction still to be applied to the next output sample
+		frac_t blepPhase;	// time since the last sample step, in output samples
 	};
 
 	bool _end;
@@ -197,8 +211,9 @@ private:
 	uint _curInt;
 	uint32 _timerBase;
 	bool _playing;
+	bool _bandLimited;
 
-	template<bool stereo>
+	template<bool stereo, bool bandLimited>
 	int readBufferIntern(int16 *buffer, const int numSamples);
 };
 
@@ -2,6 +2,8 @@ MODULE := audio
 
 MODULE_OBJS := \
 	audiostream.o \
+	decodeahead.o \
+	decodedcache.o \
 	fmopl.o \
 	mididrv.o \
 	midiparser_qt.o \
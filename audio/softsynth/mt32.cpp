@@ -36,10 +36,12 @@
 #include "common/error.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
 #include "common/util.h"
 #include "common/archive.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/translation.h"
 
 #include "graphics/fontman.h"
@@ -97,6 +99,28 @@ class MidiChannel_MT32 : public MidiChannel_MPU401 {
 	void chorusLevel(byte value) { }
 };
 
+/**
+ * A MIDI message queued for the render-ahead thread.
+ * A _msg of 0xFFFFFFFF indicates a sysex message.
+ */
+struct MidiEvent_MT32 {
+	MidiEvent_MT32 *_next;
+	uint32 _msg;
+	byte *_data;
+	uint32 _len;
+
+	MidiEvent_MT32(uint32 msg, const byte *data, uint32 len) : _next(0), _msg(msg), _data(0), _len(len) {
+		if (len > 0) {
+			_data = new byte[len];
+			memcpy(_data, data, len);
+		}
+	}
+
+	~MidiEvent_MT32() {
+		delete[] _data;
+	}
+};
+
 class MidiDriver_MT32 : public MidiDriver_Emulated {
 private:
 	MidiChannel_MT32 _midiChannels[16];
@@ -109,6 +133,33 @@ private:
 
 	int _outputRate;
 
+	enum {
+		kRenderAheadFrames = 4096,	// ~128ms at 32kHz
+		kRenderAheadInterval = 10000
+	};
+
+	// Render-ahead mode: the synth (and the player callback) run in a
+	// timer callback which keeps a ring buffer of output filled, so the
+	// mixer callback only has to copy already rendered samples.
+	bool _renderAhead;
+	int16 *_renderBuffer;
+	uint _renderReadPos, _renderWritePos, _renderFill;
+	uint _underruns;
+	Common::Mutex _renderBufferMutex;
+
+	MidiEvent_MT32 *_events, *_lastEvent;
+	Common::Mutex _eventMutex;
+
+	static MidiDriver_MT32 *_renderAheadDriver;
+	static void renderAheadTimerProc(void *refCon);
+	void renderAhead();
+	void startRenderAhead();
+	void stopRenderAhead();
+
+	void pushMidiEvent(MidiEvent_MT32 *event);
+	void playMidiEvents();
+	void playSysEx(const byte *msg, uint16 length);
+
 protected:
 	void generateSamples(int16 *buf, int len);
 
@@ -129,10 +180,13 @@ public:
 	MidiChannel *getPercussionChannel();
 
 	// AudioStream API
+	int readBuffer(int16 *data, const int numSamples);
 	bool isStereo() const { return true; }
 	int getRate() const { return _outputRate; }
 };
 
+MidiDriver_MT32 *MidiDriver_MT32::_renderAheadDriver = 0;
+
 ////////////////////////////////////////
 //
 // MidiDriver_MT32
@@ -158,6 +212,12 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_pcmROM = NULL;
 	_controlFile = NULL;
 	_pcmFile = NULL;
+
+	_renderAhead = false;
+	_renderBuffer = NULL;
+	_renderReadPos = _renderWritePos = _renderFill = 0;
+	_underruns = 0;
+	_events = _lastEvent = NULL;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -229,13 +289,19 @@ int MidiDriver_MT32::open() {
 
 	g_system->updateScreen();
 
+	if (ConfMan.getBool("mt32_render_ahead"))
+		startRenderAhead();
+
 	_mixer->playStream(Audio::Mixer::kSFXSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
 }
 
 void MidiDriver_MT32::send(uint32 b) {
-	_synth->playMsg(b);
+	if (_renderAhead)
+		pushMidiEvent(new MidiEvent_MT32(b, NULL, 0));
+	else
+		_synth->playMsg(b);
 }
 
 void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
@@ -256,6 +322,13 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
+	if (_renderAhead)
+		pushMidiEvent(new MidiEvent_MT32(0xFFFFFFFF, msg, length));
+	else
+		playSysEx(msg, length);
+}
+
+void MidiDriver_MT32::playSysEx(const byte *msg, uint16 length) {
 	if (msg[0] == 0xf0) {
 		_synth->playSysex(msg, length);
 	} else {
@@ -268,6 +341,9 @@ void MidiDriver_MT32::close() {
 		return;
 	_isOpen = false;
 
+	// Stop rendering ahead before anything else, the player callback
+	// is invoked from the render-ahead timer
+	stopRenderAhead();
 	// Detach the player callback handler
 	setTimerCallback(NULL, NULL);
 	// Detach the mixer callback handler
@@ -278,6 +354,11 @@ void MidiDriver_MT32::close() {
 }
 
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+	// Apply the messages queued since the last slice first. In render-ahead
+	// mode the player callback runs between the slices of readBuffer(), so
+	// its messages land on exactly the sample they did when rendering inline.
+	if (_renderAhead)
+		playMidiEvents();
 	_synth->render(data, len);
 }
 
@@ -310,119 +391,152 @@ MidiChannel *MidiDriver_MT32::getPercussionChannel() {
 	return &_midiChannels[9];
 }
 
-// This code should be used when calling the timer callback from the mixer thread is undesirable.
-// Note that it results in less accurate timing.
-#if 0
-class MidiEvent_MT32 {
-public:
-	MidiEvent_MT32 *_next;
-	uint32 _msg; // 0xFFFFFFFF indicates a sysex message
-	byte *_data;
-	uint32 _len;
+int MidiDriver_MT32::readBuffer(int16 *data, const int numSamples) {
+	if (!_renderAhead)
+		return MidiDriver_Emulated::readBuffer(data, numSamples);
 
-	MidiEvent_MT32(uint32 msg, byte *data, uint32 len) {
-		_msg = msg;
-		if (len > 0) {
-			_data = new byte[len];
-			memcpy(_data, data, len);
-		}
-		_len = len;
-		_next = NULL;
+	uint frames = numSamples / 2;
+	uint readPos, avail;
+	{
+		Common::StackLock lock(_renderBufferMutex);
+		readPos = _renderReadPos;
+		avail = MIN<uint>(frames, _renderFill);
 	}
 
-	MidiEvent_MT32() {
-		if (_len > 0)
-			delete _data;
+	// The render-ahead timer never writes to the part of the ring buffer
+	// between the read position and the fill level, so copy it unlocked.
+	uint copied = 0;
+	while (copied < avail) {
+		uint chunk = MIN<uint>(avail - copied, kRenderAheadFrames - readPos);
+		memcpy(data + copied * 2, _renderBuffer + readPos * 2, chunk * 2 * sizeof(int16));
+		readPos = (readPos + chunk) % kRenderAheadFrames;
+		copied += chunk;
 	}
-};
 
-class MidiDriver_ThreadedMT32 : public MidiDriver_MT32 {
-private:
-	OSystem::Mutex _eventMutex;
-	MidiEvent_MT32 *_events;
-	TimerManager::TimerProc _timer_proc;
+	{
+		Common::StackLock lock(_renderBufferMutex);
+		_renderReadPos = readPos;
+		_renderFill -= avail;
+	}
 
-	void pushMidiEvent(MidiEvent_MT32 *event);
-	MidiEvent_MT32 *popMidiEvent();
+	// The synth must not be run from here while the timer is using it, so
+	// an underrun results in silence.
+	if (avail < frames) {
+		memset(data + avail * 2, 0, (frames - avail) * 2 * sizeof(int16));
+		_underruns++;
+		debug(2, "MT32emu: Render-ahead underrun (%d frames missing, %d underruns)", frames - avail, _underruns);
+	}
 
-protected:
-	void send(uint32 b);
-	void sysEx(const byte *msg, uint16 length);
+	return numSamples;
+}
 
-public:
-	MidiDriver_ThreadedMT32(Audio::Mixer *mixer);
+void MidiDriver_MT32::startRenderAhead() {
+	// Only one timer callback per procedure can exist, so only a single
+	// driver can render ahead at a time.
+	if (_renderAheadDriver) {
+		warning("MT32emu: Render-ahead is already used by another driver, rendering inline");
+		return;
+	}
 
-	void onTimer();
-	void close();
-	void setTimerCallback(void *timer_param, TimerManager::TimerProc timer_proc);
-};
+	_renderBuffer = new int16[kRenderAheadFrames * 2];
+	_renderReadPos = _renderWritePos = _renderFill = 0;
+	_underruns = 0;
+	_renderAhead = true;
+	_renderAheadDriver = this;
 
+	// Prefill the buffer, so the mixer does not start with an underrun
+	renderAhead();
 
-MidiDriver_ThreadedMT32::MidiDriver_ThreadedMT32(Audio::Mixer *mixer) : MidiDriver_MT32(mixer) {
-	_events = NULL;
-	_timer_proc = NULL;
+	g_system->getTimerManager()->installTimerProc(renderAheadTimerProc, kRenderAheadInterval, this, "MT32renderAhead");
 }
 
-void MidiDriver_ThreadedMT32::close() {
-	MidiDriver_MT32::close();
-	while ((popMidiEvent() != NULL)) {
-		// Just eat any leftover events
-	}
-}
+void MidiDriver_MT32::stopRenderAhead() {
+	if (!_renderAhead)
+		return;
 
-void MidiDriver_ThreadedMT32::setTimerCallback(void *timer_param, TimerManager::TimerProc timer_proc) {
-	if (!_timer_proc || !timer_proc) {
-		if (_timer_proc)
-			_vm->_timer->removeTimerProc(_timer_proc);
-		_timer_proc = timer_proc;
-		if (timer_proc)
-			_vm->_timer->installTimerProc(timer_proc, getBaseTempo(), timer_param, "MT32tempo");
+	// This waits for a running callback to finish
+	g_system->getTimerManager()->removeTimerProc(renderAheadTimerProc);
+	_renderAheadDriver = NULL;
+
+	// Pause the stream while the ring buffer goes away
+	_mixer->pauseHandle(_mixerSoundHandle, true);
+	{
+		Common::StackLock lock(_renderBufferMutex);
+		_renderAhead = false;
+		_renderFill = 0;
 	}
-}
+	_mixer->pauseHandle(_mixerSoundHandle, false);
 
-void MidiDriver_ThreadedMT32::pushMidiEvent(MidiEvent_MT32 *event) {
+	delete[] _renderBuffer;
+	_renderBuffer = NULL;
+
+	// Anything still queued would be played after a reopen otherwise
 	Common::StackLock lock(_eventMutex);
-	if (_events == NULL) {
-		_events = event;
-	} else {
-		MidiEvent_MT32 *last = _events;
-		while (last->_next != NULL)
-			last = last->_next;
-		last->_next = event;
+	while (_events) {
+		MidiEvent_MT32 *event = _events;
+		_events = event->_next;
+		delete event;
 	}
+	_lastEvent = NULL;
 }
 
-MidiEvent_MT32 *MidiDriver_ThreadedMT32::popMidiEvent() {
-	Common::StackLock lock(_eventMutex);
-	MidiEvent_MT32 *event;
-	event = _events;
-	if (event != NULL)
-		_events = event->_next;
-	return event;
+void MidiDriver_MT32::renderAheadTimerProc(void *refCon) {
+	((MidiDriver_MT32 *)refCon)->renderAhead();
 }
 
-void MidiDriver_ThreadedMT32::send(uint32 b) {
-	MidiEvent_MT32 *event = new MidiEvent_MT32(b, NULL, 0);
-	pushMidiEvent(event);
+void MidiDriver_MT32::renderAhead() {
+	uint writePos, space;
+	{
+		Common::StackLock lock(_renderBufferMutex);
+		writePos = _renderWritePos;
+		space = kRenderAheadFrames - _renderFill;
+	}
+
+	while (space > 0) {
+		uint chunk = MIN<uint>(space, kRenderAheadFrames - writePos);
+
+		// This drives the player callback and generateSamples() just like
+		// the mixer does when rendering inline
+		MidiDriver_Emulated::readBuffer(_renderBuffer + writePos * 2, chunk * 2);
+
+		writePos = (writePos + chunk) % kRenderAheadFrames;
+		space -= chunk;
+
+		Common::StackLock lock(_renderBufferMutex);
+		_renderWritePos = writePos;
+		_renderFill += chunk;
+	}
 }
 
-void MidiDriver_ThreadedMT32::sysEx(const byte *msg, uint16 length) {
-	MidiEvent_MT32 *event = new MidiEvent_MT32(0xFFFFFFFF, msg, length);
-	pushMidiEvent(event);
+void MidiDriver_MT32::pushMidiEvent(MidiEvent_MT32 *event) {
+	Common::StackLock lock(_eventMutex);
+	if (_lastEvent)
+		_lastEvent->_next = event;
+	else
+		_events = event;
+	_lastEvent = event;
 }
 
-void MidiDriver_ThreadedMT32::onTimer() {
-	MidiEvent_MT32 *event;
-	while ((event = popMidiEvent()) != NULL) {
-		if (event->_msg == 0xFFFFFFFF) {
-			MidiDriver_MT32::sysEx(event->_data, event->_len);
-		} else {
-			MidiDriver_MT32::send(event->_msg);
-		}
+void MidiDriver_MT32::playMidiEvents() {
+	MidiEvent_MT32 *events;
+	{
+		Common::StackLock lock(_eventMutex);
+		events = _events;
+		_events = _lastEvent = NULL;
+	}
+
+	while (events) {
+		MidiEvent_MT32 *event = events;
+		events = event->_next;
+
+		if (event->_msg == 0xFFFFFFFF)
+			playSysEx(event->_data, event->_len);
+		else
+			_synth->playMsg(event->_msg);
+
 		delete event;
 	}
 }
-#endif
 
 
 // Plugin interface
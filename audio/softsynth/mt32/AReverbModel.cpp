@@ -81,6 +81,9 @@ static const AReverbSettings REVERB_MODE_2_SETTINGS = {MODE_2_ALLPASSES, MODE_2_
 
 static const AReverbSettings * const REVERB_SETTINGS[] = {&REVERB_MODE_0_SETTINGS, &REVERB_MODE_1_SETTINGS, &REVERB_MODE_2_SETTINGS, &REVERB_MODE_0_SETTINGS};
 
+// The reverb is processed filter by filter in blocks of this many samples
+static const Bit32u PROCESS_BLOCK_SIZE = 128;
+
 RingBuffer::RingBuffer(const Bit32u newsize) : size(newsize), index(0) {
 	buffer = new float[size];
 }
@@ -131,6 +134,26 @@ float AllpassFilter::process(const float in) {
 	return bufferOut + 0.5f * buffer[index];
 }
 
+void AllpassFilter::process(float *inOut, Bit32u numSamples) {
+	// Each sample only touches its own slot of the ring buffer, so as long as the ring buffer
+	// doesn't wrap, the samples are independent of each other and the loop can be vectorised
+	while (numSamples > 0) {
+		Bit32u start = index + 1 < size ? index + 1 : 0;
+		Bit32u count = size - start < numSamples ? size - start : numSamples;
+		float *buf = buffer + start;
+
+		for (Bit32u i = 0; i < count; i++) {
+			const float bufferOut = buf[i];
+			buf[i] = inOut[i] - 0.5f * bufferOut;
+			inOut[i] = bufferOut + 0.5f * buf[i];
+		}
+
+		index = start + count - 1;
+		inOut += count;
+		numSamples -= count;
+	}
+}
+
 CombFilter::CombFilter(const Bit32u useSize) : RingBuffer(useSize) {}
 
 void CombFilter::process(const float in) {
@@ -148,7 +171,8 @@ void CombFilter::process(const float in) {
 }
 
 float CombFilter::getOutputAt(const Bit32u outIndex) const {
-	return buffer[(size + index - outIndex) % size];
+	// outIndex never exceeds size, so avoid the division
+	return buffer[index >= outIndex ? index - outIndex : size + index - outIndex];
 }
 
 void CombFilter::setFeedbackFactor(const float useFeedbackFactor) {
@@ -235,40 +259,54 @@ bool AReverbModel::isActive() const {
 }
 
 void AReverbModel::process(const float *inLeft, const float *inRight, float *outLeft, float *outRight, unsigned long numSamples) {
-	float dry, link, outL1;
+	// The filters don't feed back into each other, so rather than running the whole chain for
+	// every sample, each filter processes a block of samples at a time. This keeps the loops
+	// tight and the arithmetic (and thus the output) is exactly the same as the per-sample chain.
+	float link[PROCESS_BLOCK_SIZE];
 
-	for (unsigned long i = 0; i < numSamples; i++) {
-		dry = wetLevel * (*inLeft + *inRight);
+	while (numSamples > 0) {
+		const Bit32u blockSize = numSamples < PROCESS_BLOCK_SIZE ? numSamples : PROCESS_BLOCK_SIZE;
+		Bit32u i;
 
-		// Get the last stored sample before processing in order not to loose it
-		link = combs[0]->getOutputAt(currentSettings.combSizes[0] - 1);
-
-		combs[0]->process(-dry);
+		for (i = 0; i < blockSize; i++) {
+			link[i] = wetLevel * (inLeft[i] + inRight[i]);
+		}
 
-		link = allpasses[0]->process(link);
-		link = allpasses[1]->process(link);
-		link = allpasses[2]->process(link);
+		for (i = 0; i < blockSize; i++) {
+			// Get the last stored sample before processing in order not to loose it
+			const float dry = link[i];
+			link[i] = combs[0]->getOutputAt(currentSettings.combSizes[0] - 1);
+			combs[0]->process(-dry);
+		}
 
-		// If the output position is equal to the comb size, get it now in order not to loose it
-		outL1 = 1.5f * combs[1]->getOutputAt(currentSettings.outLPositions[0] - 1);
+		allpasses[0]->process(link, blockSize);
+		allpasses[1]->process(link, blockSize);
+		allpasses[2]->process(link, blockSize);
 
-		combs[1]->process(link);
-		combs[2]->process(link);
-		combs[3]->process(link);
+		for (i = 0; i < blockSize; i++) {
+			// If the output position is equal to the comb size, get it now in order not to loose it
+			outLeft[i] = 1.5f * combs[1]->getOutputAt(currentSettings.outLPositions[0] - 1);
+			combs[1]->process(link[i]);
+			outRight[i] = 1.5f * combs[1]->getOutputAt(currentSettings.outRPositions[0]);
+		}
 
-		link = outL1 + 1.5f * combs[2]->getOutputAt(currentSettings.outLPositions[1]);
-		link += combs[3]->getOutputAt(currentSettings.outLPositions[2]);
-		*outLeft = link;
+		for (i = 0; i < blockSize; i++) {
+			combs[2]->process(link[i]);
+			outLeft[i] += 1.5f * combs[2]->getOutputAt(currentSettings.outLPositions[1]);
+			outRight[i] += 1.5f * combs[2]->getOutputAt(currentSettings.outRPositions[1]);
+		}
 
-		link = 1.5f * combs[1]->getOutputAt(currentSettings.outRPositions[0]);
-		link += 1.5f * combs[2]->getOutputAt(currentSettings.outRPositions[1]);
-		link += combs[3]->getOutputAt(currentSettings.outRPositions[2]);
-		*outRight = link;
+		for (i = 0; i < blockSize; i++) {
+			combs[3]->process(link[i]);
+			outLeft[i] += combs[3]->getOutputAt(currentSettings.outLPositions[2]);
+			outRight[i] += combs[3]->getOutputAt(currentSettings.outRPositions[2]);
+		}
 
-		inLeft++;
-		inRight++;
-		outLeft++;
-		outRight++;
+		inLeft += blockSize;
+		inRight += blockSize;
+		outLeft += blockSize;
+		outRight += blockSize;
+		numSamples -= blockSize;
 	}
 }
 
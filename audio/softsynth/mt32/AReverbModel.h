@@ -49,6 +49,7 @@ class AllpassFilter : public RingBuffer {
 public:
 	AllpassFilter(const Bit32u size);
 	float process(const float in);
+	void process(float *inOut, Bit32u numSamples);
 };
 
 class CombFilter : public RingBuffer {
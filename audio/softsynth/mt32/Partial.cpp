@@ -297,13 +297,12 @@ bool Partial::produceOutput(float *leftBuf, float *rightBuf, unsigned long lengt
 		return false;
 	}
 	unsigned long numGenerated = generateSamples(myBuffer, length);
+	// Mix straight into the output, this saves a temporary buffer and a pass over it per partial
+	const float leftVol = stereoVolume.leftVol;
+	const float rightVol = stereoVolume.rightVol;
 	for (unsigned int i = 0; i < numGenerated; i++) {
-		*leftBuf++ = myBuffer[i] * stereoVolume.leftVol;
-		*rightBuf++ = myBuffer[i] * stereoVolume.rightVol;
-	}
-	for (; numGenerated < length; numGenerated++) {
-		*leftBuf++ = 0.0f;
-		*rightBuf++ = 0.0f;
+		leftBuf[i] += myBuffer[i] * leftVol;
+		rightBuf[i] += myBuffer[i] * rightVol;
 	}
 	return true;
 }
@@ -98,9 +98,10 @@ public:
 	const ControlROMPCMStruct *getControlROMPCMStruct() const;
 	Synth *getSynth() const;
 
-	// Returns true only if data written to buffer
-	// This function (unlike the one below it) returns processed stereo samples
-	// made from combining this single partial with its pair, if it has one.
+	// Returns true only if data mixed into buffer
+	// This function (unlike the one below it) mixes processed stereo samples
+	// made from combining this single partial with its pair, if it has one,
+	// into the provided buffers.
 	bool produceOutput(float *leftBuf, float *rightBuf, unsigned long length);
 
 	// This function writes mono sample output to the provided buffer, and returns the number of samples written
@@ -1020,11 +1020,22 @@ static void OPL_UnLockTable(void) {
 /*		YM3812 local section                                                   */
 /*******************************************************************************/
 
+/* channel has no sound and will not get any until the next key on */
+inline bool OPL_CH_SILENT(const OPL_CH *CH) {
+	return CH->SLOT[SLOT1].evc == EG_OFF && CH->SLOT[SLOT1].evs == 0 &&
+		CH->SLOT[SLOT2].evc == EG_OFF && CH->SLOT[SLOT2].evs == 0;
+}
+
 /* ---------- update one of chip ----------- */
 void YM3812UpdateOne(FM_OPL *OPL, int16 *buffer, int length) {
+	/* samples are rendered in blocks, one channel at a time */
+	enum { BLOCK_SIZE = 256 };
+	int amsBuf[BLOCK_SIZE];
+	int vibBuf[BLOCK_SIZE];
+	int outBuf[BLOCK_SIZE];
+
 	int i;
 	int data;
-	int16 *buf = buffer;
 	uint amsCnt = OPL->amsCnt;
 	uint vibCnt = OPL->vibCnt;
 	uint8 rythm = OPL->rythm & 0x20;
@@ -1048,22 +1059,56 @@ void YM3812UpdateOne(FM_OPL *OPL, int16 *buffer, int length) {
 		vib_table = OPL->vib_table;
 	}
 	R_CH = rythm ? &S_CH[6] : E_CH;
-	for (i = 0; i < length; i++) {
-		/*            channel A         channel B         channel C      */
+	while (length > 0) {
+		const int count = MIN<int>(length, BLOCK_SIZE);
+
 		/* LFO */
-		ams = ams_table[(amsCnt += amsIncr) >> AMS_SHIFT];
-		vib = vib_table[(vibCnt += vibIncr) >> VIB_SHIFT];
-		outd[0] = 0;
+		for (i = 0; i < count; i++) {
+			amsBuf[i] = ams_table[(amsCnt += amsIncr) >> AMS_SHIFT];
+			vibBuf[i] = vib_table[(vibCnt += vibIncr) >> VIB_SHIFT];
+			outBuf[i] = 0;
+		}
+
 		/* FM part */
-		for (CH = S_CH; CH < R_CH; CH++)
-			OPL_CALC_CH(CH);
+		for (CH = S_CH; CH < R_CH; CH++) {
+			/* Register writes only happen between updates, so a silent  */
+			/* channel stays silent for the whole block; all it would do */
+			/* is run out its feedback history.                          */
+			if (OPL_CH_SILENT(CH)) {
+				CH->op1_out[1] = (count > 1) ? 0 : CH->op1_out[0];
+				CH->op1_out[0] = 0;
+				continue;
+			}
+
+			for (i = 0; i < count; i++) {
+				ams = amsBuf[i];
+				vib = vibBuf[i];
+				outd[0] = outBuf[i];
+				OPL_CALC_CH(CH);
+				outBuf[i] = outd[0];
+			}
+		}
+
 		/* Rythn part */
-		if (rythm)
-			OPL_CALC_RH(OPL, S_CH);
-		/* limit check */
-		data = CLIP(outd[0], OPL_MINOUT, OPL_MAXOUT);
-		/* store to sound buffer */
-		buf[i] = data >> OPL_OUTSB;
+		if (rythm) {
+			for (i = 0; i < count; i++) {
+				ams = amsBuf[i];
+				vib = vibBuf[i];
+				outd[0] = outBuf[i];
+				OPL_CALC_RH(OPL, S_CH);
+				outBuf[i] = outd[0];
+			}
+		}
+
+		for (i = 0; i < count; i++) {
+			/* limit check */
+			data = CLIP(outBuf[i], OPL_MINOUT, OPL_MAXOUT);
+			/* store to sound buffer */
+			buffer[i] = data >> OPL_OUTSB;
+		}
+
+		buffer += count;
+		length -= count;
 	}
 
 	OPL->amsCnt = amsCnt;
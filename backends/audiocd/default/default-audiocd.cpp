@@ -22,6 +22,8 @@
 
 #include "backends/audiocd/default/default-audiocd.h"
 #include "audio/audiostream.h"
+#include "audio/decodeahead.h"
+#include "common/config-manager.h"
 #include "common/system.h"
 
 DefaultAudioCDManager::DefaultAudioCDManager() {
@@ -59,6 +61,11 @@ void DefaultAudioCDManager::play(int track, int numLoops, int startFrame, int du
 		_mixer->stopHandle(_handle);
 
 		if (stream != 0) {
+			// Decode compressed tracks ahead of playback instead of in the
+			// mixer callback, if the user asked for it
+			if (ConfMan.getBool("audio_decode_ahead"))
+				stream = Audio::makeDecodeAheadStream(stream, DisposeAfterUse::YES);
+
 			Audio::Timestamp start = Audio::Timestamp(0, startFrame, 75);
 			Audio::Timestamp end = duration ? Audio::Timestamp(0, startFrame + duration, 75) : stream->getLength();
 
@@ -52,6 +52,9 @@ void DoubleBufferSDLMixerManager::startAudio() {
 
 	_soundThreadIsRunning = true;
 
+	// The producer thread keeps one more buffer ready
+	_mixer->setOutputBufferSize(_obtained.samples * 3);
+
 	// Finally start the thread
 	_soundThread = SDL_CreateThread(mixerProducerThreadEntry, this);
 
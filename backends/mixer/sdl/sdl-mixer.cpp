@@ -61,6 +61,9 @@ void SdlMixerManager::init() {
 	// Get the desired audio specs
 	SDL_AudioSpec desired = getAudioSpec(SAMPLES_PER_SEC);
 
+	if (ConfMan.hasKey("audio_low_latency") && ConfMan.getBool("audio_low_latency"))
+		desired.samples = negotiateBufferSize(desired);
+
 	// Needed as SDL_OpenAudio as of SDL-1.2.14 mutates fields in
 	// "desired" if used directly.
 	SDL_AudioSpec fmt = desired;
@@ -95,6 +98,10 @@ void SdlMixerManager::init() {
 		assert(_mixer);
 		_mixer->setReady(true);
 
+		// SDL mixes into its own buffer while the device plays the previous one
+		_mixer->setOutputBufferSize(_obtained.samples * 2);
+		debug(1, "Output latency: %d ms", _mixer->getOutputLatency());
+
 		startAudio();
 	}
 }
@@ -128,6 +135,42 @@ SDL_AudioSpec SdlMixerManager::getAudioSpec(uint32 outputRate) {
 	return desired;
 }
 
+uint16 SdlMixerManager::negotiateBufferSize(const SDL_AudioSpec &desired) {
+	// Time to listen to the callbacks for each buffer size
+	const uint32 probeTime = 250;
+
+	uint32 samples = 64;
+	while (samples * 200 < (uint32)desired.freq)
+		samples <<= 1;
+
+	for (; samples < desired.samples; samples <<= 1) {
+		Audio::OutputTiming timing;
+
+		SDL_AudioSpec probe = desired;
+		probe.samples = (uint16)samples;
+		probe.callback = sdlProbeCallback;
+		probe.userdata = &timing;
+
+		SDL_AudioSpec obtained;
+		if (SDL_OpenAudio(&probe, &obtained) != 0)
+			break;
+
+		timing.reset(obtained.freq, obtained.samples * 2);
+		SDL_PauseAudio(0);
+		SDL_Delay(probeTime);
+		// Waits for a running callback to finish
+		SDL_CloseAudio();
+
+		debug(1, "Audio buffer of %d samples: %d callbacks, average period %d us, max jitter %d us",
+		      obtained.samples, timing.getCallbackCount(), timing.getAveragePeriod(), timing.getMaxJitter());
+
+		if (timing.isStable())
+			return obtained.samples;
+	}
+
+	return desired.samples;
+}
+
 void SdlMixerManager::startAudio() {
 	// Start the sound system
 	SDL_PauseAudio(0);
@@ -145,6 +188,11 @@ void SdlMixerManager::sdlCallback(void *this_, byte *samples, int len) {
 	manager->callbackHandler(samples, len);
 }
 
+void SdlMixerManager::sdlProbeCallback(void *timing, byte *samples, int len) {
+	memset(samples, 0, len);
+	((Audio::OutputTiming *)timing)->addCallback(SDL_GetTicks(), len / 4);
+}
+
 void SdlMixerManager::suspendAudio() {
 	SDL_CloseAudio();
 	_audioSuspended = true;
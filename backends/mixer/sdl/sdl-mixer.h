@@ -77,6 +77,14 @@ protected:
 	 */
 	virtual SDL_AudioSpec getAudioSpec(uint32 rate);
 
+	/**
+	 * Find the smallest buffer size, in samples, with which the audio
+	 * device receives its callbacks regularly enough to never run dry.
+	 * Starts at about 5 ms of audio and doubles the size until it is
+	 * stable, up to the size of the desired audio specification.
+	 */
+	uint16 negotiateBufferSize(const SDL_AudioSpec &desired);
+
 	/**
 	 * Starts SDL audio
 	 */
@@ -92,6 +100,12 @@ protected:
 	 * by subclasses, so it invokes the non-static function callbackHandler()
 	 */
 	static void sdlCallback(void *this_, byte *samples, int len);
+
+	/**
+	 * The callback used while negotiating the buffer size. It only outputs
+	 * silence and records the time of the callback.
+	 */
+	static void sdlProbeCallback(void *timing, byte *samples, int len);
 };
 
 #endif
@@ -78,6 +78,9 @@ void Sdl13MixerManager::init() {
 		assert(_mixer);
 		_mixer->setReady(true);
 
+		// SDL mixes into its own buffer while the device plays the previous one
+		_mixer->setOutputBufferSize(_obtained.samples * 2);
+
 		startAudio();
 	}
 }
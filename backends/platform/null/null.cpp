@@ -20,14 +20,34 @@
  *
  */
 
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_FILE
+#define FORBIDDEN_SYMBOL_EXCEPTION_stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+#define FORBIDDEN_SYMBOL_EXCEPTION_fputs
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
 #include "backends/modular-backend.h"
 #include "base/main.h"
 
 #if defined(USE_NULL_DRIVER)
+#include "backends/events/default/default-events.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mutex/null/null-mutex.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "audio/mixer_intern.h"
+#include "common/config-manager.h"
+#include "common/EventRecorder.h"
+#include "common/md5.h"
+#include "common/memstream.h"
 #include "common/scummsys.h"
+#include "graphics/surface.h"
+
+#if defined(POSIX)
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
 
 /*
  * Include header files needed for the getFilesystemFactory() method.
@@ -40,20 +60,123 @@
 	#include "backends/fs/windows/windows-fs-factory.h"
 #endif
 
-class OSystem_NULL : public ModularBackend {
+/**
+ * Keeps the screen contents in memory and counts the frames, so that the
+ * result of a benchmark run can be checked.
+ */
+class BenchmarkGraphicsManager : public NullGraphicsManager {
+public:
+	BenchmarkGraphicsManager() : _format(Graphics::PixelFormat::createFormatCLUT8()), _frames(0) {
+		memset(_palette, 0, sizeof(_palette));
+	}
+
+	virtual ~BenchmarkGraphicsManager() {
+		_screen.free();
+	}
+
+	Graphics::PixelFormat getScreenFormat() const { return _format; }
+
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {
+		_format = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+		_screen.free();
+		_screen.create(width, height, _format);
+		memset(_screen.pixels, 0, _screen.pitch * _screen.h);
+	}
+
+	int16 getHeight() { return _screen.h; }
+	int16 getWidth() { return _screen.w; }
+
+	void setPalette(const byte *colors, uint start, uint num) {
+		memcpy(_palette + start * 3, colors, num * 3);
+	}
+
+	void grabPalette(byte *colors, uint start, uint num) {
+		memcpy(colors, _palette + start * 3, num * 3);
+	}
+
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+		const byte *src = (const byte *)buf;
+		for (int i = 0; i < h; ++i, src += pitch)
+			memcpy(_screen.getBasePtr(x, y + i), src, w * _format.bytesPerPixel);
+	}
+
+	Graphics::Surface *lockScreen() { return &_screen; }
+
+	void fillScreen(uint32 col) {
+		_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+	}
+
+	void updateScreen() { ++_frames; }
+
+	uint32 getFrameCount() const { return _frames; }
+
+	/** Returns the MD5 of the screen contents and, for 8bpp modes, the palette. */
+	Common::String computeScreenHash() const {
+		const uint32 screenSize = _screen.pitch * _screen.h;
+		const uint32 paletteSize = _format.bytesPerPixel == 1 ? sizeof(_palette) : 0;
+		byte *data = new byte[screenSize + paletteSize];
+
+		if (screenSize)
+			memcpy(data, _screen.pixels, screenSize);
+		memcpy(data + screenSize, _palette, paletteSize);
+
+		Common::MemoryReadStream stream(data, screenSize + paletteSize, DisposeAfterUse::YES);
+		return Common::computeStreamMD5AsString(stream);
+	}
+
+private:
+	Graphics::PixelFormat _format;
+	Graphics::Surface _screen;
+	byte _palette[256 * 3];
+	uint32 _frames;
+};
+
+class OSystem_NULL : public ModularBackend, Common::EventSource {
 public:
 	OSystem_NULL();
 	virtual ~OSystem_NULL();
 
 	virtual void initBackend();
 
+	virtual Common::EventSource *getDefaultEventSource() { return this; }
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual uint32 getMillis();
+	virtual uint32 getUnrecordedMillis();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const {}
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+	/** Prints the statistics of an event recorder playback. */
+	void printBenchmarkResults();
+
+private:
+	/**
+	 * Advances the virtual clock, running the timers and mixing the sound
+	 * which would be due in the meantime.
+	 */
+	void advanceTime(uint msecs);
+
+	/** Mixes the sound for the given time. */
+	void mixSound(uint msecs);
+
+	BenchmarkGraphicsManager *_benchmarkGraphicsManager;
+
+	// There is no real time here: the clock only moves when the engine waits
+	// or polls for events, which lets recordings play back as fast as
+	// possible and the same way every time
+	uint32 _millis;
+	uint32 _mixRemainder;
+	bool _inTimerHandler;
+
+#if defined(POSIX)
+	// The real time, for measuring how long the engine takes
+	timeval _startTime;
+#endif
+
+	bool _benchmark;
+	bool _quitSent;
 };
 
 OSystem_NULL::OSystem_NULL() {
@@ -66,37 +189,141 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+	_benchmarkGraphicsManager = 0;
+	_millis = 0;
+	_mixRemainder = 0;
+	_inTimerHandler = false;
+	_benchmark = false;
+	_quitSent = false;
+
+#if defined(POSIX)
+	gettimeofday(&_startTime, 0);
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
 }
 
 void OSystem_NULL::initBackend() {
+	_benchmarkGraphicsManager = new BenchmarkGraphicsManager();
+
 	_mutexManager = new NullMutexManager();
 	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
-	_graphicsManager = new NullGraphicsManager();
+	_graphicsManager = _benchmarkGraphicsManager;
 	_mixer = new Audio::MixerImpl(this, 22050);
 
-	((Audio::MixerImpl *)_mixer)->setReady(false);
+	// Playing back a recording is a benchmark run, which quits once the
+	// recording is over
+	_benchmark = ConfMan.get("record_mode").equalsIgnoreCase("playback");
 
-	// Note that both the mixer and the timer manager are useless
-	// this way; they need to be hooked into the system somehow to
-	// be functional. Of course, can't do that in a NULL backend :).
+	// Sound is only mixed for benchmark runs, from advanceTime()
+	((Audio::MixerImpl *)_mixer)->setReady(_benchmark);
 
 	ModularBackend::initBackend();
 }
 
 bool OSystem_NULL::pollEvent(Common::Event &event) {
+	// Engines waiting for something to happen without delaying in between
+	// would never get anywhere otherwise
+	advanceTime(1);
+
+	if (_benchmark && !_quitSent && g_eventRec.isPlaybackFinished()) {
+		event.type = Common::EVENT_QUIT;
+		_quitSent = true;
+		return true;
+	}
+
 	return false;
 }
 
 uint32 OSystem_NULL::getMillis() {
-	return 0;
+	// The timers and the mixer run as part of the backend here, not in a
+	// thread of their own. Their clock readings must not use up the timings
+	// the event recorder has recorded for the engine.
+	if (_inTimerHandler)
+		return _millis;
+
+	uint32 millis = _millis;
+	g_eventRec.processMillis(millis);
+	return millis;
+}
+
+uint32 OSystem_NULL::getUnrecordedMillis() {
+#if defined(POSIX)
+	timeval curTime;
+	gettimeofday(&curTime, 0);
+
+	return (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
+	                ((curTime.tv_usec - _startTime.tv_usec) / 1000));
+#else
+	return _millis;
+#endif
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+	if (_inTimerHandler || !g_eventRec.processDelayMillis(msecs))
+		advanceTime(msecs);
+}
+
+void OSystem_NULL::advanceTime(uint msecs) {
+	_millis += msecs;
+
+	// Timer procs may wait themselves
+	if (_inTimerHandler)
+		return;
+
+	_inTimerHandler = true;
+	((DefaultTimerManager *)_timerManager)->handler();
+
+	if (_benchmark)
+		mixSound(msecs);
+
+	_inTimerHandler = false;
+}
+
+void OSystem_NULL::mixSound(uint msecs) {
+	Audio::MixerImpl *mixer = (Audio::MixerImpl *)_mixer;
+	const uint32 rate = mixer->getOutputRate();
+	uint32 samples = (msecs * rate + _mixRemainder) / 1000;
+	_mixRemainder = (msecs * rate + _mixRemainder) % 1000;
+
+	// 16 bit stereo
+	byte buffer[1024 * 4];
+	while (samples > 0) {
+		const uint32 len = MIN<uint32>(samples, 1024);
+		mixer->mixCallback(buffer, len * 4);
+		samples -= len;
+	}
+}
+
+void OSystem_NULL::printBenchmarkResults() {
+	if (!_benchmark)
+		return;
+
+	Common::String results = "Benchmark results:\n";
+	results += Common::String::format("  frames: %u\n", _benchmarkGraphicsManager->getFrameCount());
+	results += Common::String::format("  virtual time: %u ms\n", _millis);
+
+#if defined(POSIX)
+	struct rusage usage;
+	if (!getrusage(RUSAGE_SELF, &usage)) {
+		const long cpuMillis = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 +
+		                       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+		results += Common::String::format("  CPU time: %ld ms\n", cpuMillis);
+#if defined(MACOSX)
+		// Reported in bytes rather than kilobytes here
+		results += Common::String::format("  peak memory: %ld KB\n", (long)usage.ru_maxrss / 1024);
+#else
+		results += Common::String::format("  peak memory: %ld KB\n", (long)usage.ru_maxrss);
+#endif
+	}
+#endif
+
+	results += "  screen hash: " + _benchmarkGraphicsManager->computeScreenHash() + "\n";
+	logMessage(LogMessageType::kInfo, results.c_str());
 }
 
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
@@ -121,6 +348,7 @@ int main(int argc, char *argv[]) {
 
 	// Invoke the actual ScummVM main entry point:
 	int res = scummvm_main(argc, argv);
+	((OSystem_NULL *)g_system)->printBenchmarkResults();
 	delete (OSystem_NULL *)g_system;
 	return res;
 }
@@ -472,6 +472,10 @@ uint32 OSystem_SDL::getMillis() {
 	return millis;
 }
 
+uint32 OSystem_SDL::getUnrecordedMillis() {
+	return SDL_GetTicks();
+}
+
 void OSystem_SDL::delayMillis(uint msecs) {
 	if (!g_eventRec.processDelayMillis(msecs))
 		SDL_Delay(msecs);
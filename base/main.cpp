@@ -52,6 +52,7 @@
 #include "gui/gui-manager.h"
 #include "gui/error.h"
 
+#include "audio/decodedcache.h"
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
 
@@ -240,6 +241,9 @@ static Common::Error runGame(const EnginePlugin *plugin, OSystem &system, const
 	// Reset the file/directory mappings
 	SearchMan.clear();
 
+	// Drop the sounds the engine cached
+	DecodedAudioCacheMan.clear();
+
 	// Return result (== 0 means no error)
 	return result;
 }
@@ -358,6 +358,13 @@ bool EventRecorder::processDelayMillis(uint &msecs) {
 	return false;
 }
 
+bool EventRecorder::isPlaybackFinished() const {
+	if (_recordMode != kRecorderPlayback)
+		return false;
+
+	return !_hasPlaybackEvent && _playbackCount >= _recordCount && _playbackTimeCount >= _recordTimeCount;
+}
+
 bool EventRecorder::notifyEvent(const Event &ev) {
 	if (_recordMode != kRecorderRecord)
 		return false;
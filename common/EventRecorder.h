@@ -59,6 +59,12 @@ public:
 	/** TODO: Add documentation, this is only used by the backend */
 	bool processDelayMillis(uint &msecs);
 
+	/**
+	 * Returns whether a playback has used up all recorded events and
+	 * timings. Backends can use this to end unattended playbacks.
+	 */
+	bool isPlaybackFinished() const;
+
 private:
 	bool notifyEvent(const Event &ev);
 	bool notifyPoll();
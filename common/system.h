@@ -893,6 +893,18 @@ public:
 	/** Get the number of milliseconds since the program was started. */
 	virtual uint32 getMillis() = 0;
 
+	/**
+	 * Get the number of milliseconds since the program was started, for
+	 * measuring how long something takes. Unlike with getMillis(), the
+	 * event recorder neither records nor replays these readings, so
+	 * profiling code can read the clock as often as it likes without
+	 * changing a recording or its playback.
+	 *
+	 * Backends whose getMillis() is not hooked up to the event recorder
+	 * need not override this.
+	 */
+	virtual uint32 getUnrecordedMillis() { return getMillis(); }
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
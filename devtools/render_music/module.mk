@@ -0,0 +1,27 @@
+
+MODULE := devtools/render_music
+
+# The renderer drives the real mixer and music drivers, so unlike the other
+# devtools it links against the libraries of the main build. It is built
+# the same way as the unit test runner.
+RENDER_MUSIC_LIBS := backends/libbackends.a audio/libaudio.a
+
+ifdef USE_MT32EMU
+RENDER_MUSIC_LIBS += audio/softsynth/mt32/libmt32.a
+endif
+
+RENDER_MUSIC_LIBS += gui/libgui.a graphics/libgraphics.a common/libcommon.a
+
+devtools/render_music/render_music$(EXEEXT): $(srcdir)/devtools/render_music/render_music.cpp $(RENDER_MUSIC_LIBS)
+	$(QUIET)$(MKDIR) devtools/render_music
+	$(QUIET_LINK)$(CXX) $(filter-out -Wglobal-constructors,$(CXXFLAGS)) $(CPPFLAGS) -o $@ $+ $(LIBS)
+
+# Add to "devtools" target
+devtools: devtools/render_music/render_music$(EXEEXT)
+
+clean-devtools: clean-devtools/render_music
+
+clean-devtools/render_music:
+	-$(RM) devtools/render_music/render_music$(EXEEXT)
+
+.PHONY: clean-devtools/render_music
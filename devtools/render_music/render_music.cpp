@@ -0,0 +1,511 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * Offline music renderer.
+ *
+ * Feeds a MIDI, XMIDI or ProTracker file through one of our software music
+ * drivers, renders the requested amount of audio as fast as possible and
+ * reports how much faster than realtime that was. The output can optionally
+ * be written to a WAV file, so that changes to a synth can be checked for
+ * audible differences as well as for speed.
+ *
+ * The mixer is driven directly from the main loop instead of from an audio
+ * callback, so the measured time is purely the cost of the parser, the
+ * driver and the mixer.
+ */
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+// HACK to allow building with the SDL backend on MinGW
+// see bug #1800764 "TOOLS: MinGW tools building broken"
+#ifdef main
+#undef main
+#endif // main
+
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mutex/null/null-mutex.h"
+#include "backends/timer/default/default-timer.h"
+
+#if defined(POSIX)
+#include "backends/fs/posix/posix-fs-factory.h"
+#elif defined(WIN32)
+#include "backends/fs/windows/windows-fs-factory.h"
+#endif
+
+#include "audio/mididrv.h"
+#include "audio/midiparser.h"
+#include "audio/mixer_intern.h"
+#include "audio/musicplugin.h"
+#include "audio/mods/paula.h"
+#include "audio/mods/protracker.h"
+
+#include "common/archive.h"
+#include "common/config-manager.h"
+#include "common/error.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/scummsys.h"
+#include "common/str-array.h"
+#include "common/system.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RENDER_CHUNK_FRAMES 1024
+
+/**
+ * Minimal backend: no video, no events and no audio thread. The mixer is
+ * only ever run from the main loop via MixerImpl::mixCallback().
+ *
+ * This derives from OSystem directly rather than from ModularBackend, since
+ * the latter pulls in the event manager and with it the GUI and engine code.
+ */
+class OSystem_RenderMusic : public OSystem {
+public:
+	OSystem_RenderMusic(uint rate);
+	virtual ~OSystem_RenderMusic();
+
+	virtual void initBackend();
+
+	// Graphics: everything is routed to the null graphics manager
+	virtual const GraphicsMode *getSupportedGraphicsModes() const { return _graphicsManager->getSupportedGraphicsModes(); }
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return true; }
+	virtual int getGraphicsMode() const { return 0; }
+#ifdef USE_RGB_COLOR
+	virtual Graphics::PixelFormat getScreenFormat() const { return _graphicsManager->getScreenFormat(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return _graphicsManager->getSupportedFormats(); }
+#endif
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return _graphicsManager; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+
+	// Time: the renderer is single threaded, so there is nothing to wait for
+	virtual uint32 getMillis();
+	virtual void delayMillis(uint msecs) {}
+	virtual void getTimeAndDate(TimeDate &t) const {}
+
+	virtual MutexRef createMutex() { return _mutexManager->createMutex(); }
+	virtual void lockMutex(MutexRef mutex) { _mutexManager->lockMutex(mutex); }
+	virtual void unlockMutex(MutexRef mutex) { _mutexManager->unlockMutex(mutex); }
+	virtual void deleteMutex(MutexRef mutex) { _mutexManager->deleteMutex(mutex); }
+
+	virtual Audio::Mixer *getMixer() { return _mixer; }
+	Audio::MixerImpl *getMixerImpl() { return _mixer; }
+
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg);
+	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+private:
+	uint _rate;
+
+	NullMutexManager *_mutexManager;
+	NullGraphicsManager *_graphicsManager;
+	Audio::MixerImpl *_mixer;
+};
+
+OSystem_RenderMusic::OSystem_RenderMusic(uint rate) : _rate(rate), _mutexManager(0), _graphicsManager(0), _mixer(0) {
+#if defined(POSIX)
+	_fsFactory = new POSIXFilesystemFactory();
+#elif defined(WIN32)
+	_fsFactory = new WindowsFilesystemFactory();
+#else
+	#error Unknown and unsupported FS backend
+#endif
+}
+
+OSystem_RenderMusic::~OSystem_RenderMusic() {
+	// The timer manager uses our mutexes, so it has to go before them
+	delete _timerManager;
+	_timerManager = 0;
+
+	delete _mixer;
+	delete _graphicsManager;
+	delete _mutexManager;
+}
+
+void OSystem_RenderMusic::initBackend() {
+	_mutexManager = new NullMutexManager();
+	_timerManager = new DefaultTimerManager();
+	_graphicsManager = new NullGraphicsManager();
+	_mixer = new Audio::MixerImpl(this, _rate);
+	_mixer->setReady(true);
+
+	// There are no audio CD and event managers, so OSystem::initBackend()
+	// is deliberately not invoked.
+}
+
+uint32 OSystem_RenderMusic::getMillis() {
+	return (uint32)((uint64)clock() * 1000 / CLOCKS_PER_SEC);
+}
+
+void OSystem_RenderMusic::displayMessageOnOSD(const char *msg) {
+	printf("%s\n", msg);
+}
+
+void OSystem_RenderMusic::logMessage(LogMessageType::Type type, const char *message) {
+	FILE *output = (type == LogMessageType::kInfo || type == LogMessageType::kDebug) ? stdout : stderr;
+
+	fputs(message, output);
+	fflush(output);
+}
+
+/*
+ * The software music drivers are registered as static plugins. Link them in
+ * the same way base/plugins.cpp does, but only the ones which can play plain
+ * MIDI data. The PC speaker, CMS, SID and Amiga plugins only provide a null
+ * MIDI driver, since those chips are driven by engine specific players, and
+ * the FM-Towns driver needs instrument data uploaded by the engine first.
+ */
+#define LINK_PLUGIN(ID) \
+	extern PluginObject *g_##ID##_getObject();
+
+#ifdef USE_FLUIDSYNTH
+LINK_PLUGIN(FLUIDSYNTH)
+#endif
+#ifdef USE_MT32EMU
+LINK_PLUGIN(MT32)
+#endif
+LINK_PLUGIN(ADLIB)
+
+#undef LINK_PLUGIN
+
+struct MusicPluginEntry {
+	PluginObject *(*getObject)();
+};
+
+static const MusicPluginEntry musicPlugins[] = {
+#ifdef USE_FLUIDSYNTH
+	{ g_FLUIDSYNTH_getObject },
+#endif
+#ifdef USE_MT32EMU
+	{ g_MT32_getObject },
+#endif
+	{ g_ADLIB_getObject },
+	{ 0 }
+};
+
+static void displayHelp(const char *exe) {
+	printf("Usage: %s [options] <file>\n"
+	       "\n"
+	       "Renders a MIDI, XMIDI or ProTracker module through a music driver\n"
+	       "as fast as possible and reports the realtime factor.\n"
+	       "\n"
+	       "Options:\n"
+	       "  -d, --driver ID    music driver to use (default: adlib)\n"
+	       "  -l, --list         list the available music drivers\n"
+	       "  -s, --seconds N    seconds of audio to render (default: 60)\n"
+	       "  -r, --rate N       output sample rate (default: 44100)\n"
+	       "  -t, --track N      track of the MIDI file to play (default: 0)\n"
+	       "  -o, --output FILE  write the rendered audio to a WAV file\n"
+	       "  -p, --path DIR     extra search path, e.g. for the MT-32 ROMs\n"
+	       "  --soundfont FILE   sound font for the FluidSynth driver\n"
+	       "  --loop             loop the MIDI song until enough audio was rendered\n"
+	       "  --band-limited     use the band-limited Paula output for modules\n"
+	       "\n"
+	       "ProTracker modules are always rendered through the Paula emulator;\n"
+	       "the driver option is ignored for them.\n", exe);
+}
+
+static void listDrivers() {
+	printf("%-12s %s\n", "ID", "Description");
+	for (const MusicPluginEntry *p = musicPlugins; p->getObject; ++p) {
+		MusicPluginObject *plugin = (MusicPluginObject *)p->getObject();
+		printf("%-12s %s\n", plugin->getId(), plugin->getName());
+		delete plugin;
+	}
+}
+
+static MidiDriver *createDriver(const char *id) {
+	for (const MusicPluginEntry *p = musicPlugins; p->getObject; ++p) {
+		MusicPluginObject *plugin = (MusicPluginObject *)p->getObject();
+		MidiDriver *driver = 0;
+
+		if (!scumm_stricmp(plugin->getId(), id)) {
+			MusicDevices devices = plugin->getDevices();
+			plugin->createInstance(&driver, devices.empty() ? 0 : devices.front().getHandle());
+			if (!driver)
+				error("Could not create music driver '%s'", id);
+		}
+
+		delete plugin;
+
+		if (driver)
+			return driver;
+	}
+
+	error("Unknown music driver '%s', use --list to show the available ones", id);
+	return 0;
+}
+
+static void registerDefaults() {
+	// Keep in sync with the audio related defaults in base/commandLine.cpp
+	ConfMan.registerDefault("music_volume", 192);
+	ConfMan.registerDefault("native_mt32", false);
+	ConfMan.registerDefault("enable_gs", false);
+	ConfMan.registerDefault("midi_gain", 100);
+	ConfMan.registerDefault("mt32_render_ahead", false);
+
+	ConfMan.registerDefault("fluidsynth_chorus_activate", true);
+	ConfMan.registerDefault("fluidsynth_chorus_nr", 3);
+	ConfMan.registerDefault("fluidsynth_chorus_level", 100);
+	ConfMan.registerDefault("fluidsynth_chorus_speed", 30);
+	ConfMan.registerDefault("fluidsynth_chorus_depth", 80);
+	ConfMan.registerDefault("fluidsynth_chorus_waveform", "sine");
+
+	ConfMan.registerDefault("fluidsynth_reverb_activate", true);
+	ConfMan.registerDefault("fluidsynth_reverb_roomsize", 20);
+	ConfMan.registerDefault("fluidsynth_reverb_damping", 0);
+	ConfMan.registerDefault("fluidsynth_reverb_width", 1);
+	ConfMan.registerDefault("fluidsynth_reverb_level", 90);
+
+	ConfMan.registerDefault("fluidsynth_misc_interpolation", "4th");
+}
+
+static void writeWaveHeader(FILE *out, uint rate, uint32 dataSize) {
+	byte header[44];
+
+	WRITE_BE_UINT32(header +  0, MKTAG('R', 'I', 'F', 'F'));
+	WRITE_LE_UINT32(header +  4, 36 + dataSize);
+	WRITE_BE_UINT32(header +  8, MKTAG('W', 'A', 'V', 'E'));
+	WRITE_BE_UINT32(header + 12, MKTAG('f', 'm', 't', ' '));
+	WRITE_LE_UINT32(header + 16, 16);
+	WRITE_LE_UINT16(header + 20, 1);            // PCM
+	WRITE_LE_UINT16(header + 22, 2);            // channels
+	WRITE_LE_UINT32(header + 24, rate);
+	WRITE_LE_UINT32(header + 28, rate * 4);     // bytes per second
+	WRITE_LE_UINT16(header + 32, 4);            // block align
+	WRITE_LE_UINT16(header + 34, 16);           // bits per sample
+	WRITE_BE_UINT32(header + 36, MKTAG('d', 'a', 't', 'a'));
+	WRITE_LE_UINT32(header + 40, dataSize);
+
+	fseek(out, 0, SEEK_SET);
+	fwrite(header, 1, sizeof(header), out);
+}
+
+int main(int argc, char *argv[]) {
+	const char *driverId = "adlib";
+	const char *inputName = 0;
+	const char *outputName = 0;
+	uint seconds = 60;
+	uint rate = 44100;
+	int track = 0;
+	bool loop = false;
+	bool bandLimited = false;
+	Common::StringArray searchPaths;
+
+	OSystem_RenderMusic *system = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const bool hasValue = (i + 1 < argc);
+
+		if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+			displayHelp(argv[0]);
+			return 0;
+		} else if (!strcmp(arg, "-l") || !strcmp(arg, "--list")) {
+			g_system = system = new OSystem_RenderMusic(rate);
+			system->initBackend();
+			listDrivers();
+			delete system;
+			return 0;
+		} else if ((!strcmp(arg, "-d") || !strcmp(arg, "--driver")) && hasValue) {
+			driverId = argv[++i];
+		} else if ((!strcmp(arg, "-s") || !strcmp(arg, "--seconds")) && hasValue) {
+			seconds = atoi(argv[++i]);
+		} else if ((!strcmp(arg, "-r") || !strcmp(arg, "--rate")) && hasValue) {
+			rate = atoi(argv[++i]);
+		} else if ((!strcmp(arg, "-t") || !strcmp(arg, "--track")) && hasValue) {
+			track = atoi(argv[++i]);
+		} else if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && hasValue) {
+			outputName = argv[++i];
+		} else if ((!strcmp(arg, "-p") || !strcmp(arg, "--path")) && hasValue) {
+			searchPaths.push_back(argv[++i]);
+		} else if (!strcmp(arg, "--soundfont") && hasValue) {
+			ConfMan.set("soundfont", argv[++i]);
+		} else if (!strcmp(arg, "--loop")) {
+			loop = true;
+		} else if (!strcmp(arg, "--band-limited")) {
+			bandLimited = true;
+		} else if (arg[0] != '-' && !inputName) {
+			inputName = arg;
+		} else {
+			fprintf(stderr, "ERROR: Unknown or incomplete option \"%s\"\n\n", arg);
+			displayHelp(argv[0]);
+			return -1;
+		}
+	}
+
+	if (!inputName || !seconds || !rate) {
+		displayHelp(argv[0]);
+		return -1;
+	}
+
+	g_system = system = new OSystem_RenderMusic(rate);
+	system->initBackend();
+	registerDefaults();
+
+	for (Common::StringArray::const_iterator i = searchPaths.begin(); i != searchPaths.end(); ++i)
+		SearchMan.addDirectory(*i, *i);
+
+	Common::File in;
+	if (!in.open(Common::FSNode(inputName)))
+		error("Could not open '%s'", inputName);
+
+	const uint32 size = in.size();
+	byte *data = new byte[size];
+	if (in.read(data, size) != size)
+		error("Could not read '%s'", inputName);
+	in.close();
+
+	Audio::MixerImpl *mixer = system->getMixerImpl();
+	MidiParser *parser = 0;
+	MidiDriver *driver = 0;
+	Audio::SoundHandle moduleHandle;
+
+	const uint32 tag = (size >= 4) ? READ_BE_UINT32(data) : 0;
+	if (tag == MKTAG('M', 'T', 'h', 'd') || tag == MKTAG('F', 'O', 'R', 'M')) {
+		driver = createDriver(driverId);
+
+		const int ret = driver->open();
+		if (ret)
+			error("Could not open music driver '%s': %s", driverId, MidiDriver::getErrorName(ret));
+
+		parser = (tag == MKTAG('F', 'O', 'R', 'M')) ? MidiParser::createParser_XMIDI() : MidiParser::createParser_SMF();
+		if (!parser->loadMusic(data, size))
+			error("'%s' is not a valid MIDI file", inputName);
+
+		parser->setMidiDriver(driver);
+		parser->setTimerRate(driver->getBaseTempo());
+		parser->property(MidiParser::mpAutoLoop, loop);
+		if (!parser->setTrack(track))
+			error("'%s' has no track %d", inputName, track);
+
+		driver->setTimerCallback(parser, &MidiParser::timerCallback);
+
+		printf("Rendering %s with %s...\n", inputName, driverId);
+	} else {
+		Common::MemoryReadStream stream(data, size);
+		Audio::AudioStream *module = Audio::makeProtrackerStream(&stream, 0, rate);
+		if (!module)
+			error("'%s' is neither a MIDI file nor a ProTracker module", inputName);
+
+		// ProTracker streams are Paula instances
+		if (bandLimited)
+			static_cast<Audio::Paula *>(module)->setBandLimited(true);
+
+		// The module player keeps its own copy of the song data
+		system->getMixer()->playStream(Audio::Mixer::kMusicSoundType, &moduleHandle, module);
+
+		printf("Rendering %s with the Paula emulator...\n", inputName);
+	}
+
+	FILE *out = 0;
+	if (outputName) {
+		out = fopen(outputName, "wb");
+		if (!out)
+			error("Could not create '%s'", outputName);
+		writeWaveHeader(out, rate, 0);
+	}
+
+	const uint32 totalFrames = seconds * rate;
+	int16 buffer[RENDER_CHUNK_FRAMES * 2];
+	uint32 renderedFrames = 0;
+	clock_t renderTime = 0;
+
+	while (renderedFrames < totalFrames) {
+		const uint frames = MIN<uint32>(RENDER_CHUNK_FRAMES, totalFrames - renderedFrames);
+
+		const clock_t start = clock();
+		mixer->mixCallback((byte *)buffer, frames * 4);
+		renderTime += clock() - start;
+
+		if (out) {
+			for (uint i = 0; i < frames * 2; ++i)
+				buffer[i] = TO_LE_16(buffer[i]);
+			fwrite(buffer, 4, frames, out);
+		}
+
+		renderedFrames += frames;
+
+		// Stop once the song is over, unless we are looping
+		if (parser ? !parser->isPlaying() : !mixer->isSoundHandleActive(moduleHandle))
+			break;
+	}
+
+	if (out) {
+		writeWaveHeader(out, rate, renderedFrames * 4);
+		fclose(out);
+	}
+
+	const double renderedSeconds = (double)renderedFrames / rate;
+	const double cpuSeconds = (double)renderTime / CLOCKS_PER_SEC;
+
+	printf("Rendered:        %.2f s of audio at %u Hz\n", renderedSeconds, rate);
+	printf("Time taken:      %.3f s\n", cpuSeconds);
+	if (cpuSeconds > 0)
+		printf("Realtime factor: %.1fx\n", renderedSeconds / cpuSeconds);
+
+	if (parser) {
+		parser->unloadMusic();
+		delete parser;
+	}
+
+	if (driver) {
+		driver->setTimerCallback(0, 0);
+		driver->close();
+		delete driver;
+	}
+
+	mixer->stopAll();
+	delete[] data;
+	delete system;
+	g_system = 0;
+
+	return 0;
+}
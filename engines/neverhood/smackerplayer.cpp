@@ -83,19 +83,8 @@ void NeverhoodSmackerDecoder::forceSeekToFrame(uint frame) {
 	if (frame >= getFrameCount())
 		error("Can't force Smacker seek to invalid frame %d", frame);
 	
-	if (_header.audioInfo[0].hasAudio)
-		error("Can't force Smacker frame seek with audio");
-	if (!rewind())
-		error("Failed to rewind");
-	
-	SmackerVideoTrack *videoTrack = (SmackerVideoTrack *)getTrack(0);
-	uint32 offset = 0;
-	for (uint32 i = 0; i < frame; i++) {
-		videoTrack->increaseCurFrame();
-		offset += _frameSizes[i] & ~3;
-	}
-	
-	_fileStream->seek(offset, SEEK_CUR);
+	if (!seekToFrame(frame))
+		error("Failed to seek to frame %d", frame);
 }
 
 // SmackerPlayer
@@ -125,6 +125,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("set_palette",		WRAP_METHOD(Console, cmdSetPalette));
 	DCmd_Register("draw_pic",			WRAP_METHOD(Console, cmdDrawPic));
 	DCmd_Register("draw_cel",			WRAP_METHOD(Console, cmdDrawCel));
+	DCmd_Register("verify_pic_cache",	WRAP_METHOD(Console, cmdVerifyPicCache));
 	DCmd_Register("undither",           WRAP_METHOD(Console, cmdUndither));
 	DCmd_Register("pic_visualize",		WRAP_METHOD(Console, cmdPicVisualize));
 	DCmd_Register("play_video",         WRAP_METHOD(Console, cmdPlayVideo));
@@ -151,6 +152,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	DCmd_Register("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	DCmd_Register("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	DCmd_Register("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	DCmd_Register("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	DCmd_Register("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -206,6 +208,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	DCmd_Register("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	DCmd_Register("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	DCmd_Register("vm_varlist",			WRAP_METHOD(Console, cmdVMVarlist));
 	DCmd_Register("vmvarlist",			WRAP_METHOD(Console, cmdVMVarlist));				// alias
 	DCmd_Register("vl",					WRAP_METHOD(Console, cmdVMVarlist));				// alias
@@ -237,11 +240,16 @@ Console::~Console() {
 
 void Console::preEnter() {
 	_engine->pauseEngine(true);
+	if (_engine->_gamestate)
+		_engine->_gamestate->pauseActivityTiming(true);
 }
 
 extern void playVideo(Video::VideoDecoder *videoDecoder, VideoState videoState);
 
 void Console::postEnter() {
+	if (_engine->_gamestate)
+		_engine->_gamestate->pauseActivityTiming(false);
+
 	if (!_videoFile.empty()) {
 		Video::VideoDecoder *videoDecoder = 0;
 
@@ -366,6 +374,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" set_palette - Sets a palette resource\n");
 	DebugPrintf(" draw_pic - Draws a pic resource\n");
 	DebugPrintf(" draw_cel - Draws a cel from a view resource\n");
+	DebugPrintf(" verify_pic_cache - Checks that pictures drawn from the cache look the same as fresh ones\n");
 	DebugPrintf(" pic_visualize - Enables visualization of the drawing process of EGA pictures\n");
 	DebugPrintf(" undither - Enable/disable undithering\n");
 	DebugPrintf(" play_video - Plays a SEQ, AVI, VMD, RBT or DUK video\n");
@@ -387,6 +396,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	DebugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	DebugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	DebugPrintf(" gc_stats - Shows how often and how long the garbage collector ran\n");
 	DebugPrintf("\n");
 	DebugPrintf("Music/SFX:\n");
 	DebugPrintf(" songlib - Shows the song library\n");
@@ -427,7 +437,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" bp_function / bpe - Sets a breakpoint on the execution of the specified exported function\n");
 	DebugPrintf("\n");
 	DebugPrintf("VM:\n");
-	DebugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	DebugPrintf(" script_steps - Shows the number of executed SCI operations, 'timing' measures their speed\n");
+	DebugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache\n");
 	DebugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	DebugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	DebugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -1530,6 +1541,55 @@ bool Console::cmdDrawPic(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdVerifyPicCache(int argc, const char **argv) {
+	if (!_engine->_gfxPaint16) {
+		DebugPrintf("Command not available for this SCI version\n");
+		return true;
+	}
+
+	Common::List<ResourceId> resources;
+	if (argc > 1)
+		resources.push_back(ResourceId(kResourceTypePic, atoi(argv[1])));
+	else
+		resources = _engine->getResMan()->listResources(kResourceTypePic);
+
+	const Common::Rect screenRect(_engine->_gfxScreen->getWidth(), _engine->_gfxScreen->getHeight());
+	const int size = _engine->_gfxScreen->bitsGetDataSize(screenRect, GFX_SCREEN_MASK_ALL);
+	byte *freshBits = new byte[size];
+	byte *cachedBits = new byte[size];
+	int verified = 0, mismatches = 0;
+
+	for (Common::List<ResourceId>::iterator it = resources.begin(); it != resources.end(); ++it) {
+		const uint16 pictureId = it->getNumber();
+		_engine->_gfxCache->purgePictureRenderCache();
+
+		// Draw the picture from its resource...
+		_engine->_gfxPaint16->debugSetPictureCache(false);
+		_engine->_gfxPaint->kernelDrawPicture(pictureId, 100, false, false, false, 0);
+		_engine->_gfxScreen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, freshBits);
+
+		// ...and again from the cache, which is filled by the first draw
+		_engine->_gfxPaint16->debugSetPictureCache(true);
+		_engine->_gfxPaint->kernelDrawPicture(pictureId, 100, false, false, false, 0);
+		if (!_engine->_gfxCache->getPictureRenderCount())
+			continue; // not a vector picture
+		_engine->_gfxPaint->kernelDrawPicture(pictureId, 100, false, false, false, 0);
+		_engine->_gfxScreen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, cachedBits);
+
+		verified++;
+		if (memcmp(freshBits, cachedBits, size)) {
+			DebugPrintf("Picture %d differs when drawn from the cache\n", pictureId);
+			mismatches++;
+		}
+	}
+
+	DebugPrintf("Verified %d pictures, %d mismatches\n", verified, mismatches);
+
+	delete[] freshBits;
+	delete[] cachedBits;
+	return true;
+}
+
 bool Console::cmdDrawCel(int argc, const char **argv) {
 	if (argc < 4) {
 		DebugPrintf("Draws a cel from a view resource\n");
@@ -2237,6 +2297,18 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	const GCStatistics &stats = _engine->_gamestate->_gcStats;
+
+	DebugPrintf("Collections: %u, skipped: %u, sweep steps: %u, objects freed: %u\n",
+	            stats.runs, stats.skipped, stats.sweepSteps, stats.freed);
+	DebugPrintf("Time spent: %u ms in total, %u ms of it marking, %u ms at most, %u ms in the last pause\n",
+	            stats.totalTime, stats.markTime, stats.maxTime, stats.lastTime);
+	DebugPrintf("Objects waiting to be freed: %u\n", _engine->_gamestate->_gcGarbage.size());
+	DebugPrintf("Allocations since the last collection: %u\n", _engine->_gamestate->_segMan->getAllocationsSinceGC());
+	return true;
+}
+
 bool Console::cmdGCObjects(int argc, const char **argv) {
 	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
 
@@ -2706,7 +2778,56 @@ bool Console::cmdViewAccumulatorObject(int argc, const char **argv) {
 }
 
 bool Console::cmdScriptSteps(int argc, const char **argv) {
-	DebugPrintf("Number of executed SCI operations: %d\n", _engine->_gamestate->scriptStepCounter);
+	EngineState *s = _engine->_gamestate;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "timing")) {
+		s->setActivityTiming(!s->_activityTiming);
+		DebugPrintf("Timing of the VM is %s\n", s->_activityTiming ? "on, starting a new measurement" : "off");
+		return true;
+	} else if (argc != 1) {
+		DebugPrintf("Shows the number of executed SCI operations\n");
+		DebugPrintf("Usage: %s [timing]\n", argv[0]);
+		DebugPrintf("With 'timing', toggles measuring the time spent in scripts and kernel calls\n");
+		return true;
+	}
+
+	DebugPrintf("Number of executed SCI operations: %d\n", s->scriptStepCounter);
+	if (s->_activityTiming) {
+		// The time up to the opening of the debugger has been charged
+		DebugPrintf("Since timing was enabled: %d operations, %u ms in scripts, %u ms in kernel calls\n",
+		            s->scriptStepCounter - s->_activityTimingSteps,
+		            s->_activityTime[EngineState::kTimedScript], s->_activityTime[EngineState::kTimedKernel]);
+		DebugPrintf("Operations per second: %u\n", s->getOperationsPerSecond());
+	}
+	return true;
+}
+
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		cache.resetCounters();
+		DebugPrintf("Selector lookup cache counters reset\n");
+		return true;
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "check")) {
+		uint lookups;
+		const uint differences = checkSelectorLookupCache(_engine->_gamestate->_segMan, lookups);
+		DebugPrintf("%u of %u cached lookups differ from uncached ones\n", differences, lookups);
+		return true;
+	} else if (argc != 1) {
+		DebugPrintf("Shows the hit rate of the selector lookup cache.\n");
+		DebugPrintf("Usage: %s [reset|check]\n", argv[0]);
+		DebugPrintf("reset: resets the hit counters\n");
+		DebugPrintf("check: looks up every selector of every object, and compares the cached results with uncached lookups\n");
+		return true;
+	}
+
+	const uint32 hits = cache.getHits();
+	const uint32 lookups = hits + cache.getMisses();
+	DebugPrintf("%u entries, %u hits in %u lookups", cache.getSize(), hits, lookups);
+	if (lookups)
+		DebugPrintf(" (%d%%)", (int)((uint64)hits * 100 / lookups));
+	DebugPrintf("\n");
 	return true;
 }
 
@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 namespace Sci {
@@ -160,8 +161,43 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
+/**
+ * Tells whether unreachable objects in a segment of this type may be freed
+ * later on. Table entries which are unreachable can't be touched by the
+ * scripts anymore, and their slots aren't reused before they are freed.
+ * Scripts and dynamic memory are freed right away, as they release their
+ * segment, and hunks, as the graphics code frees hunks it holds on its own.
+ */
+static bool canDeferFreeing(SegmentType type) {
+	switch (type) {
+	case SEG_TYPE_CLONES:
+	case SEG_TYPE_LISTS:
+	case SEG_TYPE_NODES:
+#ifdef ENABLE_SCI32
+	case SEG_TYPE_ARRAY:
+	case SEG_TYPE_STRING:
+#endif
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void freeObject(SegManager *segMan, SegmentObj *mobj, reg_t addr) {
+	mobj->freeAtAddress(segMan, addr);
+	debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+}
+
+/**
+ * Finds all objects which aren't referenced from anywhere. Those which can
+ * be freed later on are appended to the pending garbage, the others are
+ * freed right away.
+ * @return the number of objects freed
+ */
+static uint32 markGarbage(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getUnrecordedMillis();
+	uint32 freed = 0;
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -182,20 +218,25 @@ void run_gc(EngineState *s) {
 		SegmentObj *mobj = heap[seg];
 
 		if (mobj != NULL) {
-#ifdef GC_DEBUG_CODE
 			const SegmentType type = mobj->getType();
+			const bool defer = canDeferFreeing(type);
+#ifdef GC_DEBUG_CODE
 			segnames[type] = segmentTypeNames[type];
 #endif
 
 			// Get a list of all deallocatable objects in this segment,
-			// then free any which are not referenced from somewhere.
+			// then collect any which are not referenced from somewhere.
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
-					mobj->freeAtAddress(segMan, addr);
-					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					if (defer) {
+						s->_gcGarbage.push_back(addr);
+					} else {
+						freeObject(segMan, mobj, addr);
+						freed++;
+					}
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
@@ -207,6 +248,13 @@ void run_gc(EngineState *s) {
 
 	delete activeRefs;
 
+	segMan->resetAllocationsSinceGC();
+
+	GCStatistics &stats = s->_gcStats;
+	stats.markTime += g_system->getUnrecordedMillis() - startTime;
+	stats.runs++;
+	debugC(kDebugLevelGC, "[GC] Found %u unreachable objects", freed + s->_gcGarbage.size());
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -214,6 +262,82 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	return freed;
+}
+
+/**
+ * Frees up to maxCount objects of the pending garbage, the most recently
+ * found first.
+ * @return the number of objects freed
+ */
+static uint32 sweepGarbage(EngineState *s, uint maxCount) {
+	SegManager *segMan = s->_segMan;
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	Common::Array<reg_t> &garbage = s->_gcGarbage;
+	uint32 freed = 0;
+
+	while (!garbage.empty() && freed < maxCount) {
+		const reg_t addr = garbage.back();
+		garbage.pop_back();
+
+		const SegmentId seg = addr.getSegment();
+		SegmentObj *mobj = seg < heap.size() ? heap[seg] : NULL;
+		if (mobj && mobj->isValidOffset(addr.getOffset())) {
+			freeObject(segMan, mobj, addr);
+			freed++;
+		}
+	}
+
+	return freed;
+}
+
+/** Adds a pause of the game caused by the gc to the statistics. */
+static void addGCPause(EngineState *s, uint32 startTime, uint32 freed) {
+	GCStatistics &stats = s->_gcStats;
+	stats.lastTime = g_system->getUnrecordedMillis() - startTime;
+	stats.totalTime += stats.lastTime;
+	stats.maxTime = MAX(stats.maxTime, stats.lastTime);
+	stats.freed += freed;
+	debugC(kDebugLevelGC, "[GC] Freed %u objects in %u ms, %u left", freed, stats.lastTime, s->_gcGarbage.size());
+}
+
+void run_gc(EngineState *s) {
+	const uint32 startTime = g_system->getUnrecordedMillis();
+
+	// Garbage found before is freed first, so the new search doesn't list
+	// it a second time.
+	uint32 freed = sweepGarbage(s, s->_gcGarbage.size());
+	freed += markGarbage(s);
+	freed += sweepGarbage(s, s->_gcGarbage.size());
+
+	addGCPause(s, startTime, freed);
+}
+
+void run_gc_step(EngineState *s) {
+	const uint32 startTime = g_system->getUnrecordedMillis();
+	uint32 freed = 0;
+
+	if (!s->_gcGarbage.empty()) {
+		s->_gcStats.sweepSteps++;
+	} else if (s->_segMan->getAllocationsSinceGC() >= GC_MIN_ALLOCATIONS) {
+		freed = markGarbage(s);
+	} else {
+		// Objects also turn into garbage when the scripts drop their last
+		// reference to them, but only allocations make the memory use grow.
+		// Skipping the search for garbage doesn't make the next one any
+		// shorter, it only saves the pauses which would free next to
+		// nothing.
+		s->_gcStats.skipped++;
+		return;
+	}
+
+	freed += sweepGarbage(s, GC_SWEEP_STEP);
+	addGCPause(s, startTime, freed);
+
+	// Come back soon for the rest of the garbage
+	if (!s->_gcGarbage.empty())
+		s->gcCountDown = GC_SWEEP_INTERVAL;
 }
 
 } // End of namespace Sci
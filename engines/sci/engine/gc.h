@@ -50,11 +50,26 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs garbage collection on the current system state, freeing all garbage
+ * at once
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
 
+/**
+ * Runs a step of the periodic garbage collection from the VM. While garbage
+ * found earlier is still waiting to be freed, frees the next GC_SWEEP_STEP
+ * objects of it. Otherwise, finds all garbage, unless hardly anything has
+ * been allocated since the last collection.
+ *
+ * Finding the garbage still stops the game for as long as it takes to mark
+ * all reachable objects: marking in steps would need a write barrier on
+ * every reg_t store. Objects which were unreachable stay unreachable, so
+ * freeing them can be spread out.
+ * @param s The state in which we should gc
+ */
+void run_gc_step(EngineState *s);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
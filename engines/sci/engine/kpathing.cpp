@@ -24,6 +24,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -111,10 +112,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in the vertex index
+	int idx;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		idx = -1;
 	}
 };
 
@@ -236,6 +241,13 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+// Bounding box of the vertices of a polygon, and where they are in the
+// vertex index
+struct PolygonBounds {
+	int first, last;
+	int16 left, top, right, bottom;
+};
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -257,6 +269,17 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Bounding boxes of the polygons with edges, to quickly rule out
+	// polygons which can't block a line of sight
+	Common::Array<PolygonBounds> _polygonBounds;
+
+	// Visibility of the polygon vertices, which are at the end of the vertex
+	// index. NULL if it can't be used for this search.
+	VisibilityGraph *_visibilityGraph;
+
+	// Set if merging the start or end point split up an edge
+	bool _edgeSplit;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -264,6 +287,8 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_visibilityGraph = NULL;
+		_edgeSplit = false;
 	}
 
 	~PathfindingState() {
@@ -660,44 +685,95 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 }
 
 /**
- * Returns a list of all vertices that are visible from a particular vertex.
+ * Determines whether a vertex is visible from another one.
  * @param s				the pathfinding state
- * @param vertex_cur	the vertex
- * @return list of vertices that are visible from vert
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to look at
+ * @return true if no polygon is in the way, false otherwise
  */
-static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
-	VertexList *visVerts = new VertexList();
+static bool is_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
+	const int16 left = MIN(vertex_cur->v.x, vertex->v.x);
+	const int16 right = MAX(vertex_cur->v.x, vertex->v.x);
+	const int16 top = MIN(vertex_cur->v.y, vertex->v.y);
+	const int16 bottom = MAX(vertex_cur->v.y, vertex->v.y);
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+	for (uint i = 0; i < s->_polygonBounds.size(); i++) {
+		const PolygonBounds &bounds = s->_polygonBounds[i];
+
+		// Edges of polygons away from the line can't intersect it
+		if (bounds.right < left || bounds.left > right || bounds.bottom < top || bounds.top > bottom)
 			continue;
 
 		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
+		for (int j = bounds.first; j < bounds.last; j++) {
 			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
 
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
+				// This edge won't properly intersect, so we continue
+				continue;
 			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
 		}
+	}
+
+	return true;
+}
 
-		if (j == s->vertices)
+/**
+ * Returns a list of all vertices that are visible from a particular vertex.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex
+ * @return list of vertices that are visible from vert
+ */
+static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
+	VertexList *visVerts = new VertexList();
+	VisibilityGraph *graph = s->_visibilityGraph;
+	const int graphStart = graph ? s->vertices - graph->size : s->vertices;
+
+	// The start and end points need to be checked every time
+	int i;
+	for (i = 0; i < graphStart; i++) {
+		Vertex *vertex = s->vertex_index[i];
+		if (is_visible(s, vertex_cur, vertex))
 			visVerts->push_front(vertex);
 	}
 
+	if (!graph)
+		return visVerts;
+
+	if (vertex_cur->idx < graphStart) {
+		for (; i < s->vertices; i++) {
+			Vertex *vertex = s->vertex_index[i];
+			if (is_visible(s, vertex_cur, vertex))
+				visVerts->push_front(vertex);
+		}
+		return visVerts;
+	}
+
+	const uint row = vertex_cur->idx - graphStart;
+	bool *visible = &graph->visible[row * graph->size];
+
+	if (!graph->known[row]) {
+		for (uint j = 0; j < graph->size; j++)
+			visible[j] = is_visible(s, vertex_cur, s->vertex_index[graphStart + j]);
+		graph->known[row] = true;
+	}
+
+	for (uint j = 0; j < graph->size; j++) {
+		if (visible[j])
+			visVerts->push_front(s->vertex_index[graphStart + j]);
+	}
+
 	return visVerts;
 }
 
@@ -1083,6 +1159,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 				if (between(vertex->v, next->v, v)) {
 					// Split edge by adding vertex
 					polygon->vertices.insertAfter(vertex, v_new);
+					s->_edgeSplit = true;
 					return v_new;
 				}
 			}
@@ -1192,10 +1269,12 @@ static void change_polygons_opt_0(PathfindingState *s) {
  *             (Common::Point) start: The start point
  *             (Common::Point) end: The end point
  *             (int) opt: Optimization level (0, 1 or 2)
+ *             (VisibilityGraphCache *) graphCache: Cache of visibility graphs
+ *                            to use, or NULL
  * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
  *                            NULL otherwise
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt, VisibilityGraphCache *graphCache) {
 	SegManager *segMan = s->_segMan;
 	Polygon *polygon;
 	int count = 0;
@@ -1276,6 +1355,24 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// The polygons are final now, except for the start and end points
+	Common::Array<int16> graphKey;
+	uint graphSize = 0;
+	if (graphCache) {
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			polygon = *it;
+			Vertex *vertex;
+
+			graphKey.push_back(polygon->type);
+			graphKey.push_back(polygon->vertices.size());
+			CLIST_FOREACH(vertex, &polygon->vertices) {
+				graphKey.push_back(vertex->v.x);
+				graphKey.push_back(vertex->v.y);
+				graphSize++;
+			}
+		}
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1290,15 +1387,37 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 
 	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
 		polygon = *it;
-		Vertex *vertex;
+		Vertex *vertex = polygon->vertices.first();
+
+		PolygonBounds bounds;
+		bounds.first = count;
+		bounds.left = bounds.right = vertex->v.x;
+		bounds.top = bounds.bottom = vertex->v.y;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->idx = count;
 			pf_s->vertex_index[count++] = vertex;
+
+			bounds.left = MIN(bounds.left, vertex->v.x);
+			bounds.right = MAX(bounds.right, vertex->v.x);
+			bounds.top = MIN(bounds.top, vertex->v.y);
+			bounds.bottom = MAX(bounds.bottom, vertex->v.y);
 		}
+
+		bounds.last = count;
+		if (VERTEX_HAS_EDGES(polygon->vertices.first()))
+			pf_s->_polygonBounds.push_back(bounds);
 	}
 
 	pf_s->vertices = count;
 
+	// Start and end points which didn't split up an edge are single-vertex
+	// polygons in front of the others, or existing vertices. Either way, the
+	// visibility of the polygon vertices among each other is the same as the
+	// last time this polygon set was seen.
+	if (graphCache && !pf_s->_edgeSplit)
+		pf_s->_visibilityGraph = graphCache->getGraph(graphKey, graphSize);
+
 	return pf_s;
 }
 
@@ -1546,7 +1665,7 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 				g_system->delayMillis(2500);
 		}
 
-		PathfindingState *p = convert_polygon_set(s, poly_list, start, end, width, height, opt);
+		PathfindingState *p = convert_polygon_set(s, poly_list, start, end, width, height, opt, s->_visibilityGraphCache);
 
 		if (!p) {
 			warning("[avoidpath] Error: pathfinding failed for following input:\n");
@@ -1566,6 +1685,26 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 		// Apply Dijkstra
 		AStar(p);
 
+		if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath)) {
+			// Check that the cached visibility graph leads to the same path
+			PathfindingState *check = convert_polygon_set(s, poly_list, start, end, width, height, opt, NULL);
+			if (check) {
+				AStar(check);
+
+				Vertex *vertex = p->vertex_end;
+				Vertex *checkVertex = check->vertex_end;
+				while (vertex && checkVertex && vertex->v == checkVertex->v) {
+					vertex = vertex->path_prev;
+					checkVertex = checkVertex->path_prev;
+				}
+
+				if (vertex || checkVertex)
+					warning("[avoidpath] Path differs from the one found without the visibility graph cache");
+
+				delete check;
+			}
+		}
+
 		output = output_path(p, s);
 		delete p;
 
@@ -1579,6 +1718,44 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	}
 }
 
+VisibilityGraphCache::~VisibilityGraphCache() {
+	clear();
+}
+
+VisibilityGraph *VisibilityGraphCache::getGraph(const Common::Array<int16> &key, uint size) {
+	for (Common::List<VisibilityGraph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it) {
+		VisibilityGraph *graph = *it;
+		if (graph->size == size && graph->key == key) {
+			_graphs.erase(it);
+			_graphs.push_front(graph);
+			return graph;
+		}
+	}
+
+	if (_graphs.size() >= kMaxGraphs) {
+		delete _graphs.back();
+		_graphs.pop_back();
+	}
+
+	VisibilityGraph *graph = new VisibilityGraph();
+	graph->key = key;
+	graph->size = size;
+	graph->known.resize(size);
+	graph->visible.resize(size * size);
+	for (uint i = 0; i < size; i++)
+		graph->known[i] = false;
+
+	_graphs.push_front(graph);
+	return graph;
+}
+
+void VisibilityGraphCache::clear() {
+	for (Common::List<VisibilityGraph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it)
+		delete *it;
+
+	_graphs.clear();
+}
+
 static bool PointInRect(const Common::Point &point, int16 rectX1, int16 rectY1, int16 rectX2, int16 rectY2) {
 	int16 top = MIN<int16>(rectY1, rectY2);
 	int16 left = MIN<int16>(rectX1, rectX2);
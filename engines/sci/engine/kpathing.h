@@ -0,0 +1,70 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/list.h"
+
+namespace Sci {
+
+/**
+ * Which vertices of a polygon set can see each other. Rooms keep their
+ * polygons for many kAvoidPath calls while only the start and end points
+ * change, so this is worked out once per polygon set. Rows are filled in
+ * as the path search reaches the vertices.
+ */
+struct VisibilityGraph {
+	Common::Array<int16> key; ///< the types and points of the polygons
+	uint size; ///< the number of polygon vertices
+	Common::Array<bool> known; ///< whether a vertex' row has been filled in
+	Common::Array<bool> visible; ///< size * size entries
+};
+
+/**
+ * Keeps the visibility graphs of the polygon sets used last.
+ */
+class VisibilityGraphCache {
+public:
+	VisibilityGraphCache() {}
+	~VisibilityGraphCache();
+
+	/**
+	 * Returns the graph for a polygon set, which is empty if the polygon set
+	 * hasn't been seen recently.
+	 */
+	VisibilityGraph *getGraph(const Common::Array<int16> &key, uint size);
+
+	void clear();
+
+private:
+	enum {
+		kMaxGraphs = 4
+	};
+
+	Common::List<VisibilityGraph *> _graphs; ///< most recently used first
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
@@ -63,6 +63,9 @@ void Script::freeScript() {
 	_lockers = 1;
 	_markedAsDeleted = false;
 	_objects.clear();
+
+	_instructionIndex.clear();
+	_instructions.clear();
 }
 
 void Script::load(int script_nr, ResourceManager *resMan) {
@@ -237,6 +240,32 @@ const Object *Script::getObject(uint16 offset) const {
 		return 0;
 }
 
+const PMachineInstruction &Script::getInstruction(uint32 offset) {
+	assert(offset < _bufSize);
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_bufSize);
+
+	const uint16 index = _instructionIndex[offset];
+	if (index)
+		return _instructions[index - 1];
+
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(_buf + offset, instruction.extOpcode, instruction.params);
+
+	// The index has to fit into 16 bits. No script comes anywhere near
+	// this, but should one, its remaining instructions are simply decoded
+	// every time.
+	if (_instructions.size() >= 0xFFFF) {
+		_uncachedInstruction = instruction;
+		return _uncachedInstruction;
+	}
+
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	return _instructions.back();
+}
+
 Object *Script::scriptObjInit(reg_t obj_pos, bool fullObjectInit) {
 	if (getSciVersion() < SCI_VERSION_1_1 && fullObjectInit)
 		obj_pos.incOffset(8);	// magic offset (SCRIPT_OBJECT_MAGIC_OFFSET)
@@ -74,6 +74,15 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * For each offset into the buffer, the index plus one of the decoded
+	 * instruction at that offset in _instructions, or 0 if the offset has
+	 * not been executed yet. Allocated when the script is first executed.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	PMachineInstruction _uncachedInstruction;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -122,6 +131,13 @@ public:
 	Object *getObject(uint16 offset);
 	const Object *getObject(uint16 offset) const;
 
+	/**
+	 * Return the instruction at the given offset with its operands decoded.
+	 * Each instruction is decoded only once, when it is first executed.
+	 * The returned reference is only valid until the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset);
+
 	/**
 	 * Initializes an object within the segment manager
 	 * @param obj_pos	Location (segment, offset) of the object. It must
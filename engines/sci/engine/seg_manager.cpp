@@ -24,6 +24,7 @@
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
+#include "sci/engine/kernel.h"
 
 namespace Sci {
 
@@ -78,6 +79,9 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	_selectorLookupCache.clear();
+	_allocationsSinceGC = 0;
 }
 
 void SegManager::initSysStrings() {
@@ -156,6 +160,8 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		// The cache refers to the objects in the script buffer
+		_selectorLookupCache.clear();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -382,6 +388,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	table = (HunkTable *)_heap[_hunksSegId];
 
 	offset = table->allocEntry();
+	_allocationsSinceGC++;
 
 	reg_t addr = make_reg(_hunksSegId, offset);
 	Hunk *h = &(table->_table[offset]);
@@ -417,6 +424,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 		table = (CloneTable *)_heap[_clonesSegId];
 
 	offset = table->allocEntry();
+	_allocationsSinceGC++;
 
 	*addr = make_reg(_clonesSegId, offset);
 	return &(table->_table[offset]);
@@ -431,6 +439,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	table = (ListTable *)_heap[_listsSegId];
 
 	offset = table->allocEntry();
+	_allocationsSinceGC++;
 
 	*addr = make_reg(_listsSegId, offset);
 	return &(table->_table[offset]);
@@ -445,6 +454,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	table = (NodeTable *)_heap[_nodesSegId];
 
 	offset = table->allocEntry();
+	_allocationsSinceGC++;
 
 	*addr = make_reg(_nodesSegId, offset);
 	return &(table->_table[offset]);
@@ -848,6 +858,7 @@ SciArray<reg_t> *SegManager::allocateArray(reg_t *addr) {
 		table = (ArrayTable *)_heap[_arraysSegId];
 
 	offset = table->allocEntry();
+	_allocationsSinceGC++;
 
 	*addr = make_reg(_arraysSegId, offset);
 	return &(table->_table[offset]);
@@ -888,6 +899,7 @@ SciString *SegManager::allocateString(reg_t *addr) {
 		table = (StringTable *)_heap[_stringSegId];
 
 	offset = table->allocEntry();
+	_allocationsSinceGC++;
 
 	*addr = make_reg(_stringSegId, offset);
 	return &(table->_table[offset]);
@@ -977,14 +989,56 @@ int SegManager::instantiateScript(int scriptNum) {
 		scr = allocateScript(scriptNum, &segmentId);
 	}
 
+	_selectorLookupCache.clear();
+	_allocationsSinceGC++;
+
 	scr->load(scriptNum, _resMan);
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
 	scr->initializeObjects(this, segmentId);
 
+	queueScriptPrefetch(scriptNum, scr);
+
 	return segmentId;
 }
 
+void SegManager::queueScriptPrefetch(int scriptNum, Script *scr) {
+	// Selectors are mapped when the kernel is created
+	if (!g_sci || !g_sci->getKernel())
+		return;
+
+	// Rooms usually share their number with their picture and messages
+	_resMan->queuePrefetch(ResourceId(kResourceTypePic, scriptNum));
+	_resMan->queuePrefetch(ResourceId(kResourceTypeMessage, scriptNum));
+
+	const Selector viewSelector = SELECTOR(view);
+	const Selector pictureSelector = SELECTOR(picture);
+
+	const ObjMap &objects = scr->getObjectMap();
+	for (ObjMap::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+		const Object &obj = it->_value;
+
+		// Looking up variables needs the class, whose script may not be
+		// loaded yet
+		if (getSciVersion() <= SCI_VERSION_2_1 && !obj.getClass(this))
+			continue;
+
+		int index = obj.locateVarSelector(this, viewSelector);
+		if (index >= 0) {
+			const reg_t value = obj.getVariable(index);
+			if (value.isNumber() && value.getOffset() != 0xFFFF)
+				_resMan->queuePrefetch(ResourceId(kResourceTypeView, value.getOffset()));
+		}
+
+		index = obj.locateVarSelector(this, pictureSelector);
+		if (index >= 0) {
+			const reg_t value = obj.getVariable(index);
+			if (value.isNumber() && value.getOffset() != 0xFFFF)
+				_resMan->queuePrefetch(ResourceId(kResourceTypePic, value.getOffset()));
+		}
+	}
+}
+
 void SegManager::uninstantiateScript(int script_nr) {
 	SegmentId segmentId = getScriptSegment(script_nr);
 	Script *scr = getScriptIfLoaded(segmentId);
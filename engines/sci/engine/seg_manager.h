@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
+#include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/segment.h"
@@ -123,6 +124,13 @@ public:
 private:
 	void uninstantiateScriptSci0(int script_nr);
 
+	/**
+	 * Queues the resources a freshly loaded script is likely to need soon
+	 * for prefetching: the picture and messages sharing the script's number,
+	 * and the views and pictures its objects refer to.
+	 */
+	void queueScriptPrefetch(int script_nr, Script *scr);
+
 public:
 	// TODO: document this
 	reg_t getClassAddress(int classnr, ScriptLoadType lock, uint16 callerSegment);
@@ -441,6 +449,16 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Return the number of clones, lists, nodes, hunks etc. allocated since
+	 * the last garbage collection.
+	 */
+	uint32 getAllocationsSinceGC() const { return _allocationsSinceGC; }
+	void resetAllocationsSinceGC() { _allocationsSinceGC = 0; }
+
+	/** Return the cache of the results of lookupSelector(). */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -454,6 +472,9 @@ private:
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
 	SegmentId _hunksSegId; ///< ID of the (a) hunk segment
 
+	SelectorLookupCache _selectorLookupCache;
+	uint32 _allocationsSinceGC;
+
 	// Statically allocated memory for system strings
 	reg_t _saveDirPtr;
 	reg_t _parserPtr;
@@ -250,9 +250,60 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+bool SelectorLookupCache::lookup(const Object *obj, Selector selectorId, Result &result) {
+	Key key;
+	key.pos = obj->getPos();
+	key.superClass = obj->getSuperClassSelector();
+	key.selectorId = selectorId;
+
+	Common::HashMap<Key, Entry, Key_Hash>::const_iterator i = _entries.find(key);
+	if (i == _entries.end() || i->_value.species != obj->getSpeciesSelector()) {
+		_misses++;
+		return false;
+	}
+
+	_hits++;
+	result = i->_value.result;
+	return true;
+}
+
+void SelectorLookupCache::store(const Object *obj, Selector selectorId, const Result &result) {
+	Key key;
+	key.pos = obj->getPos();
+	key.superClass = obj->getSuperClassSelector();
+	key.selectorId = selectorId;
+
+	Entry &entry = _entries[key];
+	entry.species = obj->getSpeciesSelector();
+	entry.result = result;
+}
+
+static void lookupSelectorUncached(SegManager *segMan, const Object *obj, Selector selectorId, SelectorLookupCache::Result &result) {
+	result.varIndex = obj->locateVarSelector(segMan, selectorId);
+
+	if (result.varIndex >= 0) {
+		// Found it as a variable
+		result.type = kSelectorVariable;
+		return;
+	}
+
+	// Check if it's a method, with recursive lookup in superclasses
+	while (obj) {
+		const int index = obj->funcSelectorPosition(selectorId);
+		if (index >= 0) {
+			result.type = kSelectorMethod;
+			result.funcp = obj->getFunction(index);
+			return;
+		}
+
+		obj = segMan->getObject(obj->getSuperClassSelector());
+	}
+
+	result.type = kSelectorNone;
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
-	int index;
 	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
 
 	// Early SCI versions used the LSB in the selector ID as a read/write
@@ -265,34 +316,85 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 				PRINT_REG(obj_location));
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	SelectorLookupCache::Result result;
+	if (!cache.lookup(obj, selectorId, result)) {
+		lookupSelectorUncached(segMan, obj, selectorId, result);
+		cache.store(obj, selectorId, result);
+	}
 
-	if (index >= 0) {
-		// Found it as a variable
+	if (result.type == kSelectorVariable) {
 		if (varp) {
 			varp->obj = obj_location;
-			varp->varindex = index;
+			varp->varindex = result.varIndex;
 		}
-		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
+	} else if (result.type == kSelectorMethod) {
+		if (fptr)
+			*fptr = result.funcp;
+	}
+
+	return result.type;
+}
+
+uint checkSelectorLookupCache(SegManager *segMan, uint &lookups) {
+	// All objects, clones included
+	Common::Array<const Object *> objects;
+	for (uint i = 0; i < segMan->getSegments().size(); i++) {
+		const SegmentObj *mobj = segMan->getSegments()[i];
+		if (!mobj)
+			continue;
+
+		if (mobj->getType() == SEG_TYPE_SCRIPT) {
+			const ObjMap &objMap = ((const Script *)mobj)->getObjectMap();
+			for (ObjMap::const_iterator it = objMap.begin(); it != objMap.end(); ++it)
+				objects.push_back(&it->_value);
+		} else if (mobj->getType() == SEG_TYPE_CLONES) {
+			const CloneTable *ct = (const CloneTable *)mobj;
+			for (uint idx = 0; idx < ct->_table.size(); ++idx) {
+				if (ct->isValidEntry(idx))
+					objects.push_back(&ct->_table[idx]);
 			}
 		}
+	}
 
-		return kSelectorNone;
+	// Early SCI versions only use even selector IDs, see lookupSelector()
+	const uint selectorStep = (getSciVersion() == SCI_VERSION_0_EARLY) ? 2 : 1;
+	const uint selectorCount = g_sci->getKernel()->getSelectorNamesSize();
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+
+	// Fill the cache in the order of the objects, so that objects sharing
+	// entries with an earlier one get that one's results
+	for (uint i = 0; i < objects.size(); i++) {
+		for (uint selectorId = 0; selectorId < selectorCount; selectorId += selectorStep) {
+			SelectorLookupCache::Result result;
+			if (!cache.lookup(objects[i], selectorId, result)) {
+				lookupSelectorUncached(segMan, objects[i], selectorId, result);
+				cache.store(objects[i], selectorId, result);
+			}
+		}
 	}
 
+	uint differences = 0;
+	lookups = 0;
+	for (uint i = 0; i < objects.size(); i++) {
+		for (uint selectorId = 0; selectorId < selectorCount; selectorId += selectorStep) {
+			SelectorLookupCache::Result cached, uncached;
+			if (!cache.lookup(objects[i], selectorId, cached))
+				continue;
+			lookupSelectorUncached(segMan, objects[i], selectorId, uncached);
+			lookups++;
+
+			if (cached.type != uncached.type ||
+				(uncached.type == kSelectorVariable && cached.varIndex != uncached.varIndex) ||
+				(uncached.type == kSelectorMethod && cached.funcp != uncached.funcp)) {
+				debug("Selector %s of object %04x:%04x is cached wrongly",
+					g_sci->getKernel()->getSelectorName(selectorId).c_str(), PRINT_REG(objects[i]->getPos()));
+				differences++;
+			}
+		}
+	}
 
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return differences;
 }
 
 } // End of namespace Sci
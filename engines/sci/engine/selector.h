@@ -24,12 +24,15 @@
 #define SCI_ENGINE_SELECTOR_H
 
 #include "common/scummsys.h"
+#include "common/hashmap.h"
 
 #include "sci/engine/vm_types.h"	// for reg_t
 #include "sci/engine/vm.h"
 
 namespace Sci {
 
+class Object;
+
 /** Contains selector IDs for a few selected selectors */
 struct SelectorCache {
 	SelectorCache() {
@@ -185,6 +188,82 @@ reg_t readSelector(SegManager *segMan, reg_t object, Selector selectorId);
 void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t value);
 #define writeSelectorValue(segMan, _obj_, _slc_, _val_) writeSelector(segMan, _obj_, _slc_, make_reg(0, _val_))
 
+/**
+ * Remembers the results of lookupSelector(), which otherwise searches the
+ * variable selectors of the object's class and then the method tables of
+ * the object and all its superclasses on every message send.
+ *
+ * The entries are keyed on the position of the object in its script. An
+ * object, its clones and their clones all share that position, and thus
+ * the same entries, unless their superclass or species differs. The base
+ * object can't be used instead: before SCI1.1, all instances of a class
+ * share the base object of the class, but each has its own method table.
+ * The cache must be cleared whenever a script is loaded or unloaded.
+ */
+class SelectorLookupCache {
+public:
+	struct Result {
+		SelectorType type;
+		int varIndex;	///< The index of the variable, for kSelectorVariable
+		reg_t funcp;	///< The address of the method, for kSelectorMethod
+	};
+
+	SelectorLookupCache() : _hits(0), _misses(0) {}
+
+	/**
+	 * Look up the cached result for a selector of an object.
+	 * @return true if the result was cached
+	 */
+	bool lookup(const Object *obj, Selector selectorId, Result &result);
+
+	/** Cache the result for a selector of an object. */
+	void store(const Object *obj, Selector selectorId, const Result &result);
+
+	/** Forget all cached results. */
+	void clear() { _entries.clear(); }
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint getSize() const { return _entries.size(); }
+	void resetCounters() { _hits = _misses = 0; }
+
+private:
+	struct Key {
+		reg_t pos;
+		reg_t superClass;
+		Selector selectorId;
+
+		bool operator==(const Key &other) const {
+			return pos == other.pos && superClass == other.superClass && selectorId == other.selectorId;
+		}
+	};
+
+	struct Key_Hash {
+		uint operator()(const Key &x) const {
+			return (x.pos.getSegment() << 24) ^ x.pos.getOffset() ^ (x.superClass.getSegment() << 20) ^ (x.superClass.getOffset() << 4) ^ (x.selectorId << 16);
+		}
+	};
+
+	struct Entry {
+		reg_t species;
+		Result result;
+	};
+
+	Common::HashMap<Key, Entry, Key_Hash> _entries;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+/**
+ * Checks the selector lookup cache: looks up every selector of every object
+ * through the cache, and then compares each cached result with the result
+ * of an uncached lookup.
+ * @param segMan	the segment manager
+ * @param lookups	set to the number of lookups that were compared
+ * @return			the number of cached results that differ
+ */
+uint checkSelectorLookupCache(SegManager *segMan, uint &lookups);
+
 /**
  * Invokes a selector from an object.
  */
@@ -28,6 +28,7 @@
 
 #include "sci/engine/file.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -75,11 +76,17 @@ EngineState::EngineState(SegManager *segMan)
 #endif
 	_dirseeker() {
 
+	_activityTiming = false;
+	_activityTimingPaused = false;
+	_timedActivity = kTimedNone;
+	_timedActivityStart = 0;
+	_visibilityGraphCache = new VisibilityGraphCache();
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _visibilityGraphCache;
 #ifdef ENABLE_SCI32
 	delete _virtualIndexFile;
 #endif
@@ -104,6 +111,8 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	_gcGarbage.clear();
+	_gcStats.reset();
 
 	_throttleCounter = 0;
 	_throttleLastTime = 0;
@@ -119,6 +128,8 @@ void EngineState::reset(bool isRestoring) {
 
 	scriptStepCounter = 0;
 	scriptGCInterval = GC_INTERVAL;
+	_activityTime[kTimedScript] = _activityTime[kTimedKernel] = 0;
+	_activityTimingSteps = 0;
 
 	_videoState.reset();
 	_syncedAudioOptions = false;
@@ -129,6 +140,54 @@ void EngineState::reset(bool isRestoring) {
 	_palCycleToColor = 255;
 }
 
+void EngineState::chargeTimedActivity() {
+	const uint32 now = g_system->getUnrecordedMillis();
+	if (!_activityTimingPaused && _timedActivity != kTimedNone)
+		_activityTime[_timedActivity] += now - _timedActivityStart;
+	_timedActivityStart = now;
+}
+
+EngineState::TimedActivity EngineState::switchTimedActivity(TimedActivity activity) {
+	// The activity is always tracked, so that timing can be enabled at any
+	// point, but the clock is only read while measuring
+	if (_activityTiming)
+		chargeTimedActivity();
+
+	const TimedActivity previous = _timedActivity;
+	_timedActivity = activity;
+	return previous;
+}
+
+void EngineState::setActivityTiming(bool enable) {
+	if (enable == _activityTiming)
+		return;
+
+	if (enable) {
+		_activityTime[kTimedScript] = _activityTime[kTimedKernel] = 0;
+		_activityTimingSteps = scriptStepCounter;
+		_timedActivityStart = g_system->getUnrecordedMillis();
+	} else {
+		chargeTimedActivity();
+	}
+
+	_activityTiming = enable;
+}
+
+void EngineState::pauseActivityTiming(bool pause) {
+	if (_activityTiming)
+		chargeTimedActivity();
+
+	_activityTimingPaused = pause;
+}
+
+uint32 EngineState::getOperationsPerSecond() const {
+	const uint32 scriptTime = _activityTime[kTimedScript];
+	if (!scriptTime)
+		return 0;
+
+	return (uint32)((uint64)(uint32)(scriptStepCounter - _activityTimingSteps) * 1000 / scriptTime);
+}
+
 void EngineState::speedThrottler(uint32 neededSleep) {
 	if (_throttleTrigger) {
 		uint32 curTime = g_system->getMillis();
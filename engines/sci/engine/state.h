@@ -49,6 +49,7 @@ class EventManager;
 class MessageState;
 class SoundCommandParser;
 class VirtualIndexFile;
+class VisibilityGraphCache;
 
 enum AbortGameState {
 	kAbortNone = 0,
@@ -95,6 +96,23 @@ struct VideoState {
 	}
 };
 
+/** Statistics about the garbage collector, shown by the gc_stats console command */
+struct GCStatistics {
+	uint32 runs;		///< Number of collections, i.e. searches for garbage
+	uint32 skipped;		///< Number of periodic collections skipped
+	uint32 sweepSteps;	///< Number of periodic steps which only freed garbage
+	uint32 freed;		///< Number of objects freed
+	uint32 markTime;	///< Time spent finding the reachable objects in ms
+	uint32 totalTime;	///< Time spent collecting in ms
+	uint32 maxTime;		///< Duration of the longest pause in ms
+	uint32 lastTime;	///< Duration of the last pause in ms
+
+	void reset() {
+		runs = skipped = sweepSteps = freed = 0;
+		markTime = totalTime = maxTime = lastTime = 0;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -169,6 +187,44 @@ public:
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
 
+	// Time spent in the VM. Only measured while enabled by the script_steps
+	// console command or for a benchmark run, as OSystem::getUnrecordedMillis()
+	// is read on every switch.
+	enum TimedActivity {
+		kTimedNone = -1,
+		kTimedScript = 0,	// executing script code
+		kTimedKernel = 1	// in kernel calls, outside of nested script code
+	};
+	bool _activityTiming;
+	bool _activityTimingPaused;
+	uint32 _activityTime[2]; // in ms, indexed by TimedActivity
+	int _activityTimingSteps; // scriptStepCounter when the measurement started
+	TimedActivity _timedActivity;
+	uint32 _timedActivityStart;
+
+	/**
+	 * Switch to the given activity. While timing is enabled, the time since
+	 * the last switch is charged to the current activity first.
+	 * @return the previous activity
+	 */
+	TimedActivity switchTimedActivity(TimedActivity activity);
+
+	/**
+	 * Enable or disable measuring the time spent in the VM. Enabling it
+	 * starts a new measurement, which also restarts when the game is
+	 * restarted or restored.
+	 */
+	void setActivityTiming(bool enable);
+
+	/** Stop charging time while the debugger is open. */
+	void pauseActivityTiming(bool pause);
+
+	/** Return the operations executed per second of script time, 0 if not measured. */
+	uint32 getOperationsPerSecond() const;
+
+	/** Charge the time since the last switch to the current activity. */
+	void chargeTimedActivity();
+
 	uint16 currentRoomNumber() const;
 	void setRoomNumber(uint16 roomNumber);
 
@@ -184,9 +240,13 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	Common::Array<reg_t> _gcGarbage; /**< Unreachable objects the periodic gc has yet to free */
+	GCStatistics _gcStats;
 
 	MessageState *_msgState;
 
+	VisibilityGraphCache *_visibilityGraphCache; ///< kAvoidPath visibility graphs
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -209,6 +209,25 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 	}
 }
 
+/**
+ * Switches to the given activity until it goes out of scope, for the timing
+ * of the script_steps console command and of benchmark runs.
+ */
+class TimedActivityScope {
+public:
+	TimedActivityScope(EngineState *s, EngineState::TimedActivity activity) : _s(s) {
+		_previous = _s->switchTimedActivity(activity);
+	}
+
+	~TimedActivityScope() {
+		_s->switchTimedActivity(_previous);
+	}
+
+private:
+	EngineState *_s;
+	EngineState::TimedActivity _previous;
+};
+
 // Operating on the stack
 // 16 bit:
 #define PUSH(v) PUSH32(make_reg(0, v))
@@ -370,6 +389,8 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	}
 
 
+	TimedActivityScope timedActivity(s, EngineState::kTimedKernel);
+
 	// Call kernel function
 	if (!kernelCall.subFunctionCount) {
 		addKernelCallToExecStack(s, kernelCallNr, argc, argv);
@@ -531,6 +552,8 @@ int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4])
 void run_vm(EngineState *s) {
 	assert(s);
 
+	TimedActivityScope timedActivity(s, EngineState::kTimedScript);
+
 	int temp;
 	reg_t r_temp; // Temporary register
 	StackPtr s_temp; // Temporary stack pointer
@@ -615,9 +638,11 @@ void run_vm(EngineState *s) {
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
 		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		s->xs->addr.pc.incOffset(instruction.size);
+		const byte extOpcode = instruction.extOpcode;
 		const byte opcode = extOpcode >> 1;
+		memcpy(opparams, instruction.params, sizeof(opparams));
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
 #ifdef ABORT_ON_INFINITE_LOOP
@@ -841,7 +866,7 @@ void run_vm(EngineState *s) {
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				run_gc_step(s);
 			}
 
 			// Call kernel function
@@ -137,6 +137,25 @@ enum {
 	GC_INTERVAL = 0x8000
 };
 
+/**
+ * Minimum number of clones, lists, nodes etc. which have to be allocated
+ * before the periodic gc looks for garbage again. Memory use only grows
+ * through allocations, so while there were few of them, there is little
+ * point in stalling the game to reclaim memory.
+ */
+enum {
+	GC_MIN_ALLOCATIONS = 64
+};
+
+/**
+ * The periodic gc frees the garbage it found in steps of at most this many
+ * objects, GC_SWEEP_INTERVAL kernel calls apart, instead of all at once.
+ */
+enum {
+	GC_SWEEP_STEP = 128,
+	GC_SWEEP_INTERVAL = 64
+};
+
 enum SciOpcodes {
 	op_bnot     = 0x00,	// 000
 	op_add      = 0x01,	// 001
@@ -366,6 +385,16 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * A PMachine instruction with its operands already read, as returned by
+ * Script::getInstruction().
+ */
+struct PMachineInstruction {
+	byte extOpcode;		/**< The opcode, including the operand size bit */
+	uint16 size;		/**< The size of the instruction in bytes */
+	int16 params[4];	/**< The operands, see readPMachineInstruction() */
+};
+
 } // End of namespace Sci
 
 #endif // SCI_ENGINE_VM_H
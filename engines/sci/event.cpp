@@ -26,6 +26,7 @@
 
 #include "sci/sci.h"
 #include "sci/event.h"
+#include "sci/resource.h"
 #include "sci/console.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
@@ -333,7 +334,9 @@ void SciEngine::sleep(uint32 msecs) {
 		_eventMan->getSciEvent(SCI_EVENT_PEEK);
 		time = g_system->getMillis();
 		if (time + 10 < wakeup_time) {
-			g_system->delayMillis(10);
+			// Use the spare time to load resources ahead of their use
+			if (!_resMan->prefetchNext())
+				g_system->delayMillis(10);
 		} else {
 			if (time < wakeup_time)
 				g_system->delayMillis(wakeup_time - time);
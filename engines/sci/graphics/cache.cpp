@@ -30,17 +30,19 @@
 #include "sci/graphics/cache.h"
 #include "sci/graphics/font.h"
 #include "sci/graphics/fontsjis.h"
+#include "sci/graphics/picture.h"
 #include "sci/graphics/view.h"
 
 namespace Sci {
 
 GfxCache::GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette)
-	: _resMan(resMan), _screen(screen), _palette(palette) {
+	: _resMan(resMan), _screen(screen), _palette(palette), _viewUseCounter(0), _celMemory(0) {
 }
 
 GfxCache::~GfxCache() {
 	purgeFontCache();
 	purgeViewCache();
+	purgePictureRenderCache();
 }
 
 void GfxCache::purgeFontCache() {
@@ -54,13 +56,46 @@ void GfxCache::purgeFontCache() {
 
 void GfxCache::purgeViewCache() {
 	for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
-		delete iter->_value;
-		iter->_value = 0;
+		delete iter->_value.view;
+		iter->_value.view = 0;
 	}
 
 	_cachedViews.clear();
 }
 
+void GfxCache::purgeOldestView(GuiResourceId keepViewId) {
+	ViewCache::iterator oldest = _cachedViews.end();
+	for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
+		if (iter->_key != keepViewId && (oldest == _cachedViews.end() || iter->_value.lastUse < oldest->_value.lastUse))
+			oldest = iter;
+	}
+
+	if (oldest != _cachedViews.end()) {
+		delete oldest->_value.view;
+		_cachedViews.erase(oldest);
+	}
+}
+
+void GfxCache::purgeCelMemory(GuiResourceId keepViewId) {
+	while (_celMemory > MAX_CACHED_CEL_MEMORY) {
+		GfxView *oldest = 0;
+		uint32 oldestUse = 0;
+		for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
+			if (iter->_key != keepViewId && iter->_value.view->getBitmapSize() && (!oldest || iter->_value.lastUse < oldestUse)) {
+				oldest = iter->_value.view;
+				oldestUse = iter->_value.lastUse;
+			}
+		}
+
+		// Only the current view is left, which may exceed the budget on
+		// its own
+		if (!oldest)
+			break;
+
+		oldest->purgeBitmaps();
+	}
+}
+
 GfxFont *GfxCache::getFont(GuiResourceId fontId) {
 	if (_cachedFonts.size() >= MAX_CACHED_FONTS)
 		purgeFontCache();
@@ -77,13 +112,56 @@ GfxFont *GfxCache::getFont(GuiResourceId fontId) {
 }
 
 GfxView *GfxCache::getView(GuiResourceId viewId) {
-	if (_cachedViews.size() >= MAX_CACHED_VIEWS)
-		purgeViewCache();
+	ViewCache::iterator iter = _cachedViews.find(viewId);
+
+	if (iter == _cachedViews.end()) {
+		if (_cachedViews.size() >= MAX_CACHED_VIEWS)
+			purgeOldestView(viewId);
+
+		CachedView &cachedView = _cachedViews[viewId];
+		cachedView.view = new GfxView(_resMan, _screen, _palette, viewId, &_celMemory);
+		cachedView.lastUse = ++_viewUseCounter;
+		return cachedView.view;
+	}
+
+	iter->_value.lastUse = ++_viewUseCounter;
+
+	// Cels get unpacked when they are drawn, after the view has been looked
+	// up, so the budget is enforced on the next lookup
+	if (_celMemory > MAX_CACHED_CEL_MEMORY)
+		purgeCelMemory(viewId);
+
+	return iter->_value.view;
+}
+
+PictureRender *GfxCache::getPictureRender(GuiResourceId pictureId, bool mirroredFlag, int16 EGApaletteNo, const Common::Rect &rect, bool undithered) {
+	for (PictureRenderCache::iterator iter = _cachedPictureRenders.begin(); iter != _cachedPictureRenders.end(); ++iter) {
+		PictureRender *render = *iter;
+		if (render->pictureId == pictureId && render->mirroredFlag == mirroredFlag && render->EGApaletteNo == EGApaletteNo &&
+			render->rect == rect && render->undithered == undithered) {
+			_cachedPictureRenders.erase(iter);
+			_cachedPictureRenders.push_front(render);
+			return render;
+		}
+	}
+
+	return NULL;
+}
+
+void GfxCache::addPictureRender(PictureRender *render) {
+	while (_cachedPictureRenders.size() >= MAX_CACHED_PICTURE_RENDERS) {
+		delete _cachedPictureRenders.back();
+		_cachedPictureRenders.pop_back();
+	}
+
+	_cachedPictureRenders.push_front(render);
+}
 
-	if (!_cachedViews.contains(viewId))
-		_cachedViews[viewId] = new GfxView(_resMan, _screen, _palette, viewId);
+void GfxCache::purgePictureRenderCache() {
+	for (PictureRenderCache::iterator iter = _cachedPictureRenders.begin(); iter != _cachedPictureRenders.end(); ++iter)
+		delete *iter;
 
-	return _cachedViews[viewId];
+	_cachedPictureRenders.clear();
 }
 
 int16 GfxCache::kernelViewGetCelWidth(GuiResourceId viewId, int16 loopNo, int16 celNo) {
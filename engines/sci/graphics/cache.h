@@ -24,17 +24,27 @@
 #define SCI_GRAPHICS_CACHE_H
 
 #include "common/hashmap.h"
+#include "common/list.h"
+#include "common/rect.h"
 
 namespace Sci {
 
 class GfxFont;
 class GfxView;
+struct PictureRender;
 
 typedef Common::HashMap<int, GfxFont *> FontCache;
-typedef Common::HashMap<int, GfxView *> ViewCache;
+struct CachedView {
+	GfxView *view;
+	uint32 lastUse;
+};
+
+typedef Common::HashMap<int, CachedView> ViewCache;
+
+typedef Common::List<PictureRender *> PictureRenderCache;
 
 /**
- * Cache class, handles caching of views/fonts
+ * Cache class, handles caching of views/fonts and rendered pictures
  */
 class GfxCache {
 public:
@@ -51,16 +61,40 @@ public:
 
 	byte kernelViewGetColorAtCoordinate(GuiResourceId viewId, int16 loopNo, int16 celNo, int16 x, int16 y);
 
+	/**
+	 * Looks up a picture rendered onto a cleared screen.
+	 * @return the render, or NULL if the picture isn't cached
+	 */
+	PictureRender *getPictureRender(GuiResourceId pictureId, bool mirroredFlag, int16 EGApaletteNo, const Common::Rect &rect, bool undithered);
+	/** Adds a rendered picture to the cache, which takes ownership of it. */
+	void addPictureRender(PictureRender *render);
+	void purgePictureRenderCache();
+	uint getPictureRenderCount() const { return _cachedPictureRenders.size(); }
+
 private:
 	void purgeFontCache();
 	void purgeViewCache();
 
+	/** Deletes the least recently used view, except for the given one. */
+	void purgeOldestView(GuiResourceId keepViewId);
+
+	/**
+	 * Frees the unpacked cels of the least recently used views until the
+	 * budget is met again. The views themselves stay cached.
+	 */
+	void purgeCelMemory(GuiResourceId keepViewId);
+
 	ResourceManager *_resMan;
 	GfxScreen *_screen;
 	GfxPalette *_palette;
 
 	FontCache _cachedFonts;
+	PictureRenderCache _cachedPictureRenders; ///< most recently used first
 	ViewCache _cachedViews;
+	uint32 _viewUseCounter;
+
+	// Bytes taken up by the unpacked cels of all cached views
+	uint32 _celMemory;
 };
 
 } // End of namespace Sci
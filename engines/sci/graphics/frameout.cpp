@@ -525,6 +525,8 @@ void GfxFrameout::showVideo() {
 	uint16 x = videoDecoder->getPos().x;
 	uint16 y = videoDecoder->getPos().y;
 
+	_screen->invalidateLastFrame();
+
 	if (videoDecoder->hasDirtyPalette())
 		g_system->getPaletteManager()->setPalette(videoDecoder->getPalette(), 0, 256);
 
@@ -832,7 +834,9 @@ void GfxFrameout::kernelFrameout() {
 
 	showCurrentScrollText();
 
-	_screen->copyToScreen();
+	// All planes get redrawn each frame, but usually only small parts of the
+	// screen actually change
+	_screen->copyChangedToScreen();
 
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
@@ -34,6 +34,18 @@ namespace Sci {
 #define MAX_CACHED_CURSORS 10
 #define MAX_CACHED_FONTS 20
 #define MAX_CACHED_VIEWS 50
+#ifdef REDUCE_MEMORY_USAGE
+#define MAX_CACHED_PICTURE_RENDERS 2
+#else
+#define MAX_CACHED_PICTURE_RENDERS 8
+#endif
+
+// Bytes of unpacked view cels to keep around, shared by all cached views
+#ifdef REDUCE_MEMORY_USAGE
+#define MAX_CACHED_CEL_MEMORY (256 * 1024)
+#else
+#define MAX_CACHED_CEL_MEMORY (4 * 1024 * 1024)
+#endif
 
 #define SCI_SHAKE_DIRECTION_VERTICAL 1
 #define SCI_SHAKE_DIRECTION_HORIZONTAL 2
@@ -44,7 +44,7 @@ namespace Sci {
 GfxPaint16::GfxPaint16(ResourceManager *resMan, SegManager *segMan, GfxCache *cache, GfxPorts *ports, GfxCoordAdjuster *coordAdjuster, GfxScreen *screen, GfxPalette *palette, GfxTransitions *transitions, AudioPlayer *audio)
 	: _resMan(resMan), _segMan(segMan), _cache(cache), _ports(ports),
 	  _coordAdjuster(coordAdjuster), _screen(screen), _palette(palette),
-	  _transitions(transitions), _audio(audio), _EGAdrawingVisualize(false) {
+	  _transitions(transitions), _audio(audio), _EGAdrawingVisualize(false), _pictureCacheEnabled(true) {
 
 	// _animate and _text16 will be initialized later on
 	_animate = NULL;
@@ -63,6 +63,10 @@ void GfxPaint16::debugSetEGAdrawingVisualize(bool state) {
 	_EGAdrawingVisualize = state;
 }
 
+void GfxPaint16::debugSetPictureCache(bool state) {
+	_pictureCacheEnabled = state;
+}
+
 void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, bool addToFlag, GuiResourceId paletteId) {
 	GfxPicture *picture = new GfxPicture(_resMan, _coordAdjuster, _ports, _screen, _palette, pictureId, _EGAdrawingVisualize);
 
@@ -70,7 +74,33 @@ void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mi
 	if (!addToFlag)
 		clearScreen(_screen->getColorWhite());
 
-	picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	// Vector pictures, especially their flood fills, are slow to draw. When
+	// drawn onto a cleared screen they always look the same, so the result
+	// gets cached for when the room is entered again.
+	if (!addToFlag && !_EGAdrawingVisualize && _pictureCacheEnabled && picture->isVectorPicture()) {
+		Common::Rect rect = _ports->_curPort->rect;
+		_ports->offsetRect(rect);
+		rect.clip(_screen->getWidth(), _screen->getHeight());
+
+		const bool undithered = _screen->isUnditheringEnabled();
+		PictureRender *render = _cache->getPictureRender(pictureId, mirroredFlag, paletteId, rect, undithered);
+		if (render) {
+			picture->restoreRender(render);
+		} else {
+			picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+
+			render = new PictureRender();
+			render->pictureId = pictureId;
+			render->mirroredFlag = mirroredFlag;
+			render->EGApaletteNo = paletteId;
+			render->undithered = undithered;
+			render->rect = rect;
+			picture->saveRender(render);
+			_cache->addPictureRender(render);
+		}
+	} else {
+		picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	}
 	delete picture;
 
 	// We make a call to SciPalette here, for increasing sys timestamp and also loading targetpalette, if palvary active
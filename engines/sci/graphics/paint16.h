@@ -44,6 +44,7 @@ public:
 	void init(GfxAnimate *animate, GfxText16 *text16);
 
 	void debugSetEGAdrawingVisualize(bool state);
+	void debugSetPictureCache(bool state);
 
 	void drawPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, bool addToFlag, GuiResourceId paletteId);
 	void drawCelAndShow(GuiResourceId viewId, int16 loopNo, int16 celNo, uint16 leftPos, uint16 topPos, byte priority, uint16 paletteNo, uint16 scaleX = 128, uint16 scaleY = 128);
@@ -101,6 +102,9 @@ private:
 
 	// true means make EGA picture drawing visible
 	bool _EGAdrawingVisualize;
+
+	// false means always draw pictures from their resource
+	bool _pictureCacheEnabled;
 };
 
 } // End of namespace Sci
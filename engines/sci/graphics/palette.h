@@ -67,6 +67,7 @@ public:
 		return _remapOn && (_remappingType[color] != kRemappingNone);
 	}
 	byte remapColor(byte remappedColor, byte screenColor);
+	bool isRemapping() const { return _remapOn; }
 
 	void setOnScreen();
 	void copySysPaletteToScreen();
@@ -67,6 +67,7 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	_addToFlag = addToFlag;
 	_EGApaletteNo = EGApaletteNo;
 	_priority = 0;
+	_sideEffects.clear();
 
 	headerSize = READ_LE_UINT16(_resource->data);
 	switch (headerSize) {
@@ -87,6 +88,75 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	}
 }
 
+bool GfxPicture::isVectorPicture() const {
+	switch (READ_LE_UINT16(_resource->data)) {
+	case 0x26: // SCI 1.1 VGA picture
+#ifdef ENABLE_SCI32
+	case 0x0e: // SCI32 VGA picture
+#endif
+		return false;
+	default:
+		return true;
+	}
+}
+
+void GfxPicture::saveRender(PictureRender *render) {
+	const int size = _screen->bitsGetDataSize(render->rect, GFX_SCREEN_MASK_ALL);
+	render->bits = new byte[size];
+	_screen->bitsSave(render->rect, GFX_SCREEN_MASK_ALL, render->bits);
+
+	render->sideEffects = _sideEffects;
+
+	const int16 *ditheredPicColors = _screen->unditherGetDitheredBgColors();
+	render->ditheredPicColors.clear();
+	if (ditheredPicColors && _resMan->getViewType() == kViewEga)
+		render->ditheredPicColors.assign(ditheredPicColors, ditheredPicColors + DITHERED_BG_COLORS_SIZE);
+}
+
+void GfxPicture::restoreRender(const PictureRender *render) {
+	_screen->bitsRestore(render->bits);
+
+	for (uint i = 0; i < render->sideEffects.size(); i++)
+		applySideEffect(render->sideEffects[i]);
+
+	if (!render->ditheredPicColors.empty())
+		_screen->unditherSetDitheredBgColors(render->ditheredPicColors.begin());
+}
+
+void GfxPicture::vectorSideEffect(PictureSideEffectType type, int dataPos) {
+	PictureSideEffect effect;
+	effect.type = type;
+	effect.dataPos = dataPos;
+	_sideEffects.push_back(effect);
+
+	applySideEffect(effect);
+}
+
+void GfxPicture::applySideEffect(const PictureSideEffect &effect) {
+	byte *data = _resource->data + effect.dataPos;
+	Palette palette;
+
+	switch (effect.type) {
+	case kPictureSetPriorityBands:
+		_ports->priorityBandsInit(data);
+		break;
+	case kPictureSetPriorityBandsEqDist:
+		_ports->priorityBandsInit(-1, READ_LE_UINT16(data), READ_LE_UINT16(data + 2));
+		break;
+	case kPictureSetPalette:
+		memset(&palette, 0, sizeof(palette));
+		for (int i = 0; i < 256; i++) {
+			palette.colors[i].used = *data++;
+			palette.colors[i].r = *data++; palette.colors[i].g = *data++; palette.colors[i].b = *data++;
+		}
+		_palette->set(&palette, true);
+		break;
+	case kPictureModifyAmigaPalette:
+		_palette->modifyAmigaPalette(data);
+		break;
+	}
+}
+
 void GfxPicture::reset() {
 	int16 x, y;
 	for (y = _ports->getPort()->top; y < _screen->getHeight(); y++) {
@@ -742,7 +812,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					curPos += size;
 					break;
 				case PIC_OPX_EGA_SET_PRIORITY_TABLE:
-					_ports->priorityBandsInit(data + curPos);
+					vectorSideEffect(kPictureSetPriorityBands, data + curPos - _resource->data);
 					curPos += 14;
 					break;
 				default:
@@ -765,16 +835,13 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 							curPos += 256 + 4 + 1024;
 						} else {
 							// Setting half of the Amiga palette
-							_palette->modifyAmigaPalette(&data[curPos]);
+							vectorSideEffect(kPictureModifyAmigaPalette, data + curPos - _resource->data);
 							curPos += 32;
 						}
 					} else {
 						curPos += 256 + 4; // Skip over mapping and timestamp
-						for (i = 0; i < 256; i++) {
-							palette.colors[i].used = data[curPos++];
-							palette.colors[i].r = data[curPos++]; palette.colors[i].g = data[curPos++]; palette.colors[i].b = data[curPos++];
-						}
-						_palette->set(&palette, true);
+						vectorSideEffect(kPictureSetPalette, data + curPos - _resource->data);
+						curPos += 256 * 4;
 					}
 					break;
 				case PIC_OPX_VGA_EMBEDDED_VIEW: // draw cel
@@ -785,11 +852,11 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					curPos += size;
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EQDIST:
-					_ports->priorityBandsInit(-1, READ_LE_UINT16(data + curPos), READ_LE_UINT16(data + curPos + 2));
+					vectorSideEffect(kPictureSetPriorityBandsEqDist, data + curPos - _resource->data);
 					curPos += 4;
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EXPLICIT:
-					_ports->priorityBandsInit(data + curPos);
+					vectorSideEffect(kPictureSetPriorityBands, data + curPos - _resource->data);
 					curPos += 14;
 					break;
 				default:
@@ -23,6 +23,9 @@
 #ifndef SCI_GRAPHICS_PICTURE_H
 #define SCI_GRAPHICS_PICTURE_H
 
+#include "common/array.h"
+#include "common/rect.h"
+
 namespace Sci {
 
 #define SCI_PATTERN_CODE_RECTANGLE 0x10
@@ -39,6 +42,41 @@ class GfxPorts;
 class GfxScreen;
 class GfxPalette;
 
+/**
+ * Vector picture opcodes which change something besides the screen planes.
+ * They have to be replayed when a picture gets drawn from the cache.
+ */
+enum PictureSideEffectType {
+	kPictureSetPriorityBands,
+	kPictureSetPriorityBandsEqDist,
+	kPictureSetPalette,
+	kPictureModifyAmigaPalette
+};
+
+struct PictureSideEffect {
+	PictureSideEffectType type;
+	int dataPos; ///< position of the opcode's data within the resource
+};
+
+/**
+ * A vector picture fully rendered onto a cleared screen, see
+ * GfxPicture::saveRender() and GfxCache::getPictureRender()
+ */
+struct PictureRender {
+	GuiResourceId pictureId;
+	bool mirroredFlag;
+	int16 EGApaletteNo;
+	bool undithered;
+	Common::Rect rect; ///< the area of the screen covered by the picture port
+
+	byte *bits; ///< GfxScreen::bitsSave() data of rect
+	Common::Array<PictureSideEffect> sideEffects;
+	Common::Array<int16> ditheredPicColors;
+
+	PictureRender() : bits(0) {}
+	~PictureRender() { delete[] bits; }
+};
+
 /**
  * Picture class, handles loading and displaying of picture resources
  *  every picture resource has its own instance of this class
@@ -51,6 +89,18 @@ public:
 	GuiResourceId getResourceId();
 	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo);
 
+	/** Checks whether this is an SCI0/SCI1 vector picture. */
+	bool isVectorPicture() const;
+
+	/**
+	 * Stores the screen contents of render->rect and everything else the
+	 * last draw() changed in render.
+	 */
+	void saveRender(PictureRender *render);
+
+	/** Draws the picture from a render stored by saveRender(). */
+	void restoreRender(const PictureRender *render);
+
 #ifdef ENABLE_SCI32
 	int16 getSci32celCount();
 	int16 getSci32celY(int16 celNo);
@@ -79,6 +129,8 @@ private:
 	void vectorPatternTexturedBox(Common::Rect box, byte color, byte prio, byte control, byte texture);
 	void vectorPatternCircle(Common::Rect box, byte size, byte color, byte prio, byte control);
 	void vectorPatternTexturedCircle(Common::Rect box, byte size, byte color, byte prio, byte control, byte texture);
+	void vectorSideEffect(PictureSideEffectType type, int dataPos);
+	void applySideEffect(const PictureSideEffect &effect);
 
 	ResourceManager *_resMan;
 	GfxCoordAdjuster *_coordAdjuster;
@@ -98,6 +150,8 @@ private:
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
+
+	Common::Array<PictureSideEffect> _sideEffects;
 };
 
 } // End of namespace Sci
@@ -120,6 +120,9 @@ GfxScreen::GfxScreen(ResourceManager *resMan) : _resMan(resMan) {
 	// Sets display screen to be actually displayed
 	_activeScreen = _displayScreen;
 
+	_lastFrame = NULL;
+	_lastFrameValid = false;
+
 	_picNotValid = 0;
 	_picNotValidSci11 = 0;
 	_unditheringEnabled = true;
@@ -161,12 +164,58 @@ GfxScreen::~GfxScreen() {
 	free(_priorityScreen);
 	free(_controlScreen);
 	free(_displayScreen);
+	free(_lastFrame);
 }
 
 void GfxScreen::copyToScreen() {
+	_lastFrameValid = false;
 	g_system->copyRectToScreen(_activeScreen, _displayWidth, 0, 0, _displayWidth, _displayHeight);
 }
 
+void GfxScreen::copyChangedToScreen() {
+	if (!_lastFrame)
+		_lastFrame = (byte *)malloc(_displayPixels);
+
+	if (!_lastFrameValid) {
+		copyToScreen();
+		memcpy(_lastFrame, _activeScreen, _displayPixels);
+		_lastFrameValid = true;
+		return;
+	}
+
+	// Copy each run of changed lines, limited to the columns which changed
+	int top = -1, left = _displayWidth, right = 0;
+
+	for (int y = 0; y <= _displayHeight; y++) {
+		if (y < _displayHeight) {
+			const byte *line = _activeScreen + y * _displayWidth;
+			byte *lastLine = _lastFrame + y * _displayWidth;
+
+			if (memcmp(line, lastLine, _displayWidth)) {
+				int x1 = 0, x2 = _displayWidth;
+				while (line[x1] == lastLine[x1])
+					x1++;
+				while (line[x2 - 1] == lastLine[x2 - 1])
+					x2--;
+				memcpy(lastLine + x1, line + x1, x2 - x1);
+
+				left = MIN(left, x1);
+				right = MAX(right, x2);
+				if (top < 0)
+					top = y;
+				continue;
+			}
+		}
+
+		if (top >= 0) {
+			g_system->copyRectToScreen(_activeScreen + top * _displayWidth + left, _displayWidth, left, top, right - left, y - top);
+			top = -1;
+			left = _displayWidth;
+			right = 0;
+		}
+	}
+}
+
 void GfxScreen::copyFromScreen(byte *buffer) {
 	// TODO this ignores the pitch
 	Graphics::Surface *screen = g_system->lockScreen();
@@ -182,6 +231,7 @@ void GfxScreen::kernelSyncWithFramebuffer() {
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect) {
+	_lastFrameValid = false;
 	if (!_upscaledHires)  {
 		g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, rect.left, rect.top, rect.width(), rect.height());
 	} else {
@@ -195,12 +245,14 @@ void GfxScreen::copyRectToScreen(const Common::Rect &rect) {
  * used on hires graphics used in upscaled hires mode.
  */
 void GfxScreen::copyDisplayRectToScreen(const Common::Rect &rect) {
+	_lastFrameValid = false;
 	if (!_upscaledHires)
 		error("copyDisplayRectToScreen: not in upscaled hires mode");
 	g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, rect.left, rect.top, rect.width(), rect.height());
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect, int16 x, int16 y) {
+	_lastFrameValid = false;
 	if (!_upscaledHires)  {
 		g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, x, y, rect.width(), rect.height());
 	} else {
@@ -244,6 +296,54 @@ void GfxScreen::putPixel(int x, int y, byte drawMask, byte color, byte priority,
 		_controlScreen[offset] = control;
 }
 
+template<bool SCALED, bool WRITE_PRIORITY>
+static void drawCelRowPixels(byte *visual, byte *display, byte *priorityPlane, int16 width, const byte *row,
+							 const uint16 *columns, byte clearKey, const byte *colorMapping, byte priority) {
+	for (int16 i = 0; i < width; i++) {
+		const byte color = SCALED ? row[columns[i]] : row[i];
+		if (color != clearKey && priority >= priorityPlane[i]) {
+			visual[i] = display[i] = colorMapping[color];
+			if (WRITE_PRIORITY)
+				priorityPlane[i] = priority;
+		}
+	}
+}
+
+void GfxScreen::drawCelRow(int x, int y, int16 width, const byte *row, const uint16 *columns,
+						   byte clearKey, const byte *colorMapping, byte priority, byte drawMask) {
+	assert(drawMask & GFX_SCREEN_MASK_VISUAL);
+	assert(!(drawMask & GFX_SCREEN_MASK_CONTROL));
+
+	const int offset = y * _pitch + x;
+
+	if (_upscaledHires) {
+		// Every pixel covers several pixels on the display, leave that to
+		// putPixel()
+		for (int16 i = 0; i < width; i++) {
+			const byte color = columns ? row[columns[i]] : row[i];
+			if (color != clearKey && priority >= _priorityScreen[offset + i])
+				putPixel(x + i, y, drawMask, colorMapping[color], priority, 0);
+		}
+		return;
+	}
+
+	byte *visual = _visualScreen + offset;
+	byte *display = _displayScreen + offset;
+	byte *priorityPlane = _priorityScreen + offset;
+
+	if (drawMask & GFX_SCREEN_MASK_PRIORITY) {
+		if (columns)
+			drawCelRowPixels<true, true>(visual, display, priorityPlane, width, row, columns, clearKey, colorMapping, priority);
+		else
+			drawCelRowPixels<false, true>(visual, display, priorityPlane, width, row, columns, clearKey, colorMapping, priority);
+	} else {
+		if (columns)
+			drawCelRowPixels<true, false>(visual, display, priorityPlane, width, row, columns, clearKey, colorMapping, priority);
+		else
+			drawCelRowPixels<false, false>(visual, display, priorityPlane, width, row, columns, clearKey, colorMapping, priority);
+	}
+}
+
 /**
  * This is used to put font pixels onto the screen - we adjust differently, so that we won't
  *  do triple pixel lines in any case on upscaled hires. That way the font will not get distorted
@@ -646,6 +746,10 @@ int16 *GfxScreen::unditherGetDitheredBgColors() {
 		return NULL;
 }
 
+void GfxScreen::unditherSetDitheredBgColors(const int16 *colors) {
+	memcpy(_ditheredPicColors, colors, sizeof(_ditheredPicColors));
+}
+
 void GfxScreen::debugShowMap(int mapNo) {
 	// We cannot really support changing maps when in upscaledHires mode
 	if (_upscaledHires)
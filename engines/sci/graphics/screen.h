@@ -73,6 +73,19 @@ public:
 	byte getColorDefaultVectorData() { return _colorDefaultVectorData; }
 
 	void copyToScreen();
+
+	/**
+	 * Copies only the parts of the active screen that changed since the
+	 * last call. Everything is copied on the first call and after
+	 * invalidateLastFrame().
+	 */
+	void copyChangedToScreen();
+
+	/**
+	 * Has to be called whenever the backend screen gets changed without going
+	 * through copyChangedToScreen(), e.g. when playing videos.
+	 */
+	void invalidateLastFrame() { _lastFrameValid = false; }
 	void copyFromScreen(byte *buffer);
 	void kernelSyncWithFramebuffer();
 	void copyRectToScreen(const Common::Rect &rect);
@@ -83,6 +96,17 @@ public:
 	void putPixel(int x, int y, byte drawMask, byte color, byte prio, byte control);
 	void putFontPixel(int startingY, int x, int y, byte color);
 	void putPixelOnDisplay(int x, int y, byte color);
+
+	/**
+	 * Draws one row of a view cel, which is faster than calling putPixel()
+	 * for every pixel. Pixels matching clearKey are skipped, the others are
+	 * translated through colorMapping and drawn wherever priority is at least
+	 * the one already on screen.
+	 * @param columns	if set, pixel i is taken from row[columns[i]], which is
+	 *                  used for scaled cels
+	 */
+	void drawCelRow(int x, int y, int16 width, const byte *row, const uint16 *columns,
+	                byte clearKey, const byte *colorMapping, byte priority, byte drawMask);
 	void drawLine(Common::Point startPoint, Common::Point endPoint, byte color, byte prio, byte control);
 	void drawLine(int16 left, int16 top, int16 right, int16 bottom, byte color, byte prio, byte control) {
 		drawLine(Common::Point(left, top), Common::Point(right, bottom), color, prio, control);
@@ -118,6 +142,7 @@ public:
 	// Force a color combination as a dithered color
 	void ditherForceDitheredColor(byte color);
 	int16 *unditherGetDitheredBgColors();
+	void unditherSetDitheredBgColors(const int16 *colors);
 
 	void debugShowMap(int mapNo);
 
@@ -177,6 +202,13 @@ private:
 	 */
 	byte *_activeScreen;
 
+	/**
+	 * Copy of the active screen as of the last copyChangedToScreen() call,
+	 * i.e. what the backend is showing
+	 */
+	byte *_lastFrame;
+	bool _lastFrameValid;
+
 	/**
 	 * This variable defines, if upscaled hires is active and what upscaled mode
 	 * is used.
@@ -30,25 +30,36 @@
 
 namespace Sci {
 
-GfxView::GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId)
-	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId) {
+GfxView::GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, uint32 *celMemory)
+	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId), _bitmapSize(0), _celMemory(celMemory) {
 	assert(resourceId != -1);
 	_coordAdjuster = g_sci->_gfxCoordAdjuster;
 	initData(resourceId);
 }
 
 GfxView::~GfxView() {
+	purgeBitmaps();
+
+	for (uint16 loopNum = 0; loopNum < _loopCount; loopNum++)
+		delete[] _loop[loopNum].cel;
+	delete[] _loop;
+
+	_resMan->unlockResource(_resource);
+}
+
+void GfxView::purgeBitmaps() {
 	// Iterate through the loops
 	for (uint16 loopNum = 0; loopNum < _loopCount; loopNum++) {
 		// and through the cells of each loop
 		for (uint16 celNum = 0; celNum < _loop[loopNum].celCount; celNum++) {
 			delete[] _loop[loopNum].cel[celNum].rawBitmap;
+			_loop[loopNum].cel[celNum].rawBitmap = NULL;
 		}
-		delete[] _loop[loopNum].cel;
 	}
-	delete[] _loop;
 
-	_resMan->unlockResource(_resource);
+	if (_celMemory)
+		*_celMemory -= _bitmapSize;
+	_bitmapSize = 0;
 }
 
 static const byte EGAmappingStraight[SCI_VIEW_EGAMAPPING_SIZE] = {
@@ -592,6 +603,10 @@ const byte *GfxView::getBitmap(int16 loopNo, int16 celNo) {
 	_loop[loopNo].cel[celNo].rawBitmap = new byte[pixelCount];
 	byte *pBitmap = _loop[loopNo].cel[celNo].rawBitmap;
 
+	_bitmapSize += pixelCount;
+	if (_celMemory)
+		*_celMemory += pixelCount;
+
 	// unpack the actual cel bitmap data
 	unpackCel(loopNo, celNo, pBitmap, pixelCount);
 
@@ -733,7 +748,12 @@ void GfxView::draw(const Common::Rect &rect, const Common::Rect &clipRect, const
 	if (g_sci->getGameId() == GID_ECOQUEST && g_sci->getEngineState()->currentRoomNumber() == 440 && priority == 15)
 		priority = 14;
 
-	if (!_EGAmapping) {
+	if (!_EGAmapping && !upscaledHires && !_palette->isRemapping()) {
+		// Nothing needs per-pixel treatment, draw whole rows at once
+		for (y = 0; y < height; y++, bitmap += celWidth)
+			_screen->drawCelRow(clipRectTranslated.left, clipRectTranslated.top + y, width, bitmap, NULL,
+								clearKey, palette->mapping, priority, drawMask);
+	} else if (!_EGAmapping) {
 		for (y = 0; y < height; y++, bitmap += celWidth) {
 			for (x = 0; x < width; x++) {
 				const byte color = bitmap[x];
@@ -851,6 +871,15 @@ void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect,
 
 	assert(scaledHeight + offsetY <= ARRAYSIZE(scalingY));
 	assert(scaledWidth + offsetX <= ARRAYSIZE(scalingX));
+
+	if (!_palette->isRemapping()) {
+		for (int y = 0; y < scaledHeight; y++)
+			_screen->drawCelRow(clipRectTranslated.left, clipRectTranslated.top + y, scaledWidth,
+								bitmap + scalingY[y + offsetY] * celWidth, scalingX + offsetX,
+								clearKey, palette->mapping, priority, drawMask);
+		return;
+	}
+
 	for (int y = 0; y < scaledHeight; y++) {
 		for (int x = 0; x < scaledWidth; x++) {
 			const byte color = bitmap[scalingY[y + offsetY] * celWidth + scalingX[x + offsetX]];
@@ -62,7 +62,11 @@ class GfxPalette;
  */
 class GfxView {
 public:
-	GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId);
+	/**
+	 * @param celMemory	if set, the number of bytes taken up by unpacked cels
+	 *                  is added to and removed from this counter
+	 */
+	GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, uint32 *celMemory = NULL);
 	~GfxView();
 
 	GuiResourceId getResourceId() const;
@@ -73,6 +77,9 @@ public:
 	void getCelSpecialHoyle4Rect(int16 loopNo, int16 celNo, int16 x, int16 y, int16 z, Common::Rect &outRect) const;
 	void getCelScaledRect(int16 loopNo, int16 celNo, int16 x, int16 y, int16 z, int16 scaleX, int16 scaleY, Common::Rect &outRect) const;
 	const byte *getBitmap(int16 loopNo, int16 celNo);
+	uint32 getBitmapSize() const { return _bitmapSize; }
+	/** Frees all unpacked cels, they get unpacked again when drawn. */
+	void purgeBitmaps();
 	void draw(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated, int16 loopNo, int16 celNo, byte priority, uint16 EGAmappingNr, bool upscaledHires);
 	void drawScaled(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated, int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY);
 	uint16 getLoopCount() const { return _loopCount; }
@@ -118,6 +125,10 @@ private:
 	// this is not set for some views in laura bow 2 floppy and signals that the view shall never get scaled
 	//  even if scaleX/Y are set (inside kAnimate)
 	bool _isScaleable;
+
+	// Bytes taken up by the unpacked cels of this view
+	uint32 _bitmapSize;
+	uint32 *_celMemory;
 };
 
 } // End of namespace Sci
@@ -22,12 +22,15 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/md5.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
+#include "sci/resource_cache.h"
 #include "sci/resource_intern.h"
 #include "sci/util.h"
 
@@ -564,6 +567,9 @@ Common::SeekableReadStream *ResourceSource::getVolumeFile(ResourceManager *resMa
 }
 
 void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
+	if (resMan->loadFromDiskCache(res))
+		return;
+
 	Common::SeekableReadStream *fileStream = getVolumeFile(resMan, res);
 	if (!fileStream)
 		return;
@@ -884,13 +890,24 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager() {
+	_diskCache = NULL;
 }
 
 void ResourceManager::init(bool initFromFallbackDetector) {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_prefetchQueue.clear();
 	_resMap.clear();
+	delete _diskCache;
+	_diskCache = NULL;
+
+	_maxMemoryLRU = DEFAULT_MAX_MEMORY;
+	if (ConfMan.hasKey("sci_resource_cache_size")) {
+		const int cacheSize = ConfMan.getInt("sci_resource_cache_size");
+		if (cacheSize > 0)
+			_maxMemoryLRU = MIN<int>(cacheSize, MAX_CACHE_SIZE) * 1024;
+	}
 	_audioMapSCI1 = NULL;
 
 	// FIXME: put this in an Init() function, so that we can error out if detection fails completely
@@ -941,6 +958,9 @@ void ResourceManager::init(bool initFromFallbackDetector) {
 
 	debugC(1, kDebugLevelResMan, "resMan: Detected %s", getSciVersionDesc(getSciVersion()));
 
+	if (!initFromFallbackDetector)
+		openDiskCache();
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -972,6 +992,8 @@ void ResourceManager::init(bool initFromFallbackDetector) {
 }
 
 ResourceManager::~ResourceManager() {
+	delete _diskCache;
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -987,6 +1009,63 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+void ResourceManager::openDiskCache() {
+	if (!ConfMan.hasKey("sci_resource_disk_cache") || !ConfMan.getBool("sci_resource_disk_cache"))
+		return;
+
+	// The cache belongs to the game data whose resource map it was made
+	// from. Only the start of the map is hashed, like the detector does.
+	Common::String fingerprint;
+	for (Common::List<ResourceSource *>::iterator it = _sources.begin(); it != _sources.end(); ++it) {
+		if ((*it)->getSourceType() != kSourceExtMap)
+			continue;
+
+		Common::SeekableReadStream *fileStream = 0;
+		if ((*it)->_resourceFile) {
+			fileStream = (*it)->_resourceFile->createReadStream();
+		} else {
+			Common::File *file = new Common::File();
+			if (file->open((*it)->getLocationName()))
+				fileStream = file;
+			else
+				delete file;
+		}
+
+		if (fileStream) {
+			fingerprint = Common::computeStreamMD5AsString(*fileStream, 5000);
+			delete fileStream;
+		}
+		break;
+	}
+
+	// Games without a resource map only have patch files and resource forks,
+	// which aren't decompressed here
+	if (fingerprint.empty())
+		return;
+
+	_diskCache = new ResourceDiskCache(ConfMan.getActiveDomainName() + ".rescache", fingerprint);
+}
+
+bool ResourceManager::loadFromDiskCache(Resource *res) {
+	if (!_diskCache || res->_source->getSourceType() != kSourceVolume)
+		return false;
+
+	uint32 size;
+	byte *data = _diskCache->load(res->_id, res->_source->_volumeNumber, res->_fileOffset, size);
+	if (!data)
+		return false;
+
+	res->data = data;
+	res->size = size;
+	res->_status = kResStatusAllocated;
+	return true;
+}
+
+void ResourceManager::addToDiskCache(const Resource *res) {
+	if (_diskCache && res->_source->getSourceType() == kSourceVolume)
+		_diskCache->add(res->_id, res->_source->_volumeNumber, res->_fileOffset, res->data, res->size);
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
@@ -1030,7 +1109,7 @@ void ResourceManager::printLRU() {
 }
 
 void ResourceManager::freeOldResources() {
-	while (MAX_MEMORY < _memoryLRU) {
+	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
 		Resource *goner = *_LRU.reverse_begin();
 		removeFromLRU(goner);
@@ -1041,6 +1120,36 @@ void ResourceManager::freeOldResources() {
 	}
 }
 
+void ResourceManager::queuePrefetch(ResourceId id) {
+	Resource *res = testResource(id);
+	if (res && res->_status == kResStatusNoMalloc)
+		_prefetchQueue.push(id);
+}
+
+bool ResourceManager::prefetchNext() {
+	while (!_prefetchQueue.empty()) {
+		if (_memoryLRU >= _maxMemoryLRU) {
+			_prefetchQueue.clear();
+			return false;
+		}
+
+		Resource *res = testResource(_prefetchQueue.pop());
+
+		// The resource may have been loaded in the meantime
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadResource(res);
+		if (res->_status == kResStatusAllocated) {
+			addToLRU(res);
+			freeOldResources();
+		}
+		return true;
+	}
+
+	return false;
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -2007,6 +2116,8 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 	errorNum = data ? dec->unpack(file, data, szPacked, size) : SCI_ERROR_RESOURCE_TOO_BIG;
 	if (errorNum)
 		unalloc();
+	else if (compression != kCompNone)
+		_resMan->addToDiskCache(this);
 
 	delete dec;
 	return errorNum;
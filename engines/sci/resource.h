@@ -26,6 +26,7 @@
 #include "common/str.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/queue.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/decompressor.h"
@@ -131,6 +132,7 @@ enum ResVersion {
 
 class ResourceManager;
 class ResourceSource;
+class ResourceDiskCache;
 
 class ResourceId {
 	static inline ResourceType fixupType(ResourceType type) {
@@ -324,6 +326,35 @@ public:
 	 */
 	Common::List<ResourceId> listResources(ResourceType type, int mapNumber = -1);
 
+	/**
+	 * Queues a resource to be loaded ahead of its use, see prefetchNext().
+	 * Resources which don't exist are ignored.
+	 * @param id	Id of the resource to prefetch
+	 */
+	void queuePrefetch(ResourceId id);
+
+	/**
+	 * Loads the next queued resource which is not in memory yet and puts it
+	 * under LRU control. Nothing is loaded while the resource cache is full,
+	 * so prefetching never pushes out resources already in use.
+	 * Meant to be called while the engine is idle.
+	 * @return		true if a resource was loaded, false if there was nothing to do
+	 */
+	bool prefetchNext();
+
+	/** Drops all queued prefetch requests. */
+	void clearPrefetchQueue() { _prefetchQueue.clear(); }
+
+	/**
+	 * Loads a resource from the resource disk cache, if it's enabled and
+	 * holds the resource.
+	 * @return		true if the resource was loaded, false otherwise
+	 */
+	bool loadFromDiskCache(Resource *res);
+
+	/** Adds a freshly decompressed resource to the resource disk cache. */
+	void addToDiskCache(const Resource *res);
+
 	void setAudioLanguage(int language);
 	int getAudioLanguage() const;
 	void changeAudioDirectory(Common::String path);
@@ -378,20 +409,34 @@ public:
 	 */
 	ResourceType convertResType(byte type);
 
+	// Default number of bytes to allow being allocated for resources. The
+	// original interpreters had to make do with little memory, but there is no
+	// need to reload resources from disk every time a room is revisited on
+	// anything but the smallest ports. The "sci_resource_cache_size" setting
+	// (in KB, up to MAX_CACHE_SIZE) overrides this.
+	enum {
+#ifdef REDUCE_MEMORY_USAGE
+		DEFAULT_MAX_MEMORY = 256 * 1024,	// 256KB
+#else
+		DEFAULT_MAX_MEMORY = 8 * 1024 * 1024,	// 8MB
+#endif
+		MAX_CACHE_SIZE = 1024 * 1024	// 1GB, in KB
+	};
+
 protected:
 	// Maximum number of bytes to allow being allocated for resources
 	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
 	// for resources which are not explicitly locked. However, a warning will be
 	// issued whenever this limit is exceeded.
-	enum {
-		MAX_MEMORY = 256 * 1024	// 256KB
-	};
+	int _maxMemoryLRU;
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	Common::List<ResourceSource *> _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	Common::Queue<ResourceId> _prefetchQueue; ///< Resources to load while idle
+	ResourceDiskCache *_diskCache; ///< Decompressed resources from earlier sessions, or NULL
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -406,6 +451,12 @@ protected:
 
 	ResourceSource *findVolume(ResourceSource *map, int volume_nr);
 
+	/**
+	 * Opens the resource disk cache, if the "sci_resource_disk_cache"
+	 * setting is enabled.
+	 */
+	void openDiskCache();
+
 	/**
 	 * Adds a source to the resource manager's list of sources.
 	 * @param source	The new source to add
@@ -0,0 +1,237 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/debug.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "sci/sci.h"
+#include "sci/resource_cache.h"
+
+namespace Sci {
+
+ResourceDiskCache::ResourceDiskCache(const Common::String &fileName, const Common::String &fingerprint)
+	: _fileName(fileName), _fingerprint(fingerprint), _file(0), _totalSize(0), _pendingSize(0) {
+	readIndex();
+}
+
+ResourceDiskCache::~ResourceDiskCache() {
+	flush();
+	clear();
+}
+
+void ResourceDiskCache::clear() {
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it)
+		delete[] it->_value.data;
+
+	_entries.clear();
+	_totalSize = 0;
+	_pendingSize = 0;
+
+	delete _file;
+	_file = 0;
+}
+
+void ResourceDiskCache::readIndex() {
+	clear();
+
+	_file = g_system->getSavefileManager()->openForLoading(_fileName);
+	if (!_file)
+		return;
+
+	if (_file->readUint32BE() != MKTAG('S', 'C', 'R', 'C') || _file->readUint32LE() != kVersion) {
+		warning("Resource cache %s is invalid, ignoring it", _fileName.c_str());
+		clear();
+		return;
+	}
+
+	// The file is simply replaced on the next flush if it belongs to
+	// different game data
+	const uint16 fingerprintSize = _file->readUint16LE();
+	Common::String fingerprint;
+	for (uint16 i = 0; i < fingerprintSize; i++)
+		fingerprint += (char)_file->readByte();
+
+	if (fingerprint != _fingerprint) {
+		debugC(kDebugLevelResMan, "resMan: Resource cache %s belongs to different game data", _fileName.c_str());
+		clear();
+		return;
+	}
+
+	const uint32 count = _file->readUint32LE();
+	const int32 fileSize = _file->size();
+
+	for (uint32 i = 0; i < count && !_file->eos() && !_file->err(); i++) {
+		const ResourceType type = (ResourceType)_file->readByte();
+		const uint16 number = _file->readUint16LE();
+		const uint32 tuple = _file->readUint32LE();
+
+		Entry entry;
+		entry.volume = _file->readUint16LE();
+		entry.volumeOffset = _file->readUint32LE();
+		entry.size = _file->readUint32LE();
+		entry.dataOffset = _file->readUint32LE();
+		entry.data = 0;
+
+		if (entry.dataOffset > (uint32)fileSize || entry.size > (uint32)fileSize - entry.dataOffset)
+			break;
+
+		_entries[ResourceId(type, number, tuple)] = entry;
+		_totalSize += entry.size;
+	}
+
+	if (_file->eos() || _file->err() || _entries.size() != count) {
+		warning("Resource cache %s is damaged, ignoring it", _fileName.c_str());
+		clear();
+		return;
+	}
+
+	debugC(kDebugLevelResMan, "resMan: Resource cache %s holds %d resources", _fileName.c_str(), count);
+}
+
+byte *ResourceDiskCache::load(ResourceId id, int volume, int32 volumeOffset, uint32 &size) {
+	EntryMap::const_iterator it = _entries.find(id);
+	if (it == _entries.end())
+		return 0;
+
+	const Entry &entry = it->_value;
+	if (entry.volume != volume || entry.volumeOffset != (uint32)volumeOffset)
+		return 0;
+
+	byte *data = new byte[entry.size];
+
+	if (entry.data) {
+		memcpy(data, entry.data, entry.size);
+	} else {
+		_file->seek(entry.dataOffset, SEEK_SET);
+		if (_file->read(data, entry.size) != entry.size) {
+			warning("Failed to read %s from resource cache %s", id.toString().c_str(), _fileName.c_str());
+			delete[] data;
+			_file->clearErr();
+			return 0;
+		}
+	}
+
+	size = entry.size;
+	return data;
+}
+
+void ResourceDiskCache::add(ResourceId id, int volume, int32 volumeOffset, const byte *data, uint32 size) {
+	if (_entries.contains(id) || _totalSize + size > kMaxTotalSize || _pendingSize + size > kMaxPendingSize)
+		return;
+
+	Entry entry;
+	entry.volume = volume;
+	entry.volumeOffset = volumeOffset;
+	entry.size = size;
+	entry.dataOffset = 0;
+	entry.data = new byte[size];
+	memcpy(entry.data, data, size);
+
+	_entries[id] = entry;
+	_totalSize += size;
+	_pendingSize += size;
+}
+
+void ResourceDiskCache::flush() {
+	if (!_pendingSize)
+		return;
+
+	// Save files can't be appended to, so the whole file is written anew,
+	// copying the resources which were already in there
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const Common::String tempName = _fileName + ".new";
+
+	Common::OutSaveFile *out = saveFileMan->openForSaving(tempName, false);
+	if (!out) {
+		warning("Failed to write resource cache %s", tempName.c_str());
+		readIndex();
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('S', 'C', 'R', 'C'));
+	out->writeUint32LE(kVersion);
+	out->writeUint16LE(_fingerprint.size());
+	out->write(_fingerprint.c_str(), _fingerprint.size());
+	out->writeUint32LE(_entries.size());
+
+	uint32 dataOffset = 14 + _fingerprint.size() + _entries.size() * kEntrySize;
+
+	EntryMap::const_iterator it;
+	for (it = _entries.begin(); it != _entries.end(); ++it) {
+		out->writeByte(it->_key.getType());
+		out->writeUint16LE(it->_key.getNumber());
+		out->writeUint32LE(it->_key.getTuple());
+		out->writeUint16LE(it->_value.volume);
+		out->writeUint32LE(it->_value.volumeOffset);
+		out->writeUint32LE(it->_value.size);
+		out->writeUint32LE(dataOffset);
+		dataOffset += it->_value.size;
+	}
+
+	byte buffer[4096];
+	bool success = true;
+
+	for (it = _entries.begin(); it != _entries.end() && success; ++it) {
+		const Entry &entry = it->_value;
+
+		if (entry.data) {
+			out->write(entry.data, entry.size);
+			success = !out->err();
+			continue;
+		}
+
+		_file->seek(entry.dataOffset, SEEK_SET);
+		uint32 left = entry.size;
+		while (left > 0) {
+			const uint32 len = _file->read(buffer, MIN<uint32>(left, sizeof(buffer)));
+			if (!len)
+				break;
+			out->write(buffer, len);
+			left -= len;
+		}
+
+		success = !left && !out->err();
+	}
+
+	out->finalize();
+	success = success && !out->err();
+	delete out;
+
+	// Close the old file before replacing it
+	clear();
+
+	if (success) {
+		saveFileMan->removeSavefile(_fileName);
+		if (!saveFileMan->renameSavefile(tempName, _fileName))
+			warning("Failed to rename resource cache %s", tempName.c_str());
+	} else {
+		warning("Failed to write resource cache %s", tempName.c_str());
+		saveFileMan->removeSavefile(tempName);
+	}
+
+	readIndex();
+}
+
+} // End of namespace Sci
@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef SCI_RESOURCE_CACHE_H
+#define SCI_RESOURCE_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/str.h"
+
+#include "sci/resource.h"
+
+namespace Common {
+class SeekableReadStream;
+}
+
+namespace Sci {
+
+/**
+ * Keeps decompressed resources in a file in the saved games directory, so
+ * that later sessions can read them from there instead of decompressing
+ * them again. Resources are identified by their id and their location in
+ * the resource volumes, and the file belongs to the game whose resource map
+ * matches the fingerprint given to the constructor.
+ *
+ * New resources are held in memory and only written when the cache is
+ * destroyed, as the file has to be rewritten as a whole each time. This
+ * keeps the rewriting out of the game loop. At most kMaxPendingSize bytes
+ * are held back per session; later resources are left for later sessions.
+ */
+class ResourceDiskCache {
+public:
+	ResourceDiskCache(const Common::String &fileName, const Common::String &fingerprint);
+	~ResourceDiskCache();
+
+	/**
+	 * Reads a resource from the cache.
+	 * @param id			the id of the resource
+	 * @param volume		the number of the volume holding the resource
+	 * @param volumeOffset	the offset of the resource in that volume
+	 * @param size			set to the size of the returned data
+	 * @return newly allocated data, or NULL if the resource isn't cached
+	 */
+	byte *load(ResourceId id, int volume, int32 volumeOffset, uint32 &size);
+
+	/**
+	 * Adds a decompressed resource to the cache. The data is copied.
+	 */
+	void add(ResourceId id, int volume, int32 volumeOffset, const byte *data, uint32 size);
+
+private:
+	enum {
+		kVersion = 1,
+		kEntrySize = 23,
+		kMaxTotalSize = 64 * 1024 * 1024,
+		kMaxPendingSize = 16 * 1024 * 1024
+	};
+
+	struct Entry {
+		uint16 volume;
+		uint32 volumeOffset;
+		uint32 size;
+		uint32 dataOffset; ///< offset of the data in the file
+		byte *data; ///< the data if it hasn't been written to the file yet
+	};
+
+	typedef Common::HashMap<ResourceId, Entry, ResourceIdHash> EntryMap;
+
+	void readIndex();
+	void clear();
+
+	/** Writes the resources added since the cache was opened to the file. */
+	void flush();
+
+	const Common::String _fileName;
+	const Common::String _fingerprint;
+
+	Common::SeekableReadStream *_file;
+	EntryMap _entries;
+	uint32 _totalSize; ///< size of the data of all entries
+	uint32 _pendingSize; ///< size of the data not written yet
+};
+
+} // End of namespace Sci
+
+#endif // SCI_RESOURCE_CACHE_H
@@ -195,6 +195,8 @@ Common::Error SciEngine::run() {
 	ConfMan.registerDefault("native_fb01", "false");
 	ConfMan.registerDefault("windows_cursors", "false");	// Windows cursors for KQ6 Windows
 	ConfMan.registerDefault("silver_cursors", "false");	// Silver cursors for SQ4 CD
+	ConfMan.registerDefault("sci_resource_cache_size", ResourceManager::DEFAULT_MAX_MEMORY / 1024);
+	ConfMan.registerDefault("sci_resource_disk_cache", "false");
 
 	_resMan = new ResourceManager();
 	assert(_resMan);
@@ -568,6 +570,7 @@ bool SciEngine::initGame() {
 
 	_gamestate->_msgState = new MessageState(_gamestate->_segMan);
 	_gamestate->gcCountDown = GC_INTERVAL - 1;
+	_gamestate->_gcGarbage.clear();
 
 	// Script 0 should always be at segment 1
 	if (script0Segment != 1) {
@@ -702,6 +705,12 @@ void SciEngine::runGame() {
 
 	_gamestate->_syncedAudioOptions = false;
 
+	// When replaying a recorded session, measure how fast the scripts run,
+	// which makes the recording usable as a benchmark of the VM
+	const bool benchmark = (ConfMan.get("record_mode") == "playback");
+	if (benchmark)
+		_gamestate->setActivityTiming(true);
+
 	do {
 		_gamestate->_executionStackPosChanged = false;
 		run_vm(_gamestate);
@@ -737,6 +746,14 @@ void SciEngine::runGame() {
 			break;	// exit loop
 		}
 	} while (true);
+
+	if (benchmark) {
+		_gamestate->setActivityTiming(false);
+		debug("SCI VM: %d operations in %u ms, %u ms in kernel calls, %u operations per second",
+		      _gamestate->scriptStepCounter - _gamestate->_activityTimingSteps,
+		      _gamestate->_activityTime[EngineState::kTimedScript], _gamestate->_activityTime[EngineState::kTimedKernel],
+		      _gamestate->getOperationsPerSecond());
+	}
 }
 
 void SciEngine::exitGame() {
@@ -33,6 +33,7 @@
 #include "common/system.h"
 
 #include "audio/audiostream.h"
+#include "audio/decodedcache.h"
 #include "audio/decoders/aiff.h"
 #include "audio/decoders/flac.h"
 #include "audio/decoders/mac_snd.h"
@@ -256,6 +257,21 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 
 	*sampleLen = 0;
 
+#if (defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC))
+	// Compressed sound effects are played over and over again, so they are
+	// kept around decoded. Look them up before touching the resource, so a
+	// cached sound is neither read nor decompressed.
+	const bool cacheable = (volume == 65535);
+	const Common::String cacheName = ResourceId(kResourceTypeAudio, number).toString();
+	if (cacheable) {
+		audioSeekStream = DecodedAudioCacheMan.getStream(cacheName, 0, 0);
+		if (audioSeekStream) {
+			*sampleLen = (audioSeekStream->getLength().msecs() * 60) / 1000; // we translate msecs to ticks
+			return audioSeekStream;
+		}
+	}
+#endif
+
 	if (volume == 65535) {
 		audioRes = _resMan->findResource(ResourceId(kResourceTypeAudio, number), false);
 		if (!audioRes) {
@@ -304,6 +320,9 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 #endif
 			break;
 		}
+
+		if (cacheable)
+			audioSeekStream = DecodedAudioCacheMan.addStream(cacheName, 0, 0, audioSeekStream);
 #else
 		error("Compressed audio file encountered, but no appropriate decoder is compiled in");
 #endif
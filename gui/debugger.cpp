@@ -24,6 +24,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "common/debug-channels.h"
+#include "common/file.h"
 #include "common/system.h"
 
 #include "engines/engine.h"
@@ -36,6 +37,8 @@
 	#include <readline/history.h>
 #endif
 
+#include "audio/mixer.h"
+
 
 namespace GUI {
 
@@ -64,6 +67,8 @@ Debugger::Debugger() {
 	DCmd_Register("debugflag_list",		WRAP_METHOD(Debugger, Cmd_DebugFlagsList));
 	DCmd_Register("debugflag_enable",	WRAP_METHOD(Debugger, Cmd_DebugFlagEnable));
 	DCmd_Register("debugflag_disable",	WRAP_METHOD(Debugger, Cmd_DebugFlagDisable));
+
+	DCmd_Register("mixer_profile",		WRAP_METHOD(Debugger, Cmd_MixerProfile));
 }
 
 Debugger::~Debugger() {
@@ -537,6 +542,41 @@ bool Debugger::Cmd_DebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::Cmd_MixerProfile(int argc, const char **argv) {
+	Audio::Mixer *mixer = g_system->getMixer();
+
+	if (argc < 2) {
+		DebugPrintf("Usage: %s on|off|show|dump <file>\n", argv[0]);
+		DebugPrintf("Profiling is %s\n", mixer->isProfiling() ? "on" : "off");
+		return true;
+	}
+
+	const Common::String cmd = argv[1];
+	if (cmd == "on") {
+		mixer->setProfiling(true);
+		DebugPrintf("Started a new mixer profile\n");
+	} else if (cmd == "off") {
+		mixer->setProfiling(false);
+	} else if (cmd == "show") {
+		DebugPrintf("%s", mixer->getProfileReport().c_str());
+	} else if (cmd == "dump" && argc > 2) {
+		Common::DumpFile file;
+		if (!file.open(argv[2])) {
+			DebugPrintf("Could not open '%s' for writing\n", argv[2]);
+			return true;
+		}
+
+		const Common::String report = mixer->getProfileReport();
+		file.writeString(report);
+		file.finalize();
+		DebugPrintf("Wrote the mixer profile to '%s'\n", argv[2]);
+	} else {
+		DebugPrintf("Usage: %s on|off|show|dump <file>\n", argv[0]);
+	}
+
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
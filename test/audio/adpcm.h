@@ -0,0 +1,177 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/adpcm.h"
+
+#include "common/memstream.h"
+
+class ADPCMStreamTestSuite : public CxxTest::TestSuite
+{
+private:
+	Audio::RewindableAudioStream *createStream(const byte *data, uint32 size, Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		return Audio::makeADPCMStream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+	}
+
+	// Deterministic noise as ADPCM data. Block headers are patched to hold
+	// valid IMA step indices.
+	byte *createData(uint32 size, Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		byte *data = new byte[size];
+		uint32 seed = 12345;
+		for (uint32 i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = seed >> 16;
+		}
+
+		if (type == Audio::kADPCMMSIma) {
+			for (uint32 block = 0; block < size; block += blockAlign) {
+				for (int i = 0; i < channels; ++i) {
+					data[block + i * 4 + 2] %= 89;
+					data[block + i * 4 + 3] = 0;
+				}
+			}
+		}
+
+		return data;
+	}
+
+	// Decoding in small pieces has to give the same result as decoding
+	// everything at once, which takes whole blocks.
+	void readBufferTestTemplate(Audio::ADPCMType type, int channels, uint32 blockAlign, int chunkSize) {
+		const uint32 size = blockAlign ? blockAlign * 16 : 4096;
+		byte *data = createData(size, type, channels, blockAlign);
+
+		Audio::RewindableAudioStream *s = createStream(data, size, type, channels, blockAlign);
+		int16 *whole = new int16[size * 2];
+		const int samples = s->readBuffer(whole, size * 2);
+		TS_ASSERT_LESS_THAN(0, samples);
+		TS_ASSERT(s->endOfData());
+
+		TS_ASSERT(s->rewind());
+		TS_ASSERT(!s->endOfData());
+
+		int16 *pieces = new int16[size * 2];
+		int pos = 0;
+		while (!s->endOfData() && pos < samples) {
+			const int read = s->readBuffer(pieces + pos, MIN(chunkSize, samples - pos));
+			TS_ASSERT_LESS_THAN(0, read);
+			if (read <= 0)
+				break;
+			pos += read;
+		}
+
+		TS_ASSERT_EQUALS(pos, samples);
+		TS_ASSERT_EQUALS(memcmp(whole, pieces, samples * sizeof(int16)), 0);
+		TS_ASSERT(s->endOfData());
+
+		delete[] pieces;
+		delete[] whole;
+		delete s;
+		delete[] data;
+	}
+
+public:
+	void test_decode_ima() {
+		// Worked out by hand from the IMA step table
+		static const byte data[] = { 0x07, 0x8F };
+		Audio::RewindableAudioStream *s = createStream(data, sizeof(data), Audio::kADPCMDVI, 1, 0);
+
+		int16 buffer[4];
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, 4), 4);
+		TS_ASSERT_EQUALS(buffer[0], 0);
+		TS_ASSERT_EQUALS(buffer[1], 13);
+		TS_ASSERT_EQUALS(buffer[2], 11);
+		TS_ASSERT_EQUALS(buffer[3], -15);
+		TS_ASSERT(s->endOfData());
+
+		delete s;
+	}
+
+	void test_decode_ms_stereo_header() {
+		// The block header holds the first two samples of each channel
+		static const byte data[] = {
+			0, 0,                   // predictors
+			16, 0, 16, 0,           // deltas
+			100, 0, 0x9C, 0xFF,     // sample1: 100, -100
+			50, 0, 0xCE, 0xFF,      // sample2: 50, -50
+			0x00, 0x00
+		};
+		Audio::RewindableAudioStream *s = createStream(data, sizeof(data), Audio::kADPCMMS, 2, sizeof(data));
+
+		int16 buffer[8];
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, 8), 8);
+		TS_ASSERT_EQUALS(buffer[0], 50);
+		TS_ASSERT_EQUALS(buffer[1], -50);
+		TS_ASSERT_EQUALS(buffer[2], 100);
+		TS_ASSERT_EQUALS(buffer[3], -100);
+
+		delete s;
+	}
+
+	void test_apple_short_stereo_block() {
+		// The final stereo block is cut short inside the second channel's
+		// block. Both channels may only be decoded as far as the second one
+		// goes, and have to be read from their own block.
+		static const byte data[] = {
+			0x00, 0x00, 0x11, 0x11, 0x11, 0x11,    // left:  header, 8 samples
+			0x00, 0x00, 0x99, 0x99                 // right: header, 4 samples
+		};
+		Audio::RewindableAudioStream *s = createStream(data, sizeof(data), Audio::kADPCMApple, 2, 6);
+
+		int16 buffer[16];
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, 16), 8);
+		// A nibble of 1 makes the predictor go up, one of 9 makes it go down
+		for (int i = 0; i < 4; ++i) {
+			TS_ASSERT_LESS_THAN(0, buffer[i * 2]);
+			TS_ASSERT_LESS_THAN(buffer[i * 2 + 1], 0);
+			TS_ASSERT_EQUALS(buffer[i * 2], -buffer[i * 2 + 1]);
+		}
+		TS_ASSERT(s->endOfData());
+
+		delete s;
+	}
+
+	void test_read_buffer_oki() {
+		readBufferTestTemplate(Audio::kADPCMOki, 1, 0, 1);
+		readBufferTestTemplate(Audio::kADPCMOki, 1, 0, 333);
+	}
+
+	void test_read_buffer_dvi_mono() {
+		readBufferTestTemplate(Audio::kADPCMDVI, 1, 0, 1);
+		readBufferTestTemplate(Audio::kADPCMDVI, 1, 0, 333);
+	}
+
+	void test_read_buffer_dvi_stereo() {
+		readBufferTestTemplate(Audio::kADPCMDVI, 2, 0, 2);
+		readBufferTestTemplate(Audio::kADPCMDVI, 2, 0, 334);
+	}
+
+	void test_read_buffer_ms_ima_mono() {
+		readBufferTestTemplate(Audio::kADPCMMSIma, 1, 256, 1);
+		readBufferTestTemplate(Audio::kADPCMMSIma, 1, 256, 333);
+	}
+
+	void test_read_buffer_ms_ima_stereo() {
+		readBufferTestTemplate(Audio::kADPCMMSIma, 2, 512, 2);
+		readBufferTestTemplate(Audio::kADPCMMSIma, 2, 512, 334);
+	}
+
+	void test_read_buffer_ms_mono() {
+		readBufferTestTemplate(Audio::kADPCMMS, 1, 256, 1);
+		readBufferTestTemplate(Audio::kADPCMMS, 1, 256, 333);
+	}
+
+	void test_read_buffer_ms_stereo() {
+		readBufferTestTemplate(Audio::kADPCMMS, 2, 512, 2);
+		readBufferTestTemplate(Audio::kADPCMMS, 2, 512, 334);
+	}
+
+	void test_read_buffer_apple_mono() {
+		readBufferTestTemplate(Audio::kADPCMApple, 1, 34, 1);
+		readBufferTestTemplate(Audio::kADPCMApple, 1, 34, 333);
+	}
+
+	void test_read_buffer_apple_stereo() {
+		readBufferTestTemplate(Audio::kADPCMApple, 2, 34, 2);
+		readBufferTestTemplate(Audio::kADPCMApple, 2, 34, 334);
+	}
+};
@@ -0,0 +1,166 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decodedcache.h"
+
+#include "helper.h"
+
+class DecodedAudioCacheTestSuite : public CxxTest::TestSuite
+{
+	// A decoder which does not know its length, and may not be able to seek
+	class LengthlessStream : public Audio::SeekableAudioStream {
+	public:
+		LengthlessStream(Audio::SeekableAudioStream *stream, bool seekable) : _stream(stream), _seekable(seekable) {}
+		~LengthlessStream() { delete _stream; }
+
+		int readBuffer(int16 *buffer, const int numSamples) { return _stream->readBuffer(buffer, numSamples); }
+		bool isStereo() const { return _stream->isStereo(); }
+		int getRate() const { return _stream->getRate(); }
+		bool endOfData() const { return _stream->endOfData(); }
+		bool seek(const Audio::Timestamp &where) { return _seekable && _stream->seek(where); }
+		Audio::Timestamp getLength() const { return Audio::Timestamp(0, getRate()); }
+
+	private:
+		Audio::SeekableAudioStream *_stream;
+		bool _seekable;
+	};
+
+	static Audio::SeekableAudioStream *createStream(int samples, int16 first) {
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (int i = 0; i < samples; i++)
+			data[i] = first + i;
+
+		return Audio::makeRawStream((byte *)data, samples * sizeof(int16), 11025, Audio::FLAG_16BITS
+#ifdef SCUMM_LITTLE_ENDIAN
+		                            | Audio::FLAG_LITTLE_ENDIAN
+#endif
+		                            , DisposeAfterUse::YES);
+	}
+
+	// Checks that the stream plays the samples createStream() made
+	static bool playsSamples(Audio::AudioStream *stream, int samples, int16 first) {
+		int16 *buffer = new int16[samples + 1];
+		const int read = stream->readBuffer(buffer, samples + 1);
+
+		bool equal = (read == samples);
+		for (int i = 0; equal && i < samples; i++)
+			equal = (buffer[i] == (int16)(first + i));
+
+		delete[] buffer;
+		return equal;
+	}
+
+public:
+	void setUp() {
+		_testSystem = new TestSystem();
+		DecodedAudioCacheMan.clear();
+		_maxMemory = DecodedAudioCacheMan.getMaxMemory();
+	}
+
+	void tearDown() {
+		DecodedAudioCacheMan.clear();
+		DecodedAudioCacheMan.setMaxMemory(_maxMemory);
+		delete _testSystem;
+	}
+
+	void test_hit_and_miss() {
+		const Audio::DecodedAudioCache::Stats before = DecodedAudioCacheMan.getStats();
+
+		TS_ASSERT(!DecodedAudioCacheMan.getStream("sound", 10, 1));
+
+		Audio::SeekableAudioStream *stream = DecodedAudioCacheMan.addStream("sound", 10, 1, createStream(1000, 5));
+		TS_ASSERT(stream);
+		TS_ASSERT(playsSamples(stream, 1000, 5));
+		delete stream;
+
+		// The offset and the parameters are part of the key
+		TS_ASSERT(!DecodedAudioCacheMan.getStream("sound", 11, 1));
+		TS_ASSERT(!DecodedAudioCacheMan.getStream("sound", 10, 2));
+
+		stream = DecodedAudioCacheMan.getStream("sound", 10, 1);
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT(playsSamples(stream, 1000, 5));
+			TS_ASSERT(stream->rewind());
+			TS_ASSERT(playsSamples(stream, 1000, 5));
+			delete stream;
+		}
+
+		const Audio::DecodedAudioCache::Stats after = DecodedAudioCacheMan.getStats();
+		TS_ASSERT_EQUALS(after.hits - before.hits, 1u);
+		TS_ASSERT_EQUALS(after.misses - before.misses, 3u);
+		TS_ASSERT_EQUALS(after.sounds, 1u);
+		TS_ASSERT_EQUALS(after.memoryUsed, 2000u);
+	}
+
+	void test_eviction() {
+		// Room for five sounds of 12000 bytes
+		DecodedAudioCacheMan.setMaxMemory(64 * 1024);
+		const Audio::DecodedAudioCache::Stats before = DecodedAudioCacheMan.getStats();
+
+		Audio::SeekableAudioStream *first = DecodedAudioCacheMan.addStream("sound", 0, 0, createStream(6000, 0));
+		for (uint i = 1; i < 5; i++)
+			delete DecodedAudioCacheMan.addStream("sound", i, 0, createStream(6000, i));
+
+		// Using the first sound makes the second one the least recently used
+		delete DecodedAudioCacheMan.getStream("sound", 0, 0);
+		delete DecodedAudioCacheMan.addStream("sound", 5, 0, createStream(6000, 5));
+
+		const Audio::DecodedAudioCache::Stats after = DecodedAudioCacheMan.getStats();
+		TS_ASSERT_EQUALS(after.evictions - before.evictions, 1u);
+		TS_ASSERT_EQUALS(after.sounds, 5u);
+		TS_ASSERT_LESS_THAN_EQUALS(after.memoryUsed, 64u * 1024);
+
+		TS_ASSERT(!DecodedAudioCacheMan.getStream("sound", 1, 0));
+
+		Audio::SeekableAudioStream *stream = DecodedAudioCacheMan.getStream("sound", 0, 0);
+		TS_ASSERT(stream);
+		delete stream;
+
+		// A stream keeps playing a sound after it has been evicted
+		DecodedAudioCacheMan.clear();
+		TS_ASSERT(playsSamples(first, 6000, 0));
+		delete first;
+	}
+
+	void test_too_large() {
+		// Sounds of more than a quarter of the budget are not cached, and
+		// are given back at their start
+		DecodedAudioCacheMan.setMaxMemory(64 * 1024);
+
+		Audio::SeekableAudioStream *original = createStream(10000, 7);
+		Audio::SeekableAudioStream *stream = DecodedAudioCacheMan.addStream("large", 0, 0, original);
+		TS_ASSERT_EQUALS(stream, original);
+		TS_ASSERT(playsSamples(stream, 10000, 7));
+		delete stream;
+
+		// Also when that only shows while decoding
+		original = new LengthlessStream(createStream(10000, 7), true);
+		stream = DecodedAudioCacheMan.addStream("large", 0, 0, original);
+		TS_ASSERT_EQUALS(stream, original);
+		TS_ASSERT(playsSamples(stream, 10000, 7));
+		delete stream;
+
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getStats().sounds, 0u);
+	}
+
+	void test_rewind_failure() {
+		// A too large sound which cannot be rewound is played from memory,
+		// without being cached
+		DecodedAudioCacheMan.setMaxMemory(64 * 1024);
+
+		Audio::SeekableAudioStream *stream = DecodedAudioCacheMan.addStream("large", 0, 0, new LengthlessStream(createStream(10000, 7), false));
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT(playsSamples(stream, 10000, 7));
+			delete stream;
+		}
+
+		TS_ASSERT(!DecodedAudioCacheMan.getStream("large", 0, 0));
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getStats().sounds, 0u);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getStats().memoryUsed, 0u);
+	}
+
+private:
+	TestSystem *_testSystem;
+	uint32 _maxMemory;
+};
@@ -2,13 +2,87 @@
 #define TEST_SOUND_HELPER_H
 
 #include "audio/decoders/raw.h"
+#include "audio/mixer_intern.h"
 
 #include "common/stream.h"
 #include "common/endian.h"
+#include "common/system.h"
+
+#include "graphics/pixelformat.h"
 
 #include <math.h>
 #include <limits>
 
+/**
+ * A minimal OSystem for code which needs a g_system, e.g. for a mutex or a
+ * random source. It is installed as g_system while it exists, and the
+ * previous one is put back afterwards, so declare it in the scope of a test.
+ * A mixer running at the given rate is provided if the rate is not 0. It is
+ * only mixed when the test calls mix().
+ */
+class TestSystem : public OSystem {
+public:
+	TestSystem(uint mixerRate = 0) : _previous(g_system), _mixer(0) {
+		g_system = this;
+
+		if (mixerRate) {
+			_mixer = new Audio::MixerImpl(this, mixerRate);
+			_mixer->setReady(true);
+		}
+	}
+
+	~TestSystem() {
+		delete _mixer;
+		g_system = _previous;
+	}
+
+	/** Mix the given number of stereo sample frames. */
+	void mix(int16 *buffer, uint frames) { _mixer->mixCallback((byte *)buffer, frames * 4); }
+
+	virtual const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return false; }
+	virtual int getGraphicsMode() const { return 0; }
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+	virtual uint32 getMillis() { return 0; }
+	virtual void delayMillis(uint msecs) {}
+	virtual void getTimeAndDate(TimeDate &t) const {}
+	virtual MutexRef createMutex() { return 0; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+	virtual Audio::Mixer *getMixer() { return _mixer; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) {}
+
+private:
+	OSystem *_previous;
+	Audio::MixerImpl *_mixer;
+};
+
 template<typename T>
 static T *createSine(const int sampleRate, const int time) {
 	T *sine = (T *)malloc(sizeof(T) * time * sampleRate);
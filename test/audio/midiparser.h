@@ -0,0 +1,120 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mididrv.h"
+#include "audio/midiparser.h"
+
+#include "common/array.h"
+
+class MidiParserTestSuite : public CxxTest::TestSuite
+{
+	class RecordingDriver : public MidiDriver_BASE {
+	public:
+		Common::Array<uint32> events;
+		uint32 metaEvents;
+
+		RecordingDriver() : metaEvents(0) {}
+
+		void send(uint32 b) { events.push_back(b); }
+		void metaEvent(byte type, byte *data, uint16 length) { ++metaEvents; }
+	};
+
+	// A type 0 SMF at 96 PPQN: a program change, a note from tick 96 to
+	// 288, a tempo change to 1000000 us per quarter note at tick 192 and a
+	// volume change at tick 384.
+	static const byte *smfData() {
+		static const byte data[] = {
+			'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+			'M', 'T', 'r', 'k', 0, 0, 0, 26,
+			0x00, 0xC0, 0x05,
+			0x60, 0x90, 0x3C, 0x64,
+			0x60, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40,
+			0x60, 0x80, 0x3C, 0x00,
+			0x60, 0xB0, 0x07, 0x64,
+			0x00, 0xFF, 0x2F, 0x00
+		};
+		return data;
+	}
+
+	MidiParser *createParser(RecordingDriver &driver) {
+		MidiParser *parser = MidiParser::createParser_SMF();
+		parser->setMidiDriver(&driver);
+		parser->setTimerRate(10000);
+		TS_ASSERT(parser->loadMusic(const_cast<byte *>(smfData()), 48));
+		return parser;
+	}
+
+	// Run the parser until it stops, recording the timer tick at which each
+	// event arrives in the upper bits.
+	Common::Array<uint32> play(MidiParser *parser, RecordingDriver &driver) {
+		Common::Array<uint32> result;
+		for (uint32 tick = 0; tick < 1000 && parser->isPlaying(); ++tick) {
+			driver.events.clear();
+			parser->onTimer();
+			for (uint i = 0; i < driver.events.size(); ++i)
+				result.push_back((tick << 24) | driver.events[i]);
+		}
+		return result;
+	}
+
+	public:
+	void test_play() {
+		RecordingDriver driver;
+		MidiParser *parser = createParser(driver);
+
+		Common::Array<uint32> events = play(parser, driver);
+		// The four channel events, then the notes off sent when stopping
+		TS_ASSERT_LESS_THAN_EQUALS((uint)4, events.size());
+		TS_ASSERT_EQUALS(events[0], (uint32)0x05C0);
+		// 96 ticks at 5208 us per tick
+		TS_ASSERT_EQUALS(events[1], (uint32)((49 << 24) | 0x643C90));
+		// The tempo is halved at tick 192
+		TS_ASSERT_EQUALS(events[2], (uint32)((199 << 24) | 0x3C80));
+		TS_ASSERT_EQUALS(events[3], (uint32)((299 << 24) | 0x6407B0));
+		TS_ASSERT_EQUALS(driver.metaEvents, (uint32)2);
+
+		delete parser;
+	}
+
+	void test_jump() {
+		RecordingDriver driver, firedDriver;
+		MidiParser *parser = createParser(driver);
+		MidiParser *firedParser = createParser(firedDriver);
+
+		// Skipping the events has to end up in the same state as playing
+		// them, including the tempo change
+		TS_ASSERT(parser->jumpToTick(250));
+		TS_ASSERT(firedParser->jumpToTick(250, true));
+		TS_ASSERT_EQUALS(parser->getTick(), (uint32)250);
+		TS_ASSERT_EQUALS(firedParser->getTick(), (uint32)250);
+		TS_ASSERT_EQUALS(firedDriver.metaEvents, (uint32)1);
+
+		Common::Array<uint32> events = play(parser, driver);
+		Common::Array<uint32> firedEvents = play(firedParser, firedDriver);
+		TS_ASSERT_EQUALS(events.size(), firedEvents.size());
+		for (uint i = 0; i < events.size() && i < firedEvents.size(); ++i)
+			TS_ASSERT_EQUALS(events[i], firedEvents[i]);
+
+		// 38 ticks at the new tempo of 10416 us per tick
+		TS_ASSERT_EQUALS(events[0], (uint32)((39 << 24) | 0x3C80));
+
+		delete parser;
+		delete firedParser;
+	}
+
+	void test_jump_past_end() {
+		RecordingDriver driver;
+		MidiParser *parser = createParser(driver);
+
+		TS_ASSERT(parser->jumpToTick(100));
+		TS_ASSERT(!parser->jumpToTick(1000));
+		TS_ASSERT_EQUALS(parser->getTick(), (uint32)100);
+
+		// Jumping back works, and to the very end as well
+		TS_ASSERT(parser->jumpToTick(20));
+		TS_ASSERT_EQUALS(parser->getTick(), (uint32)20);
+		TS_ASSERT(parser->jumpToTick(384));
+		TS_ASSERT_EQUALS(parser->getTick(), (uint32)384);
+
+		delete parser;
+	}
+};
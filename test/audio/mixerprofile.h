@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+
+class MixerProfileTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_histogram() {
+		Audio::OutputTiming timing;
+		timing.reset(44100, 1024);
+		Audio::MixerProfile profile(16, timing);
+
+		static const uint32 durations[] = { 0, 0, 1, 2, 3, 4, 9, 100 };
+		for (uint i = 0; i < ARRAYSIZE(durations); ++i) {
+			timing.addCallback(i * 11, 512);
+			profile.addCallback(durations[i], 512);
+		}
+
+		TS_ASSERT_EQUALS(profile.getCallbackCount(), (uint32)8);
+		TS_ASSERT_EQUALS(profile.getCallbackTime(), (uint32)119);
+		TS_ASSERT_EQUALS(profile.getMaxCallbackTime(), (uint32)100);
+
+		TS_ASSERT_EQUALS(profile.getHistogramCount(0), (uint32)2);
+		TS_ASSERT_EQUALS(profile.getHistogramCount(1), (uint32)1);
+		TS_ASSERT_EQUALS(profile.getHistogramCount(2), (uint32)2);
+		TS_ASSERT_EQUALS(profile.getHistogramCount(3), (uint32)1);
+		TS_ASSERT_EQUALS(profile.getHistogramCount(4), (uint32)1);
+		TS_ASSERT_EQUALS(profile.getHistogramCount(5), (uint32)0);
+		TS_ASSERT_EQUALS(profile.getHistogramCount(Audio::MixerProfile::kHistogramBuckets - 1), (uint32)1);
+	}
+
+	void test_underruns() {
+		Audio::OutputTiming timing;
+		timing.reset(44100, 1024);
+
+		// Callbacks before the profile was started don't count
+		timing.addCallback(0, 512);
+		timing.addCallback(50, 512);
+		TS_ASSERT_EQUALS(timing.getLateCallbackCount(), (uint32)1);
+
+		Audio::MixerProfile profile(16, timing);
+		TS_ASSERT_EQUALS(profile.getCallbackCount(), (uint32)0);
+		TS_ASSERT_EQUALS(profile.getLateCallbackCount(), (uint32)0);
+
+		// 512 frames last 11.6 ms, 1024 buffered frames 23.2 ms
+		timing.addCallback(61, 512);
+		profile.addCallback(11, 512);
+		TS_ASSERT_EQUALS(profile.getSlowCallbackCount(), (uint32)0);
+		timing.addCallback(73, 512);
+		profile.addCallback(12, 512);
+		TS_ASSERT_EQUALS(profile.getSlowCallbackCount(), (uint32)1);
+		TS_ASSERT_EQUALS(profile.getLateCallbackCount(), (uint32)0);
+		timing.addCallback(97, 512);
+		profile.addCallback(1, 512);
+		TS_ASSERT_EQUALS(profile.getLateCallbackCount(), (uint32)0);
+		timing.addCallback(131, 512);
+		profile.addCallback(1, 512);
+		TS_ASSERT_EQUALS(profile.getLateCallbackCount(), (uint32)1);
+		TS_ASSERT_EQUALS(profile.getSlowCallbackCount(), (uint32)1);
+		TS_ASSERT_EQUALS(profile.getCallbackCount(), (uint32)4);
+
+		profile.reset();
+		TS_ASSERT_EQUALS(profile.getSlowCallbackCount(), (uint32)0);
+		TS_ASSERT_EQUALS(profile.getLateCallbackCount(), (uint32)0);
+		TS_ASSERT_EQUALS(profile.getCallbackCount(), (uint32)0);
+	}
+
+	void test_channels() {
+		Audio::OutputTiming timing;
+		timing.reset(44100, 0);
+		Audio::MixerProfile profile(16, timing);
+
+		profile.setChannel(0, Audio::Mixer::kMusicSoundType, -1);
+		profile.setChannel(3, Audio::Mixer::kSFXSoundType, 42);
+		profile.addChannelMix(0, 512, 2, 5);
+		profile.addChannelMix(0, 512, 1, 1);
+		profile.addChannelMix(3, 256, 1, 0);
+
+		const Audio::MixerProfile::ChannelStats &music = profile.getChannelStats(0);
+		TS_ASSERT(music.used);
+		TS_ASSERT_EQUALS(music.mixCount, (uint32)2);
+		TS_ASSERT_EQUALS(music.frames, (uint32)1024);
+		TS_ASSERT_EQUALS(music.decodeTime, (uint32)3);
+		TS_ASSERT_EQUALS(music.convertTime, (uint32)3);
+
+		// The clock may tick between the measurements
+		const Audio::MixerProfile::ChannelStats &sfx = profile.getChannelStats(3);
+		TS_ASSERT_EQUALS(sfx.id, 42);
+		TS_ASSERT_EQUALS(sfx.decodeTime, (uint32)1);
+		TS_ASSERT_EQUALS(sfx.convertTime, (uint32)0);
+		TS_ASSERT(!profile.getChannelStats(1).used);
+
+		// A new channel in a slot starts from scratch, the totals per sound
+		// type are kept
+		profile.setChannel(0, Audio::Mixer::kMusicSoundType, 7);
+		TS_ASSERT_EQUALS(profile.getChannelStats(0).mixCount, (uint32)0);
+		TS_ASSERT_EQUALS(profile.getTypeStats(Audio::Mixer::kMusicSoundType).mixCount, (uint32)2);
+		TS_ASSERT_EQUALS(profile.getTypeStats(Audio::Mixer::kMusicSoundType).decodeTime, (uint32)3);
+
+		TS_ASSERT(!profile.getReport().empty());
+	}
+};
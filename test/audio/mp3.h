@@ -0,0 +1,343 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_MAD
+
+#include "audio/audiostream.h"
+#include "audio/decoders/mp3.h"
+
+#include "common/memstream.h"
+
+#endif
+
+class MP3StreamTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_MAD
+	// 40 frames of MPEG 2.5 Layer III, 11025 Hz mono at 16 kbps, taken from
+	// the testbed audio CD tracks. The main data has been moved forward as
+	// far as possible, so that the frames after the silence at frame 7 all
+	// start their data 255 bytes back in the bit reservoir, several frames
+	// before their own.
+	static const byte *mp3Data() {
+		static const byte data[] = {
+			0xFF, 0xE3, 0x20, 0xC4, 0x00, 0x16, 0x19, 0x0E, 0x98, 0x00, 0x4E, 0x4C, 0x34, 0x6D, 0x39, 0xCC,
+			0x88, 0x7A, 0x9D, 0xF9, 0x21, 0x9C, 0xB5, 0xA3, 0x44, 0xBB, 0x32, 0x87, 0x09, 0xFE, 0x99, 0x83,
+			0x90, 0x4A, 0x1A, 0x42, 0x38, 0x3E, 0x6F, 0xF5, 0x35, 0x7B, 0x3A, 0x7D, 0x01, 0xB6, 0xE7, 0xE7,
+			0x92, 0x79, 0x11, 0xFB, 0x3C, 0x60, 0xC8, 0x67, 0xFF, 0xB4, 0x8C, 0x31, 0x0C, 0xFF, 0x94, 0x88,
+			0x42, 0x04, 0x10, 0x01, 0x89, 0xD8, 0x23, 0x5D, 0xCE, 0x18, 0x95, 0xA8, 0x7A, 0x4D, 0xD4, 0xA7,
+			0xC8, 0x2F, 0xF2, 0xD8, 0xDE, 0xAF, 0x67, 0xDB, 0xFF, 0xD0, 0xCF, 0xFF, 0xFB, 0x7F, 0xD4, 0x1C,
+			0xE5, 0xFF, 0xD6, 0xEE, 0x4D, 0xA9, 0x84, 0x21, 0xFF, 0xE3, 0x22, 0xC4, 0x02, 0x16, 0x02, 0x56,
+			0xD9, 0xBE, 0x40, 0x45, 0x4A, 0x13, 0x8D, 0xB8, 0xDD, 0x91, 0xD5, 0x7F, 0xC2, 0x03, 0xA0, 0x0C,
+			0x04, 0x2B, 0xF9, 0x19, 0x6C, 0x03, 0x42, 0x33, 0xCF, 0x73, 0x29, 0x95, 0x62, 0xBF, 0xEA, 0xD9,
+			0xD0, 0x83, 0x13, 0xD1, 0x09, 0x4F, 0x92, 0xC2, 0x5C, 0x59, 0x98, 0x4B, 0x3F, 0x49, 0xAF, 0x76,
+			0xA1, 0xC9, 0x75, 0x96, 0x86, 0x18, 0x67, 0xFD, 0x55, 0x18, 0xE7, 0x7E, 0xA8, 0xC7, 0xA1, 0x09,
+			0xFF, 0xFF, 0x9C, 0x8C, 0xEC, 0x1C, 0x2C, 0xA0, 0x7C, 0x38, 0x00, 0x11, 0xCF, 0x89, 0x4F, 0x7A,
+			0x76, 0x3B, 0x89, 0x7E, 0x9F, 0x7E, 0x82, 0x1F, 0xC4, 0x6E, 0xE8, 0x14, 0x47, 0x64, 0x88, 0xC8,
+			0x46, 0xFF, 0xE3, 0x20, 0xC4, 0x06, 0x15, 0x92, 0x52, 0xB4, 0x7E, 0x06, 0x04, 0x34, 0xE8, 0xE3,
+			0x50, 0x61, 0x81, 0x71, 0x6B, 0x1A, 0xD6, 0x38, 0xE5, 0x72, 0x9D, 0x19, 0x1C, 0xF8, 0xE4, 0xEE,
+			0x39, 0xFF, 0x45, 0xC8, 0x0D, 0xEB, 0x0C, 0x2C, 0x43, 0x5D, 0xAE, 0xAC, 0xC5, 0x75, 0xBF, 0x7C,
+			0x8D, 0x09, 0xA7, 0x6C, 0xC4, 0xA5, 0x99, 0xBF, 0xB5, 0x9D, 0x3A, 0x6C, 0xC9, 0xFE, 0x8E, 0xDF,
+			0xEA, 0xCC, 0xFF, 0xE4, 0x29, 0xE4, 0xB1, 0x4E, 0x14, 0x30, 0x8E, 0x59, 0x53, 0xEF, 0xA0, 0x36,
+			0x8C, 0xA3, 0x9A, 0x47, 0x63, 0x83, 0x86, 0x3F, 0xEF, 0xFF, 0xE5, 0xBD, 0x7F, 0xFB, 0x93, 0x61,
+			0x88, 0x0E, 0xBE, 0xEB, 0xAD, 0x56, 0xDB, 0x76, 0xFF, 0xFF, 0xE3, 0x22, 0xC4, 0x0A, 0x15, 0x8B,
+			0xEE, 0xEA, 0x5F, 0x4B, 0x28, 0x02, 0xDB, 0x24, 0xF8, 0x17, 0x63, 0x61, 0x20, 0xE7, 0xFE, 0xE2,
+			0x18, 0x68, 0x31, 0xDF, 0x39, 0x98, 0xC2, 0xE7, 0x18, 0x67, 0x35, 0x6A, 0x51, 0x48, 0xAF, 0xD1,
+			0x02, 0x46, 0xFF, 0x45, 0xA3, 0x6F, 0xAB, 0xD9, 0x73, 0x5E, 0xDF, 0xFE, 0x8D, 0xDB, 0x99, 0xDF,
+			0xFE, 0x4F, 0xFF, 0xFD, 0x10, 0xCB, 0xD6, 0x54, 0x7A, 0x7A, 0xB2, 0x3A, 0xB0, 0xC7, 0x6E, 0x95,
+			0x5A, 0xBC, 0x8F, 0xF3, 0x7F, 0xD2, 0x96, 0xFF, 0xFF, 0x9B, 0xFE, 0x8D, 0xF5, 0xA7, 0xA3, 0xFF,
+			0xA8, 0x33, 0xA6, 0x01, 0x00, 0x0D, 0x11, 0xE4, 0x46, 0xA3, 0x51, 0xF8, 0xFC, 0x7E, 0x2D, 0x1F,
+			0x0D, 0x47, 0xFF, 0xE3, 0x20, 0xC4, 0x0F, 0x16, 0x72, 0xBB, 0x9A, 0xFF, 0x83, 0x2D, 0xA2, 0xF7,
+			0xDC, 0x0E, 0x2C, 0x85, 0xB6, 0xF0, 0x6B, 0x4A, 0xDE, 0x82, 0x03, 0xD8, 0xC6, 0x7F, 0xA0, 0x77,
+			0x53, 0x7F, 0xCC, 0x62, 0x20, 0xAD, 0x58, 0xCA, 0x56, 0xFC, 0xEC, 0xA7, 0x62, 0x53, 0x5A, 0x7F,
+			0xC8, 0xCE, 0x51, 0x15, 0x63, 0x15, 0x8A, 0x86, 0xB7, 0xFF, 0x35, 0x33, 0x81, 0xB3, 0xB7, 0xD0,
+			0xB5, 0x95, 0xBF, 0xFF, 0x01, 0x58, 0x8A, 0x61, 0x25, 0x53, 0x48, 0x24, 0x8E, 0x24, 0x2C, 0xF5,
+			0x3F, 0xFF, 0x29, 0x5C, 0xBC, 0xBC, 0x14, 0x57, 0xF8, 0x95, 0x44, 0x23, 0x2A, 0x00, 0x4E, 0x64,
+			0xE0, 0x81, 0x9A, 0x0E, 0x24, 0x11, 0x50, 0x1A, 0x4C, 0xC4, 0xFF, 0xE3, 0x22, 0xC4, 0x10, 0x16,
+			0x98, 0xB5, 0xA8, 0x01, 0xD8, 0x30, 0x00, 0x0C, 0x6A, 0x35, 0x89, 0x6F, 0x83, 0x06, 0x68, 0x48,
+			0x41, 0x54, 0x78, 0xC2, 0x24, 0xE9, 0x78, 0x98, 0x94, 0x5A, 0x65, 0xFD, 0x87, 0x6C, 0xD6, 0x05,
+			0x00, 0x80, 0x51, 0x62, 0x44, 0xA9, 0xEA, 0xA9, 0xCD, 0x23, 0x2C, 0x48, 0x24, 0x0D, 0x3C, 0xA9,
+			0xD0, 0x55, 0xDF, 0xFF, 0x2B, 0xFF, 0xFF, 0x11, 0x7E, 0xA7, 0xEB, 0x05, 0x54, 0x1D, 0x2A, 0xB3,
+			0xBF, 0xFF, 0xFF, 0xF5, 0x9D, 0xFF, 0xFF, 0x2C, 0xF2, 0xBF, 0x95, 0x3A, 0x5A, 0x74, 0x15, 0x50,
+			0x75, 0x69, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0xFF, 0xE3, 0x20, 0xC4, 0x11, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x22, 0xC4, 0x6C,
+			0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x20, 0xC4, 0xC8, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x20, 0xC4,
+			0xFF, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x20,
+			0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x31, 0x32, 0x77, 0xB0, 0x61, 0x0C, 0xB0, 0x00, 0x42, 0x19,
+			0x76, 0x9E, 0xC1, 0x32, 0x69, 0xF3, 0x01, 0x00, 0x08, 0x16, 0x00, 0x00, 0x20, 0xE0, 0xE0, 0x30,
+			0x19, 0x36, 0x01, 0x85, 0xE9, 0x84, 0x08, 0x20, 0x34, 0x30, 0x27, 0x0F, 0x88, 0x3D, 0x60, 0x87,
+			0x28, 0x73, 0xE5, 0xC1, 0xF1, 0x19, 0xF0, 0x43, 0x74, 0x1F, 0x7A, 0xFF, 0x28, 0x18, 0x12, 0x1C,
+			0x0F, 0x94, 0x38, 0x08, 0x7F, 0xFF, 0x2E, 0x38, 0x1F, 0x78, 0x20, 0x18, 0x28, 0x71, 0xFF, 0xE3,
+			0x20, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00, 0x00, 0x60, 0xFC, 0x1F, 0x88, 0x0E,
+			0x14, 0x38, 0x5C, 0x1F, 0x83, 0xFF, 0x97, 0x3F, 0xFF, 0xFF, 0xFF, 0x5A, 0x00, 0x00, 0xFE, 0x97,
+			0x86, 0x9C, 0xFF, 0x71, 0xD8, 0x0F, 0x1F, 0xF1, 0x41, 0x03, 0x54, 0x7A, 0x11, 0x48, 0x7D, 0x0E,
+			0x7F, 0xCE, 0x1A, 0x0F, 0x41, 0xC6, 0x26, 0xC1, 0xDC, 0x73, 0xFC, 0xB1, 0x34, 0x16, 0x98, 0x10,
+			0x70, 0xBA, 0x0C, 0x20, 0x8C, 0x8D, 0xFF, 0xB2, 0x6F, 0x4D, 0xC7, 0x89, 0x71, 0xC6, 0xD3, 0x72,
+			0xAF, 0xE9, 0xA7, 0x37, 0x56, 0x4F, 0x2A, 0x1E, 0x63, 0xB0, 0xDD, 0x92, 0xFF, 0xFF, 0xD1, 0x4C,
+			0xFA, 0xFF, 0xFF, 0xA6, 0x9F, 0xFF, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x00,
+			0x00, 0x00, 0x00, 0xFA, 0xCC, 0x38, 0x36, 0x29, 0xFF, 0xFF, 0xFA, 0x65, 0xCD, 0x18, 0x78, 0xA9,
+			0x73, 0x8E, 0xFF, 0xD2, 0x51, 0x00, 0x00, 0x00, 0xFF, 0xF9, 0xED, 0x78, 0xB0, 0x3C, 0x13, 0x16,
+			0xA9, 0xA6, 0xB1, 0x0C, 0x23, 0x56, 0xB5, 0xEA, 0x47, 0xC7, 0xFD, 0x12, 0x7A, 0x53, 0x40, 0xFA,
+			0x90, 0x1E, 0xE4, 0x0F, 0x58, 0x61, 0x28, 0x82, 0x01, 0xD8, 0xC6, 0x5F, 0x92, 0xDD, 0x2E, 0x7B,
+			0x8C, 0xB8, 0x9A, 0x69, 0x82, 0x14, 0xF5, 0x6B, 0xDC, 0x50, 0x50, 0xED, 0x60, 0xE7, 0xEB, 0x15,
+			0x7E, 0xF3, 0xF9, 0xF5, 0x65, 0xFD, 0xB6, 0x14, 0x26, 0xEA, 0x3B, 0xF8, 0x7F, 0x93, 0xA4, 0xFF,
+			0xE3, 0x20, 0xC4, 0xFF, 0x16, 0x28, 0xAD, 0xA0, 0x03, 0x46, 0x30, 0x00, 0xCD, 0xFB, 0x3F, 0xA9,
+			0xDA, 0xDD, 0xFE, 0xAB, 0x7F, 0xC9, 0xA6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x08, 0x01, 0x29, 0x76, 0xB0, 0xFE, 0x7A, 0xD5, 0xBC, 0x41, 0xFF, 0x58, 0xEF, 0x45, 0xBE, 0x1F,
+			0x15, 0x6E, 0xA2, 0x40, 0x0B, 0xFC, 0xE0, 0xA0, 0x10, 0xB2, 0xB7, 0x60, 0xF1, 0xBE, 0xC6, 0x37,
+			0xCE, 0xE6, 0x37, 0x9C, 0x71, 0x4B, 0xEE, 0xC6, 0x6F, 0x3F, 0xE8, 0x5F, 0xD1, 0xBF, 0x42, 0xDF,
+			0xED, 0x7F, 0xAC, 0xC6, 0x7E, 0xE8, 0x63, 0x3B, 0x7D, 0x2D, 0xF4, 0x93, 0xF2, 0xEB, 0x98, 0xC2,
+			0xCE, 0xEB, 0xB9, 0x8C, 0xB2, 0xF3, 0x39, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x16, 0x71, 0xCA, 0x90,
+			0x01, 0x8F, 0x68, 0x00, 0x7E, 0x92, 0xD7, 0xCA, 0x2A, 0x6A, 0xF6, 0x1C, 0xF6, 0x96, 0x28, 0xC8,
+			0x98, 0xA7, 0x6E, 0xA6, 0x6A, 0x4A, 0x00, 0x00, 0x00, 0xC4, 0x59, 0x34, 0xE5, 0xB6, 0xC8, 0x55,
+			0x57, 0x61, 0xD0, 0x74, 0x18, 0x21, 0xD4, 0xC1, 0x45, 0xBF, 0xCC, 0x6F, 0xAA, 0x19, 0xFD, 0x50,
+			0x53, 0xFB, 0x98, 0xDE, 0x43, 0xAA, 0x52, 0x53, 0x15, 0x99, 0xF4, 0x72, 0x95, 0x57, 0xA9, 0x76,
+			0xF9, 0x9F, 0xEE, 0x61, 0x4F, 0xD0, 0xC6, 0x33, 0xFE, 0x67, 0xD2, 0xC5, 0xE8, 0x94, 0x75, 0x6E,
+			0x9D, 0xDF, 0xBE, 0xBF, 0xDA, 0x8D, 0xFB, 0x3A, 0xB7, 0xDD, 0x48, 0xFD, 0x0C, 0xEE, 0xBD, 0xDF,
+			0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x14, 0x89, 0x4E, 0xC0, 0x15, 0xC8, 0x40, 0x00, 0xBE, 0x95, 0x65,
+			0xF4, 0xDB, 0xDD, 0xDF, 0xBA, 0x7F, 0x56, 0x21, 0x7D, 0x14, 0x3F, 0x42, 0x00, 0x00, 0x00, 0x00,
+			0x81, 0x44, 0x43, 0x9A, 0xED, 0x6D, 0xDF, 0xFD, 0x1F, 0xFE, 0x81, 0x75, 0xA4, 0xF4, 0x28, 0xDF,
+			0xFD, 0xC9, 0x02, 0x46, 0x7E, 0x85, 0x1F, 0x56, 0x28, 0x51, 0x07, 0xD6, 0x56, 0x02, 0x10, 0xB5,
+			0x29, 0x8C, 0x72, 0x68, 0x6A, 0xB2, 0xBE, 0x5A, 0x9B, 0xEA, 0x54, 0x2C, 0xDC, 0xD2, 0xB7, 0xE8,
+			0xA5, 0xF4, 0x54, 0x2F, 0xAA, 0x03, 0x33, 0x7C, 0x81, 0xDD, 0xBE, 0x46, 0xFD, 0xFA, 0x19, 0xBD,
+			0x15, 0x1E, 0x96, 0x5A, 0xEE, 0xCF, 0xF6, 0x7F, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x16, 0x6B, 0x76,
+			0xC9, 0xF6, 0x03, 0x4A, 0x34, 0xAA, 0x17, 0xBA, 0x57, 0xC8, 0xFF, 0xBB, 0x7F, 0x7B, 0xFF, 0x9F,
+			0xE5, 0x52, 0x1F, 0xDC, 0x37, 0xF0, 0xAF, 0xD6, 0x00, 0x28, 0x13, 0xCA, 0x31, 0xAC, 0x05, 0xE8,
+			0x79, 0x3C, 0x71, 0x27, 0x15, 0xB0, 0x58, 0xD3, 0xD5, 0x24, 0x84, 0x14, 0x02, 0xAF, 0x53, 0x32,
+			0x8B, 0xCF, 0xF4, 0x1A, 0x6E, 0x92, 0x5A, 0x5F, 0x7B, 0xEB, 0xFF, 0xE9, 0xA6, 0x9A, 0xD3, 0x7D,
+			0x15, 0x7F, 0xEE, 0x82, 0x0D, 0x9A, 0x52, 0xE8, 0xCC, 0x55, 0xFF, 0x5B, 0xA6, 0x9A, 0x75, 0xA6,
+			0x82, 0x4F, 0x6F, 0xFF, 0xFF, 0x41, 0x06, 0xCD, 0x2E, 0xFA, 0xFF, 0xF5, 0x7F, 0xFF, 0xF3, 0x33,
+			0x74, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x15, 0xAB, 0xD6, 0xD9, 0x9E, 0x01, 0xC4, 0x2E, 0x08, 0x1C,
+			0x45, 0x4E, 0xAC, 0xEF, 0x92, 0x16, 0x7F, 0xFE, 0x4C, 0x1F, 0x28, 0x27, 0xA0, 0x9F, 0xFF, 0xD0,
+			0x20, 0x4D, 0xA8, 0xAC, 0xBE, 0xF5, 0x9F, 0x1E, 0x80, 0xFF, 0x66, 0x8E, 0x03, 0x4D, 0x6B, 0xC0,
+			0x90, 0x28, 0x26, 0xA5, 0xAB, 0x56, 0x9B, 0xD4, 0xF5, 0x2D, 0x56, 0xFF, 0x52, 0xD4, 0xB6, 0x7F,
+			0xFF, 0x75, 0x2D, 0x15, 0x2D, 0x1F, 0xFF, 0xD9, 0x25, 0x32, 0x94, 0x6A, 0x82, 0xF7, 0x45, 0x25,
+			0xB5, 0x2F, 0xFB, 0xA2, 0x9A, 0xD3, 0x4D, 0xA6, 0xC9, 0x01, 0x05, 0xCC, 0xC6, 0x03, 0xAD, 0xAB,
+			0x52, 0x1E, 0xB1, 0x65, 0xD3, 0x04, 0xDB, 0xFF, 0xF2, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x16, 0xBB,
+			0xD2, 0xFA, 0x5F, 0x48, 0x10, 0x02, 0x77, 0x8C, 0x70, 0x63, 0xAB, 0xEF, 0x4F, 0xFF, 0xEE, 0x15,
+			0xD0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x49, 0x6D, 0xB1, 0xB9, 0x27,
+			0xE8, 0xC0, 0x38, 0xD6, 0xD8, 0xF0, 0xA0, 0x2D, 0x2C, 0x6B, 0x31, 0x86, 0x29, 0xDC, 0xE7, 0xB4,
+			0x63, 0x3B, 0x66, 0x65, 0x74, 0xE5, 0x72, 0x19, 0xD6, 0xE4, 0x54, 0x46, 0xBA, 0x22, 0xAA, 0xD2,
+			0x8C, 0x31, 0x9E, 0xFE, 0xD4, 0xF4, 0x6B, 0xD2, 0x76, 0x45, 0x5F, 0xE7, 0xFC, 0x8D, 0xB7, 0xFF,
+			0xEE, 0xD5, 0x25, 0x08, 0xC7, 0x3B, 0x1E, 0xA7, 0x46, 0xAB, 0x21, 0x2F, 0x42, 0x4F, 0xEA, 0x75,
+			0xA9, 0xD2, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x16, 0xC2, 0xF6, 0x8C, 0x01, 0x92, 0x68, 0x00, 0x4F,
+			0xBF, 0xB3, 0xFF, 0xF7, 0xFF, 0xF7, 0xDD, 0xFB, 0x7F, 0xFF, 0xFC, 0x30, 0x1A, 0x7F, 0xEA, 0x89,
+			0x00, 0x00, 0x09, 0x4B, 0x6D, 0xB1, 0x39, 0x6F, 0xD4, 0x24, 0x2C, 0xFA, 0x98, 0x22, 0x05, 0x1D,
+			0x73, 0x91, 0xEA, 0xF3, 0x90, 0xB5, 0x6D, 0x4B, 0x4B, 0xEE, 0x65, 0x4B, 0x52, 0x6D, 0x6B, 0x5D,
+			0x0C, 0x5B, 0xF6, 0x0C, 0x63, 0x5C, 0x96, 0x4D, 0x37, 0x6C, 0xBE, 0xEC, 0xF5, 0x79, 0x36, 0xA5,
+			0x37, 0xAF, 0x64, 0x29, 0xBF, 0xFF, 0xFD, 0x48, 0x71, 0x34, 0x83, 0x61, 0xD9, 0x55, 0xE7, 0x43,
+			0xB4, 0x96, 0x7B, 0x0E, 0x9D, 0xFF, 0xE0, 0x59, 0xD2, 0x04, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x14,
+			0xBA, 0x06, 0xAC, 0x01, 0x8D, 0x68, 0x00, 0x40, 0x42, 0xA3, 0x16, 0x35, 0x82, 0x4E, 0xD3, 0x39,
+			0x10, 0xD8, 0x40, 0x0A, 0x46, 0xA1, 0x54, 0x00, 0x00, 0x00, 0x00, 0x80, 0x10, 0x2A, 0xE2, 0x2E,
+			0xAE, 0x13, 0x0B, 0x86, 0x63, 0x31, 0xA8, 0xB2, 0xF9, 0x7F, 0x0B, 0xE1, 0xAB, 0xD9, 0xF6, 0x2D,
+			0xBC, 0xEE, 0x73, 0x7D, 0x14, 0xF3, 0xBB, 0x1D, 0xEA, 0x5B, 0x27, 0xF6, 0x90, 0x8C, 0xAD, 0xA9,
+			0x53, 0xFC, 0x8C, 0x4C, 0x86, 0xE5, 0x95, 0x97, 0xFE, 0x0C, 0x5F, 0x40, 0x06, 0x11, 0xFF, 0xA2,
+			0xFF, 0xF9, 0x24, 0xCE, 0x8C, 0xF9, 0xCA, 0x5F, 0xFF, 0xFF, 0xFF, 0x46, 0x6B, 0x39, 0x19, 0x8E,
+			0x7E, 0x20, 0xB6, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x16, 0x1B, 0xCE, 0xD8, 0x7F, 0xC7, 0x10, 0x03,
+			0x0A, 0xF2, 0x5F, 0xFE, 0x0F, 0xCA, 0x13, 0x07, 0xC0, 0xE1, 0xF0, 0x7D, 0x21, 0xF4, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x02, 0x4D, 0xA6, 0xDB, 0x68, 0xE9, 0x1C, 0x6D, 0xBB, 0x4D, 0x8E, 0xAE, 0x73,
+			0xB2, 0x23, 0x9E, 0xC6, 0x77, 0x2C, 0xAD, 0x5E, 0xB7, 0xEF, 0xF8, 0xBC, 0xB3, 0xAF, 0xFF, 0xFE,
+			0xBD, 0x66, 0xFF, 0x5A, 0x9A, 0xE7, 0x65, 0xBA, 0xD2, 0x63, 0x37, 0xE8, 0xDD, 0xBB, 0xBF, 0x72,
+			0x77, 0xB2, 0x5E, 0x25, 0xEF, 0xF4, 0xD4, 0xF3, 0xA2, 0xBF, 0xEA, 0xA9, 0x74, 0xD1, 0x76, 0x7F,
+			0xFF, 0xFA, 0xBD, 0xD9, 0x64, 0xD1, 0xD4, 0xC8, 0x21, 0xAA, 0x4D, 0xFF, 0xE3, 0x22, 0xC4, 0xFF,
+			0x15, 0xE2, 0x42, 0xD8, 0x7F, 0x45, 0x10, 0x02, 0xAA, 0x39, 0xA2, 0xC8, 0x57, 0x6A, 0x08, 0xA8,
+			0xE0, 0x37, 0xFF, 0xFF, 0x8B, 0xAE, 0x77, 0xF8, 0xEC, 0x51, 0x26, 0x00, 0xA9, 0x35, 0x2D, 0xF6,
+			0x87, 0xD6, 0xCA, 0x77, 0xF2, 0x6A, 0xEC, 0x9D, 0x64, 0xA5, 0x84, 0x61, 0x02, 0x70, 0x74, 0x55,
+			0x41, 0xE9, 0xC6, 0x13, 0x34, 0xD7, 0xAA, 0x91, 0x43, 0x48, 0xE6, 0xFF, 0x5A, 0x56, 0xBC, 0xDF,
+			0xD4, 0xEB, 0x37, 0xF4, 0xB9, 0xDF, 0x9C, 0x72, 0xF6, 0x1E, 0x1B, 0x1E, 0x6B, 0x08, 0xA8, 0x3A,
+			0x6B, 0x4D, 0x63, 0xB5, 0x5F, 0xCD, 0x36, 0x87, 0x39, 0xCE, 0xBF, 0x35, 0xA7, 0x21, 0xDF, 0xD1,
+			0xCE, 0xE7, 0x0F, 0x0D, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x15, 0x63, 0x27, 0x35, 0x3F, 0x82, 0x13,
+			0x0E, 0x8E, 0xFF, 0xF8, 0x35, 0xF7, 0x65, 0x60, 0x59, 0x6F, 0xFB, 0x7F, 0xFF, 0xE4, 0xD3, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x0F, 0xE8, 0x9D, 0xBA, 0x2C, 0x44, 0x21, 0x3C, 0x9A, 0x93, 0x1D, 0xA0,
+			0x25, 0x3C, 0x22, 0x05, 0x41, 0x50, 0x10, 0x14, 0xEC, 0x15, 0x0D, 0x2C, 0x1A, 0x2A, 0x0A, 0xA9,
+			0xED, 0x23, 0x96, 0x0A, 0x1E, 0x74, 0x15, 0x11, 0x1E, 0x89, 0x7F, 0x79, 0x53, 0xD2, 0xC7, 0x82,
+			0x8F, 0x53, 0xF2, 0xCF, 0x05, 0x4E, 0xE2, 0x57, 0x36, 0xC0, 0xD0, 0x86, 0x5A, 0x58, 0x60, 0x35,
+			0xF8, 0x2A, 0xC9, 0x14, 0x7A, 0x3E, 0x0A, 0x88, 0x87, 0x82, 0xA1, 0xD1, 0xFF, 0xE3, 0x22, 0xC4,
+			0xFF, 0x16, 0x8C, 0x1A, 0xB0, 0xCB, 0x81, 0x28, 0x01, 0x64, 0x03, 0x55, 0x3D, 0x02, 0x2E, 0x0D,
+			0x54, 0x78, 0x92, 0x83, 0x45, 0x4E, 0xF1, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9A, 0x92, 0x8B,
+			0x6B, 0x85, 0x92, 0x22, 0x28, 0x48, 0x10, 0xB1, 0x04, 0xD0, 0x1A, 0x48, 0xD3, 0x8B, 0x28, 0xF3,
+			0x09, 0xAC, 0x16, 0x16, 0x16, 0x16, 0x15, 0x15, 0x15, 0x15, 0x30, 0xB1, 0x51, 0x51, 0x51, 0x61,
+			0x61, 0x66, 0x81, 0x82, 0x42, 0xC2, 0xC0, 0xE1, 0x9F, 0xFF, 0x50, 0xB0, 0xB0, 0xB1, 0xA0, 0x58,
+			0x24, 0x2C, 0x0E, 0x01, 0x81, 0x61, 0x61, 0x60, 0x70, 0x04, 0x2C, 0x2C, 0x24, 0x36, 0x30, 0x58,
+			0x59, 0x0E, 0x16, 0x16, 0x6F, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x15, 0x52, 0x86, 0x78, 0x01, 0xC9,
+			0x38, 0x00, 0xFE, 0xB1, 0x56, 0x25, 0xE2, 0xA2, 0xAC, 0xFF, 0xFF, 0xF1, 0x5D, 0xE2, 0xA2, 0xB3,
+			0x0B, 0x15, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x22,
+			0xC4, 0xFF, 0x15, 0xA8, 0x56, 0x5C, 0x36, 0x08, 0x46, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x16, 0x40, 0x70, 0xE0, 0x00,
+			0x31, 0x8C, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3,
+			0x22, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x80, 0x10, 0x21, 0x04, 0x0F, 0x94, 0x83, 0x77, 0xE0, 0x33, 0x86, 0xD7, 0xE2, 0x50, 0x26, 0xFF,
+			0x05, 0x6C, 0x4A, 0x82, 0x71, 0xFE, 0x0A, 0x81, 0xCE, 0x3D, 0x0B, 0x3F, 0xF2, 0xF0, 0xC0, 0x0C,
+			0x82, 0xFA, 0xBF, 0xFD, 0xD9, 0x34, 0xCE, 0x12, 0x9F, 0xFF, 0x8B, 0x42, 0x5C, 0x94, 0x28, 0x92,
+			0x41, 0xCC, 0x0B, 0xE7, 0xFF, 0xFE, 0x49, 0x9B, 0x90, 0xCD, 0x0D, 0xCD, 0xC0, 0x7F, 0xFE, 0xA0,
+			0xC0, 0x7C, 0xD0, 0x7D, 0x1F, 0xFF, 0xE5, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48,
+			0x00, 0x00, 0x00, 0x00, 0xC8, 0x0D, 0x03, 0x88, 0x0C, 0x82, 0x1F, 0xFF, 0xFF, 0x50, 0x61, 0xFD,
+			0x61, 0xF7, 0x7F, 0xE8, 0x00, 0x00, 0x00, 0xF1, 0x9F, 0x42, 0x94, 0xBB, 0x31, 0xCB, 0xEA, 0x7A,
+			0x0A, 0x48, 0xF9, 0x06, 0xD4, 0xDB, 0x7F, 0xF7, 0x38, 0xD6, 0xFF, 0xA9, 0xEE, 0x8E, 0x3A, 0x71,
+			0x25, 0xFE, 0xCA, 0x7F, 0x3E, 0xE2, 0x62, 0x47, 0x1C, 0x3D, 0xFF, 0x3D, 0xC9, 0xBB, 0x32, 0x9F,
+			0x30, 0x78, 0x6C, 0x23, 0x0D, 0xDC, 0x6A, 0x4B, 0xFF, 0xF8, 0x96, 0xF3, 0xD1, 0xB9, 0xEE, 0x26,
+			0x08, 0x85, 0x4C, 0x36, 0x19, 0x57, 0x27, 0x3B, 0xFF, 0xFB, 0xCC, 0x31, 0xBB, 0x66, 0x36, 0xFF,
+			0xE3, 0x22, 0xC4, 0xFF, 0x00, 0x00, 0x03, 0x48, 0x01, 0x40, 0x00, 0x00, 0x48, 0xA8, 0xF2, 0x9A,
+			0xCE, 0xD2, 0xE6, 0x5F, 0xFF, 0xFF, 0xF6, 0x0F, 0x11, 0x8A, 0xAA, 0xE4, 0xB7, 0xFF, 0x24, 0xB0,
+			0x0D, 0xFF, 0x7F, 0xFF, 0xFB, 0xDC, 0xED, 0x70, 0x13, 0x11, 0xCC, 0xD7, 0xDF, 0xE5, 0x87, 0x44,
+			0x82, 0x62, 0xCA, 0x52, 0x65, 0xBF, 0x38, 0xB3, 0xCF, 0x92, 0x10, 0x94, 0xB4, 0xE8, 0x1D, 0xEF,
+			0xD2, 0x4E, 0xDD, 0x4F, 0xB5, 0xFB, 0x33, 0xAA, 0x2B, 0x24, 0xF5, 0x35, 0xD9, 0x90, 0x42, 0x81,
+			0xA8, 0x51, 0xB3, 0xA3, 0x03, 0x88, 0x60, 0x32, 0xEB, 0x94, 0x1D, 0x86, 0x94, 0xDD, 0xE0, 0x52,
+			0xBA, 0x00, 0x3A, 0x4B, 0x0E, 0x6A, 0xB5, 0x50, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x16, 0x01, 0xD5,
+			0xC4, 0x35, 0x90, 0x68, 0x00, 0xD4, 0xA0, 0xA9, 0xD0, 0xD7, 0xEA, 0xF3, 0xA9, 0xB7, 0x0D, 0x28,
+			0xEA, 0x69, 0x7D, 0x93, 0x1D, 0x7D, 0x89, 0x00, 0x0F, 0xFF, 0xBC, 0x63, 0x18, 0xB6, 0xCE, 0x71,
+			0x3E, 0x45, 0x99, 0x32, 0xC9, 0x2C, 0xAC, 0x08, 0xA3, 0xAF, 0x76, 0xDD, 0x22, 0xD2, 0xB3, 0xB3,
+			0x9D, 0x64, 0x8B, 0x5E, 0x5B, 0x4A, 0xAF, 0x5F, 0x01, 0xE3, 0x74, 0x79, 0x79, 0xFA, 0xF6, 0x00,
+			0x0F, 0x0C, 0x67, 0x78, 0x8F, 0x32, 0x9C, 0xF9, 0xA6, 0xBD, 0xF2, 0x2F, 0x3C, 0xE1, 0x4B, 0x03,
+			0x93, 0xA1, 0x30, 0xC6, 0x14, 0x09, 0x18, 0x46, 0x10, 0x8B, 0xDD, 0xF4, 0xFF, 0xFF, 0xEF, 0x3E,
+			0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x16, 0xE3, 0x12, 0xA4, 0x01, 0x82, 0x38, 0x00, 0x7E, 0xA5, 0x27,
+			0xFF, 0xFF, 0xAE, 0xD6, 0x82, 0x62, 0x7A, 0x45, 0x7F, 0x4B, 0x7A, 0x93, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x15, 0x84, 0xE4, 0x8D, 0xBB, 0x6E, 0xFF, 0xFF, 0x72, 0x41, 0x4B, 0xF4, 0x55, 0x2F, 0xE8,
+			0xB5, 0x5E, 0x47, 0x95, 0x57, 0xE9, 0x9A, 0xAD, 0xAE, 0x64, 0xC4, 0x6E, 0xF2, 0x9B, 0x67, 0x96,
+			0x6D, 0xF4, 0xBC, 0xCE, 0xDE, 0xDD, 0x8D, 0x29, 0xFA, 0x48, 0x70, 0xF6, 0x53, 0x9C, 0xDA, 0x2D,
+			0x58, 0xA1, 0x10, 0x26, 0x46, 0x95, 0xE8, 0x69, 0x01, 0x5E, 0xA6, 0x8F, 0x7C, 0x31, 0xA1, 0x4B,
+			0x28, 0x80, 0xEB, 0x23, 0x1E, 0xBF, 0xFD, 0xEF, 0x4D, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x16, 0x59,
+			0x6E, 0xAC, 0x0D, 0xCC, 0x10, 0x00, 0x57, 0x8B, 0xB4, 0x4C, 0x5C, 0x4A, 0x00, 0x11, 0xBE, 0x23,
+			0x18, 0xE7, 0xAF, 0x78, 0x38, 0xE8, 0xB0, 0xAA, 0x00, 0x6A, 0x29, 0xA0, 0x90, 0x03, 0xA3, 0x9A,
+			0x85, 0xD8, 0x17, 0x0D, 0x53, 0x3C, 0xD0, 0xA4, 0xB7, 0xC6, 0x25, 0xFE, 0x76, 0x46, 0xAA, 0x9C,
+			0xF4, 0xC2, 0x6A, 0xB9, 0xA7, 0x90, 0x22, 0xEF, 0x16, 0x06, 0x46, 0x8F, 0xBE, 0x09, 0xBC, 0xF2,
+			0xCA, 0x56, 0xCD, 0xB8, 0xDF, 0xA8, 0x2F, 0x9B, 0x97, 0x70, 0xBC, 0xFF, 0x57, 0xAD, 0xF5, 0x8B,
+			0xC9, 0x3A, 0xB9, 0xA8, 0x79, 0x2C, 0xCB, 0xC5, 0xC0, 0x71, 0xA7, 0xB7, 0x7F, 0x54, 0xC9, 0x77,
+			0x94, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x15, 0x91, 0xA2, 0xB8, 0x0C, 0x7B, 0x06, 0x5C, 0x87, 0x87,
+			0x97, 0x47, 0xC6, 0x48, 0x3E, 0x9D, 0x3F, 0xFD, 0x58, 0x95, 0xF1, 0x67, 0xD0, 0xCD, 0x29, 0x00,
+			0x00, 0x00, 0x10, 0x94, 0xB6, 0xCF, 0xE8, 0x00, 0xC0, 0x49, 0x7C, 0x1D, 0x01, 0x50, 0xF6, 0xBE,
+			0x45, 0x5B, 0xE1, 0x99, 0xBE, 0x52, 0xB6, 0xA5, 0x2B, 0x95, 0x0C, 0x63, 0x1A, 0x85, 0x29, 0x4B,
+			0x95, 0x94, 0xC6, 0x56, 0xB1, 0x9D, 0x7A, 0x97, 0xD1, 0xFC, 0xCF, 0x94, 0xA5, 0x6C, 0xA5, 0x31,
+			0x94, 0xBA, 0x1A, 0x61, 0x5B, 0x4C, 0xFF, 0x6F, 0xFF, 0xEB, 0xF2, 0x99, 0xFC, 0xC2, 0x8F, 0x29,
+			0xE7, 0x6D, 0xD0, 0x8A, 0x96, 0x0A, 0x9E, 0x77, 0xFF, 0xEB, 0xFF, 0xE3, 0x20, 0xC4, 0xFF, 0x16,
+			0x69, 0xA3, 0x0A, 0x5E, 0x01, 0x46, 0x0A, 0x71, 0x14, 0x28, 0xF0, 0x98, 0xA9, 0xD5, 0x01, 0x4F,
+			0x54, 0x7A, 0xB3, 0xB1, 0x2B, 0xE5, 0x9F, 0xA9, 0xEB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0xFF, 0xE3, 0x22, 0xC4, 0xFF, 0x16, 0x19, 0x96, 0xB8, 0x04, 0x51, 0x92, 0xB0, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xE3, 0x20, 0xC4, 0xFF,
+			0x16, 0x82, 0x3E, 0xB0, 0x17, 0x48, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00,
+		};
+		return data;
+	}
+
+	Audio::SeekableAudioStream *createStream() {
+		return Audio::makeMP3Stream(new Common::MemoryReadStream(mp3Data(), 4179), DisposeAfterUse::YES);
+	}
+#endif
+
+	public:
+	void test_seek_bit_reservoir() {
+#ifdef USE_MAD
+		// 576 samples per frame
+		const int totalSamples = 40 * 576;
+
+		Audio::SeekableAudioStream *s = createStream();
+		TS_ASSERT_EQUALS(s->getRate(), 11025);
+
+		int16 *whole = new int16[totalSamples];
+		TS_ASSERT_EQUALS(s->readBuffer(whole, totalSamples), totalSamples);
+		delete s;
+
+		// A seek has to give the same samples as decoding from the start,
+		// both at the start of a frame and inside one
+		static const int positions[] = { 0, 576, 5 * 576 + 100, 12 * 576, 20 * 576 + 17, 33 * 576, 39 * 576 + 400 };
+		int16 buffer[1024];
+
+		for (int i = 0; i < ARRAYSIZE(positions); i++) {
+			const int pos = positions[i];
+			const int len = MIN(1024, totalSamples - pos);
+
+			s = createStream();
+			TS_ASSERT(s->seek(Audio::Timestamp(0, pos, 11025)));
+			TS_ASSERT_EQUALS(s->readBuffer(buffer, len), len);
+			TS_ASSERT_EQUALS(memcmp(buffer, whole + pos, len * sizeof(int16)), 0);
+			delete s;
+		}
+
+		delete[] whole;
+#endif
+	}
+
+	void test_seek_end() {
+#ifdef USE_MAD
+		// Seeking to the very end is valid and leaves nothing to read
+		const int totalSamples = 40 * 576;
+		int16 buffer[16];
+
+		Audio::SeekableAudioStream *s = createStream();
+		TS_ASSERT(s->seek(Audio::Timestamp(0, totalSamples, 11025)));
+		TS_ASSERT(s->endOfData());
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, ARRAYSIZE(buffer)), 0);
+
+		TS_ASSERT(!s->seek(Audio::Timestamp(0, totalSamples + 1, 11025)));
+		delete s;
+#endif
+	}
+};
@@ -0,0 +1,204 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#ifdef USE_MT32EMU
+
+#include "audio/softsynth/mt32/mt32emu.h"
+#include "audio/softsynth/mt32/AReverbModel.h"
+
+#endif
+
+class MT32ReverbTestSuite : public CxxTest::TestSuite
+{
+	uint32 _seed;
+
+	// Deterministic noise in the range [-1, 1]
+	float noise() {
+		_seed = _seed * 1103515245 + 12345;
+		return ((int)((_seed >> 16) % 2001) - 1000) / 1000.0f;
+	}
+
+	// A copy of the accurate reverb model as it was before it was changed to
+	// process blocks, running the whole filter chain for every sample
+	class ReferenceReverb {
+		struct Ring {
+			float *buffer;
+			uint32 size, index;
+
+			Ring() : buffer(0), size(0), index(0) {}
+			~Ring() { delete[] buffer; }
+
+			void open(uint32 newSize) {
+				size = newSize;
+				buffer = new float[size];
+				memset(buffer, 0, size * sizeof(float));
+			}
+
+			float next() {
+				if (++index >= size)
+					index = 0;
+				return buffer[index];
+			}
+		};
+
+		struct Allpass : Ring {
+			float process(const float in) {
+				const float bufferOut = next();
+				buffer[index] = in - 0.5f * bufferOut;
+				return bufferOut + 0.5f * buffer[index];
+			}
+		};
+
+		struct Comb : Ring {
+			float feedbackFactor, filterFactor;
+
+			void process(const float in) {
+				float last = buffer[index];
+				float filterIn = in + next() * feedbackFactor;
+				buffer[index] = filterFactor * last - filterIn;
+			}
+
+			float getOutputAt(const uint32 outIndex) const {
+				return buffer[(size + index - outIndex) % size];
+			}
+		};
+
+		Allpass _allpasses[3];
+		Comb _combs[4];
+		const uint32 *_outL, *_outR;
+		float _wetLevel;
+
+	public:
+		// The settings of the three modes for reverb time 5 and level 7
+		ReferenceReverb(int mode) {
+			static const uint32 allpassSizes[3][3] = { {994, 729, 78}, {1324, 809, 176}, {969, 644, 157} };
+			static const uint32 combSizes[3][4] = { {706, 2349, 2839, 3632}, {962, 2619, 3545, 4519}, {117, 2259, 2839, 3539} };
+			static const uint32 outL[3][3] = { {2349, 141, 1960}, {2618, 1760, 4518}, {2259, 718, 1769} };
+			static const uint32 outR[3][3] = { {1174, 1570, 145}, {1300, 3532, 2274}, {1136, 2128, 1} };
+			static const uint32 filterFactors[3][4] = { {0x3C, 0x60, 0x60, 0x60}, {0x30, 0x60, 0x60, 0x60}, {0, 0x20, 0x20, 0x20} };
+			static const uint32 feedback[3][4] = { {0x00, 0x88, 0x88, 0x88}, {0x00, 0x80, 0x88, 0x88}, {0x00, 0xB8, 0xB8, 0xB8} };
+			static const uint32 level7[3] = { 13 * 15, 14 * 15, 14 * 15 };
+			static const uint32 lpfAmp[3] = { 6, 6, 8 };
+
+			for (int i = 0; i < 3; i++)
+				_allpasses[i].open(allpassSizes[mode][i]);
+			for (int i = 0; i < 4; i++) {
+				_combs[i].open(combSizes[mode][i]);
+				_combs[i].filterFactor = filterFactors[mode][i] / 256.0f;
+				_combs[i].feedbackFactor = feedback[mode][i] / 256.0f;
+			}
+			_outL = outL[mode];
+			_outR = outR[mode];
+			_wetLevel = 0.5f * (lpfAmp[mode] / 16.0f) * level7[mode] / 256.0f;
+		}
+
+		void process(const float *inLeft, const float *inRight, float *outLeft, float *outRight, unsigned long numSamples) {
+			float dry, link, outL1;
+
+			for (unsigned long i = 0; i < numSamples; i++) {
+				dry = _wetLevel * (*inLeft + *inRight);
+
+				link = _combs[0].getOutputAt(_combs[0].size - 1);
+				_combs[0].process(-dry);
+
+				link = _allpasses[0].process(link);
+				link = _allpasses[1].process(link);
+				link = _allpasses[2].process(link);
+
+				outL1 = 1.5f * _combs[1].getOutputAt(_outL[0] - 1);
+
+				_combs[1].process(link);
+				_combs[2].process(link);
+				_combs[3].process(link);
+
+				link = outL1 + 1.5f * _combs[2].getOutputAt(_outL[1]);
+				link += _combs[3].getOutputAt(_outL[2]);
+				*outLeft = link;
+
+				link = 1.5f * _combs[1].getOutputAt(_outR[0]);
+				link += 1.5f * _combs[2].getOutputAt(_outR[1]);
+				link += _combs[3].getOutputAt(_outR[2]);
+				*outRight = link;
+
+				inLeft++;
+				inRight++;
+				outLeft++;
+				outRight++;
+			}
+		}
+	};
+
+	public:
+	void test_allpass_block() {
+#if defined(USE_MT32EMU) && MT32EMU_USE_REVERBMODEL == 1
+		// Processing a block at once has to give the same result as processing sample by sample,
+		// also when the block wraps around the end of the ring buffer several times
+		MT32Emu::AllpassFilter blockFilter(78), sampleFilter(78);
+		float in[1000], out[1000];
+
+		_seed = 1;
+		blockFilter.mute();
+		sampleFilter.mute();
+
+		for (int i = 0; i < 1000; i++)
+			in[i] = out[i] = noise();
+
+		blockFilter.process(out, 1000);
+		for (int i = 0; i < 1000; i++)
+			TS_ASSERT_DELTA(out[i], sampleFilter.process(in[i]), 1e-6f);
+#endif
+	}
+
+	void test_reverb_reference() {
+#if defined(USE_MT32EMU) && MT32EMU_USE_REVERBMODEL == 1
+		// The block based reverb has to give the same output as the original per-sample
+		// implementation, in all three modes
+		for (int mode = MT32Emu::REVERB_MODE_ROOM; mode <= MT32Emu::REVERB_MODE_PLATE; mode++) {
+			MT32Emu::AReverbModel model((MT32Emu::ReverbMode)mode);
+			ReferenceReverb reference(mode);
+			model.open();
+			model.setParameters(5, 7);
+
+			_seed = 1;
+			const int length = 12000;
+			float *inLeft = new float[length];
+			float *inRight = new float[length];
+			float *outLeft = new float[length];
+			float *outRight = new float[length];
+			float *refLeft = new float[length];
+			float *refRight = new float[length];
+
+			// Half a second of noise followed by the decay
+			for (int i = 0; i < length; i++) {
+				inLeft[i] = i < 8000 ? noise() : 0.0f;
+				inRight[i] = i < 8000 ? noise() : 0.0f;
+			}
+
+			// Use odd block lengths, so the blocks don't line up with the internal block size
+			for (int pos = 0; pos < length; pos += 999)
+				model.process(inLeft + pos, inRight + pos, outLeft + pos, outRight + pos, MIN(999, length - pos));
+
+			reference.process(inLeft, inRight, refLeft, refRight, length);
+
+			int firstDifference = -1;
+			bool silent = true;
+			for (int i = 0; i < length; i++) {
+				if (firstDifference < 0 && (outLeft[i] != refLeft[i] || outRight[i] != refRight[i]))
+					firstDifference = i;
+				if (refLeft[i] != 0.0f || refRight[i] != 0.0f)
+					silent = false;
+			}
+			TS_ASSERT_EQUALS(firstDifference, -1);
+			TS_ASSERT(!silent);
+
+			delete[] inLeft;
+			delete[] inRight;
+			delete[] outLeft;
+			delete[] outRight;
+			delete[] refLeft;
+			delete[] refRight;
+		}
+#endif
+	}
+};
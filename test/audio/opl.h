@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#include "audio/softsynth/opl/mame.h"
+
+#include "helper.h"
+
+class MAMEOPLTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kRate = 22050,
+		kSteps = 48,
+		kMaxSamples = kSteps * 1024
+	};
+
+	uint32 _seed;
+
+	uint nextRandom(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) % max;
+	}
+
+	// Plays a deterministic stream of notes, key offs and rhythm mode changes
+	// and renders the samples in between in pieces of at most chunkSize
+	// samples. Returns the number of samples rendered.
+	int render(int16 *buffer, int chunkSize) {
+		static const int slotOffset[9] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+
+		OPL::MAME::FM_OPL *opl = OPL::MAME::makeAdLibOPL(kRate);
+		// Fixed seed for the rhythm noise
+		opl->rnd->setSeed(1);
+		OPL::MAME::OPLWriteReg(opl, 0x01, 0x20);
+
+		_seed = 1;
+		int pos = 0;
+		for (int step = 0; step < kSteps; ++step) {
+			const int channel = nextRandom(9);
+			if (nextRandom(3)) {
+				for (int op = 0; op < 2; ++op) {
+					const int slot = slotOffset[channel] + op * 3;
+					OPL::MAME::OPLWriteReg(opl, 0x20 + slot, nextRandom(256));
+					OPL::MAME::OPLWriteReg(opl, 0x40 + slot, op ? nextRandom(32) : nextRandom(256));
+					OPL::MAME::OPLWriteReg(opl, 0x60 + slot, 0xA0 | nextRandom(96));
+					OPL::MAME::OPLWriteReg(opl, 0x80 + slot, nextRandom(256));
+					OPL::MAME::OPLWriteReg(opl, 0xE0 + slot, nextRandom(4));
+				}
+				OPL::MAME::OPLWriteReg(opl, 0xC0 + channel, nextRandom(16));
+				OPL::MAME::OPLWriteReg(opl, 0xA0 + channel, nextRandom(256));
+				OPL::MAME::OPLWriteReg(opl, 0xB0 + channel, 0x20 | nextRandom(32));
+			} else {
+				// Key off, most channels run into EG_OFF during the next step
+				OPL::MAME::OPLWriteReg(opl, 0xB0 + channel, nextRandom(32));
+			}
+
+			// Rhythm mode for a part of the stream
+			if (step >= 24 && step < 36)
+				OPL::MAME::OPLWriteReg(opl, 0xBD, 0xE0 | nextRandom(32));
+			else
+				OPL::MAME::OPLWriteReg(opl, 0xBD, nextRandom(2) << 6);
+
+			const int length = 512 + nextRandom(512);
+			for (int done = 0; done < length; done += chunkSize)
+				OPL::MAME::YM3812UpdateOne(opl, buffer + pos + done, MIN(chunkSize, length - done));
+			pos += length;
+		}
+
+		OPL::MAME::OPLDestroy(opl);
+		return pos;
+	}
+
+	public:
+	void test_block_rendering() {
+		// Rendering several blocks at once has to give the same samples as
+		// rendering them one by one
+		TestSystem system;
+		int16 *blockBuffer = new int16[kMaxSamples];
+		int16 *sampleBuffer = new int16[kMaxSamples];
+
+		const int length = render(blockBuffer, kMaxSamples);
+		TS_ASSERT_EQUALS(render(sampleBuffer, 1), length);
+
+		int firstDifference = -1;
+		int nonZero = 0;
+		for (int i = 0; i < length; ++i) {
+			if (firstDifference < 0 && blockBuffer[i] != sampleBuffer[i])
+				firstDifference = i;
+			if (blockBuffer[i])
+				++nonZero;
+		}
+		TS_ASSERT_EQUALS(firstDifference, -1);
+		TS_ASSERT_LESS_THAN(length / 2, nonZero);
+
+		delete[] blockBuffer;
+		delete[] sampleBuffer;
+	}
+
+	void test_reference_output() {
+		// Checksum of the samples the per sample implementation generated
+		// before rendering was changed to blocks
+		TestSystem system;
+		int16 *buffer = new int16[kMaxSamples];
+		const int length = render(buffer, 300);
+
+		uint32 checksum = 0;
+		for (int i = 0; i < length; ++i)
+			checksum = checksum * 31 + (uint16)buffer[i];
+
+		TS_ASSERT_EQUALS(checksum, 3620576913u);
+
+		delete[] buffer;
+	}
+};
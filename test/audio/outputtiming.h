@@ -0,0 +1,80 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+
+class OutputTimingTestSuite : public CxxTest::TestSuite
+{
+	// Feed the timing with the timestamps of a made up device which asks
+	// for 'frames' sample frames each period, with callbacks arriving up to
+	// 'jitter' ms late. No audio device is involved. Returns the time of
+	// the last callback.
+	uint32 addCallbacks(Audio::OutputTiming &timing, uint rate, uint frames, uint callbacks, uint32 jitter, uint32 start = 0) {
+		uint32 time = start;
+		for (uint i = 0; i < callbacks; ++i) {
+			const uint64 ideal = (uint64)i * frames * 1000000 / rate;
+			time = start + (uint32)(ideal / 1000) + (jitter ? (i * 7) % (jitter + 1) : 0);
+			timing.addCallback(time, frames);
+		}
+		return time;
+	}
+
+	public:
+	void test_latency() {
+		Audio::OutputTiming timing;
+		TS_ASSERT_EQUALS(timing.getLatency(), (uint)0);
+
+		timing.reset(44100, 2048);
+		TS_ASSERT_EQUALS(timing.getLatency(), (uint)46);
+
+		timing.reset(22050, 4096);
+		TS_ASSERT_EQUALS(timing.getLatency(), (uint)186);
+	}
+
+	void test_regular_timestamps() {
+		Audio::OutputTiming timing;
+		timing.reset(44100, 1024);
+
+		addCallbacks(timing, 44100, 512, 200, 0);
+
+		TS_ASSERT_EQUALS(timing.getCallbackCount(), (uint32)200);
+		// 512 frames at 44.1 kHz are 11610 us, but the timestamps are in ms
+		TS_ASSERT_DELTA(timing.getAveragePeriod(), (uint32)11610, 100);
+		TS_ASSERT_LESS_THAN_EQUALS(timing.getMaxJitter(), (uint32)1000);
+		TS_ASSERT(timing.isStable());
+	}
+
+	void test_jittery_timestamps() {
+		Audio::OutputTiming timing;
+		timing.reset(44100, 1024);
+
+		addCallbacks(timing, 44100, 512, 200, 4);
+
+		TS_ASSERT_DELTA(timing.getAveragePeriod(), (uint32)11610, 100);
+		TS_ASSERT_LESS_THAN_EQUALS(timing.getMaxJitter(), (uint32)5000);
+		TS_ASSERT_LESS_THAN_EQUALS((uint32)2000, timing.getMaxJitter());
+		// Two periods of buffering cover a few ms of jitter
+		TS_ASSERT(timing.isStable());
+
+		// ...but a single buffer does not
+		timing.reset(44100, 512);
+		addCallbacks(timing, 44100, 512, 200, 4);
+		TS_ASSERT(!timing.isStable());
+	}
+
+	void test_stalled_timestamps() {
+		Audio::OutputTiming timing;
+		timing.reset(44100, 1024);
+
+		// The device stalls for 40 ms in the middle
+		const uint32 time = addCallbacks(timing, 44100, 512, 100, 0);
+		addCallbacks(timing, 44100, 512, 100, 0, time + 40);
+
+		TS_ASSERT_LESS_THAN_EQUALS((uint32)28000, timing.getMaxJitter());
+		TS_ASSERT(!timing.isStable());
+
+		// Resetting starts a new measurement
+		timing.reset(44100, 1024);
+		TS_ASSERT_EQUALS(timing.getCallbackCount(), (uint32)0);
+		TS_ASSERT(!timing.isStable());
+	}
+};
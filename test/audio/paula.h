@@ -0,0 +1,176 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mods/paula.h"
+
+#include "helper.h"
+
+class PaulaTestSuite : public CxxTest::TestSuite
+{
+	// A synthetic module: looped and one-shot samples, changing periods,
+	// volumes and panning, and voices being paused and restarted
+	class TestModule : public Audio::Paula {
+	public:
+		TestModule(bool stereo, int rate) : Paula(stereo, rate, rate / 50), _tick(0), _seed(1) {
+			for (int i = 0; i < ARRAYSIZE(_saw); i++)
+				_saw[i] = i * 4 - 128;
+			for (int i = 0; i < ARRAYSIZE(_square); i++)
+				_square[i] = i < ARRAYSIZE(_square) / 2 ? 100 : -100;
+			for (int i = 0; i < ARRAYSIZE(_noise); i++)
+				_noise[i] = (int8)nextRandom(256);
+
+			startPaula();
+		}
+
+		void interrupt() {
+			switch (_tick) {
+			case 0:
+				setChannelData(0, _saw, _saw, ARRAYSIZE(_saw), ARRAYSIZE(_saw));
+				setChannelPeriod(0, 428);
+				setChannelVolume(0, 64);
+				setChannelData(1, _noise, _noise + 100, ARRAYSIZE(_noise), 16);
+				setChannelPeriod(1, 214);
+				setChannelVolume(1, 48);
+				setChannelData(2, _square, _square, ARRAYSIZE(_square), ARRAYSIZE(_square));
+				setChannelPeriod(2, 856);
+				setChannelVolume(2, 40);
+				break;
+			case 40:
+				disableChannel(2);
+				break;
+			case 60:
+				enableChannel(2);
+				break;
+			case 80:
+				setChannelPeriod(1, 0);
+				break;
+			case 90:
+				setChannelPeriod(1, 300);
+				break;
+			default:
+				break;
+			}
+
+			if (_tick % 7 == 3) {
+				setChannelData(3, _noise + 1000, _saw, 1000, ARRAYSIZE(_saw));
+				setChannelPeriod(3, 113 + nextRandom(200));
+				setChannelVolume(3, nextRandom(65));
+			}
+
+			// Volumes above 64 are capped
+			const byte voice = _tick % 3;
+			setChannelPeriod(voice, 113 + nextRandom(900));
+			setChannelVolume(voice, nextRandom(71));
+			setChannelPanning(voice, nextRandom(256));
+
+			_tick++;
+		}
+
+	private:
+		int8 _saw[64];
+		int8 _square[32];
+		int8 _noise[3000];
+		int _tick;
+		uint32 _seed;
+
+		uint nextRandom(uint max) {
+			_seed = _seed * 1103515245 + 12345;
+			return (_seed >> 16) % max;
+		}
+	};
+
+	// A single square wave voice, changing its level every 32 source samples
+	class SquareVoice : public Audio::Paula {
+	public:
+		SquareVoice(int rate, int16 period) : Paula(false, rate), _period(period) {
+			for (int i = 0; i < ARRAYSIZE(_square); i++)
+				_square[i] = i < ARRAYSIZE(_square) / 2 ? 50 : -70;
+			startPaula();
+		}
+
+		void interrupt() {
+			setChannelData(0, _square, _square, ARRAYSIZE(_square), ARRAYSIZE(_square));
+			setChannelPeriod(0, _period);
+			setChannelVolume(0, 64);
+		}
+
+	private:
+		int8 _square[64];
+		int16 _period;
+	};
+
+	// Renders two seconds in pieces which don't line up with the interrupts
+	static uint32 render(Audio::Paula &paula) {
+		const int length = paula.getRate() * 2 * (paula.isStereo() ? 2 : 1);
+		int16 *buffer = new int16[length];
+
+		for (int pos = 0; pos < length; pos += 1002)
+			paula.readBuffer(buffer + pos, MIN(1002, length - pos));
+
+		uint32 checksum = 0;
+		for (int i = 0; i < length; i++)
+			checksum = checksum * 31 + (uint16)buffer[i];
+
+		delete[] buffer;
+		return checksum;
+	}
+
+public:
+	void test_reference_output() {
+		// Checksums of the output of the mixer as it was before the mix
+		// loops were sized up front, which has to stay bit-identical
+		TestSystem testSystem;
+
+		TestModule stereo44(true, 44100);
+		TS_ASSERT_EQUALS(render(stereo44), 1942568095u);
+		TestModule mono44(false, 44100);
+		TS_ASSERT_EQUALS(render(mono44), 1372716493u);
+		TestModule stereo22(true, 22050);
+		TS_ASSERT_EQUALS(render(stereo22), 3979811107u);
+		TestModule mono22(false, 22050);
+		TS_ASSERT_EQUALS(render(mono22), 2207885582u);
+	}
+
+	void test_band_limited() {
+		// Away from the steps of the voice, the band-limited output is the
+		// plain output delayed by one sample. Around the steps it stays
+		// between the levels before and after them.
+		TestSystem testSystem;
+		const int rates[] = { 44100, 22050 };
+
+		for (int r = 0; r < ARRAYSIZE(rates); r++) {
+			const int length = rates[r] / 2;
+			int16 *plain = new int16[length];
+			int16 *bandLimited = new int16[length];
+
+			SquareVoice plainVoice(rates[r], 300);
+			plainVoice.readBuffer(plain, length);
+
+			SquareVoice bandLimitedVoice(rates[r], 300);
+			bandLimitedVoice.setBandLimited(true);
+			TS_ASSERT(bandLimitedVoice.isBandLimited());
+			bandLimitedVoice.readBuffer(bandLimited, length);
+
+			int wrongDelayed = -1, outOfRange = -1, smoothed = 0;
+			for (int i = 2; i < length; i++) {
+				if (plain[i] == plain[i - 1] && plain[i - 1] == plain[i - 2]) {
+					if (wrongDelayed < 0 && bandLimited[i] != plain[i])
+						wrongDelayed = i;
+				} else {
+					const int16 low = MIN(plain[i], MIN(plain[i - 1], plain[i - 2]));
+					const int16 high = MAX(plain[i], MAX(plain[i - 1], plain[i - 2]));
+					if (outOfRange < 0 && (bandLimited[i] < low || bandLimited[i] > high))
+						outOfRange = i;
+					if (bandLimited[i] != plain[i - 1])
+						smoothed++;
+				}
+			}
+
+			TS_ASSERT_EQUALS(wrongDelayed, -1);
+			TS_ASSERT_EQUALS(outOfRange, -1);
+			TS_ASSERT_LESS_THAN(0, smoothed);
+
+			delete[] plain;
+			delete[] bandLimited;
+		}
+	}
+};
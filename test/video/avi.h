@@ -0,0 +1,313 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/avi_decoder.h"
+
+#include "common/array.h"
+#include "common/memstream.h"
+
+#include "graphics/surface.h"
+
+#include "../audio/helper.h"
+
+class AVIDecoderTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kWidth = 8,
+		kHeight = 8,
+		kFrameCount = 20,
+		kFrameRate = 10,
+		kKeyFrameInterval = 5,
+		kPaletteChangeFrame = 12,
+		kAudioRate = 8000,
+		kAudioPerFrame = kAudioRate / kFrameRate,
+		// The first frame carries half a second of audio more
+		kAudioLead = kAudioRate / 2
+	};
+
+	struct IndexEntry {
+		uint32 id, flags, offset, size;
+	};
+
+	Common::Array<byte> _data;
+	Common::Array<IndexEntry> _index;
+	uint32 _movieList;
+
+	void write16(uint16 value) {
+		_data.push_back(value & 0xFF);
+		_data.push_back(value >> 8);
+	}
+
+	void write32(uint32 value) {
+		write16(value & 0xFFFF);
+		write16(value >> 16);
+	}
+
+	void writeTag(uint32 tag) {
+		for (int shift = 24; shift >= 0; shift -= 8)
+			_data.push_back((tag >> shift) & 0xFF);
+	}
+
+	// Writes a chunk or LIST header with a size to be filled in by endChunk()
+	uint32 beginChunk(uint32 tag) {
+		writeTag(tag);
+		write32(0);
+		return _data.size();
+	}
+
+	void endChunk(uint32 start) {
+		uint32 size = _data.size() - start;
+		for (int i = 0; i < 4; i++)
+			_data[start - 4 + i] = (size >> (i * 8)) & 0xFF;
+		if (size & 1)
+			_data.push_back(0);
+	}
+
+	void writeIndexedChunk(uint32 tag, const Common::Array<byte> &chunk, bool keyFrame) {
+		IndexEntry entry = { tag, keyFrame ? 0x10u : 0u, _data.size() - _movieList, chunk.size() };
+		_index.push_back(entry);
+
+		uint32 start = beginChunk(tag);
+		for (uint i = 0; i < chunk.size(); i++)
+			_data.push_back(chunk[i]);
+		endChunk(start);
+	}
+
+	static int16 audioSample(uint32 n) {
+		return (int16)(n * 3 - 30000);
+	}
+
+	// Key frames fill the picture, the frames in between change one pixel
+	static Common::Array<byte> encodeFrame(int frame) {
+		Common::Array<byte> chunk;
+
+		if (frame % kKeyFrameInterval == 0) {
+			for (int y = 0; y < kHeight; y++) {
+				chunk.push_back(kWidth);
+				chunk.push_back(frame * 10 + y);
+				chunk.push_back(0);
+				chunk.push_back(y == kHeight - 1 ? 1 : 0);
+			}
+		} else {
+			const byte skip[] = { 0, 2, (byte)(frame % kWidth), (byte)((frame * 3) % kHeight), 1, (byte)(200 + frame), 0, 1 };
+			chunk = Common::Array<byte>(skip, ARRAYSIZE(skip));
+		}
+
+		return chunk;
+	}
+
+	static Common::Array<byte> encodeAudio(uint32 start, uint32 count) {
+		Common::Array<byte> chunk;
+
+		for (uint32 i = start; i < start + count; i++) {
+			uint16 sample = audioSample(i);
+			chunk.push_back(sample & 0xFF);
+			chunk.push_back(sample >> 8);
+		}
+
+		return chunk;
+	}
+
+	void writeStreamHeader(uint32 type, uint32 handler, uint32 rate, uint32 length, uint32 sampleSize) {
+		uint32 start = beginChunk(MKTAG('s', 't', 'r', 'h'));
+		writeTag(type);
+		writeTag(handler);
+		write32(0);          // flags
+		write16(0);          // priority
+		write16(0);          // language
+		write32(0);          // initial frames
+		write32(1);          // scale
+		write32(rate);
+		write32(0);          // start
+		write32(length);
+		write32(0);          // buffer size
+		write32(0);          // quality
+		write32(sampleSize);
+		write32(0);          // frame rectangle
+		write32(0);
+		endChunk(start);
+	}
+
+	// Builds an 8 bit MS RLE video with 16 bit mono PCM audio, stored ahead
+	// of the video and interleaved in 'rec ' lists, and a palette change
+	Common::SeekableReadStream *createVideo() {
+		_data.clear();
+		_index.clear();
+
+		uint32 riff = beginChunk(MKTAG('R', 'I', 'F', 'F'));
+		writeTag(MKTAG('A', 'V', 'I', ' '));
+
+		uint32 headerList = beginChunk(MKTAG('L', 'I', 'S', 'T'));
+		writeTag(MKTAG('h', 'd', 'r', 'l'));
+
+		uint32 header = beginChunk(MKTAG('a', 'v', 'i', 'h'));
+		write32(1000000 / kFrameRate);
+		write32(0);
+		write32(0);
+		write32(0x10);       // AVIF_HASINDEX
+		write32(kFrameCount);
+		write32(0);
+		write32(2);
+		write32(0);
+		write32(kWidth);
+		write32(kHeight);
+		for (int i = 0; i < 4; i++)
+			write32(0);
+		endChunk(header);
+
+		uint32 videoList = beginChunk(MKTAG('L', 'I', 'S', 'T'));
+		writeTag(MKTAG('s', 't', 'r', 'l'));
+		writeStreamHeader(MKTAG('v', 'i', 'd', 's'), MKTAG('R', 'L', 'E', ' '), kFrameRate, kFrameCount, 0);
+		uint32 videoFormat = beginChunk(MKTAG('s', 't', 'r', 'f'));
+		write32(40);
+		write32(kWidth);
+		write32(kHeight);
+		write16(1);
+		write16(8);
+		writeTag(MKTAG('R', 'L', 'E', ' '));
+		for (int i = 0; i < 5; i++)
+			write32(0);
+		for (int i = 0; i < 256; i++)
+			write32(i << 16 | (255 - i) << 8 | (i * 3 & 0xFF));
+		endChunk(videoFormat);
+		endChunk(videoList);
+
+		uint32 audioList = beginChunk(MKTAG('L', 'I', 'S', 'T'));
+		writeTag(MKTAG('s', 't', 'r', 'l'));
+		writeStreamHeader(MKTAG('a', 'u', 'd', 's'), 0, kAudioRate, kAudioLead + kFrameCount * kAudioPerFrame, 2);
+		uint32 audioFormat = beginChunk(MKTAG('s', 't', 'r', 'f'));
+		write16(1);          // PCM
+		write16(1);
+		write32(kAudioRate);
+		write32(kAudioRate * 2);
+		write16(2);
+		write16(16);
+		endChunk(audioFormat);
+		endChunk(audioList);
+
+		endChunk(headerList);
+
+		uint32 movieList = beginChunk(MKTAG('L', 'I', 'S', 'T'));
+		_movieList = _data.size();
+		writeTag(MKTAG('m', 'o', 'v', 'i'));
+
+		for (int frame = 0; frame < kFrameCount; frame++) {
+			uint32 record = beginChunk(MKTAG('L', 'I', 'S', 'T'));
+			writeTag(MKTAG('r', 'e', 'c', ' '));
+
+			if (frame == 0)
+				writeIndexedChunk(MKTAG('0', '1', 'w', 'b'), encodeAudio(0, kAudioLead + kAudioPerFrame), true);
+			else
+				writeIndexedChunk(MKTAG('0', '1', 'w', 'b'), encodeAudio(kAudioLead + frame * kAudioPerFrame, kAudioPerFrame), true);
+
+			if (frame == kPaletteChangeFrame) {
+				const byte paletteChange[] = { 1, 1, 0, 0, 10, 20, 30, 0 };
+				writeIndexedChunk(MKTAG('0', '0', 'p', 'c'), Common::Array<byte>(paletteChange, ARRAYSIZE(paletteChange)), false);
+			}
+
+			writeIndexedChunk(MKTAG('0', '0', 'd', 'c'), encodeFrame(frame), frame % kKeyFrameInterval == 0);
+			endChunk(record);
+		}
+
+		endChunk(movieList);
+
+		uint32 index = beginChunk(MKTAG('i', 'd', 'x', '1'));
+		for (uint i = 0; i < _index.size(); i++) {
+			writeTag(_index[i].id);
+			write32(_index[i].flags);
+			write32(_index[i].offset);
+			write32(_index[i].size);
+		}
+		endChunk(index);
+
+		endChunk(riff);
+
+		byte *data = (byte *)malloc(_data.size());
+		memcpy(data, _data.begin(), _data.size());
+		return new Common::MemoryReadStream(data, _data.size(), DisposeAfterUse::YES);
+	}
+
+	struct Frame {
+		byte pixels[kWidth * kHeight];
+		byte palette[3 * 256];
+	};
+
+	static void storeFrame(Video::VideoDecoder &decoder, const Graphics::Surface *surface, Frame &frame) {
+		for (int y = 0; y < kHeight; y++)
+			memcpy(frame.pixels + y * kWidth, surface->getBasePtr(0, y), kWidth);
+		memcpy(frame.palette, decoder.getPalette(), sizeof(frame.palette));
+	}
+
+public:
+	void test_seek_matches_linear_decoding() {
+		TestSystem testSystem(kAudioRate);
+		Video::AVIDecoder decoder;
+		TS_ASSERT(decoder.loadStream(createVideo()));
+		TS_ASSERT(decoder.isSeekable());
+
+		Frame frames[kFrameCount];
+		for (int i = 0; i < kFrameCount; i++) {
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			TS_ASSERT(surface);
+			if (!surface)
+				return;
+			storeFrame(decoder, surface, frames[i]);
+		}
+
+		// Check the stream has the delta frames and palette change it should
+		TS_ASSERT_DIFFERS(memcmp(frames[6].pixels, frames[7].pixels, sizeof(frames[6].pixels)), 0);
+		TS_ASSERT_DIFFERS(memcmp(frames[11].palette, frames[12].palette, sizeof(frames[11].palette)), 0);
+
+		// Forwards and backwards, onto and between key frames
+		const int targets[] = { 7, 3, 5, 12, 19, 13, 0, 9 };
+
+		for (int i = 0; i < ARRAYSIZE(targets); i++) {
+			TS_ASSERT(decoder.seekToFrame(targets[i]));
+
+			for (int frame = targets[i]; frame < MIN<int>(targets[i] + 3, kFrameCount); frame++) {
+				const Graphics::Surface *surface = decoder.decodeNextFrame();
+				TS_ASSERT(surface);
+				if (!surface)
+					return;
+				TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+
+				Frame decoded;
+				storeFrame(decoder, surface, decoded);
+				TS_ASSERT_EQUALS(memcmp(decoded.pixels, frames[frame].pixels, sizeof(decoded.pixels)), 0);
+				TS_ASSERT_EQUALS(memcmp(decoded.palette, frames[frame].palette, sizeof(decoded.palette)), 0);
+			}
+		}
+	}
+
+	void test_seek_resumes_audio() {
+		// The audio is stored ahead of the video, so seeking has to queue
+		// audio from before the key frame, starting right at the target
+		TestSystem testSystem(kAudioRate);
+		Video::AVIDecoder decoder;
+		TS_ASSERT(decoder.loadStream(createVideo()));
+		decoder.start();
+
+		const int targets[] = { 0, 3, 7, 12, 5, 16 };
+		const uint kMixFrames = kAudioPerFrame * 2;
+		int16 buffer[kMixFrames * 2];
+
+		for (int i = 0; i < ARRAYSIZE(targets); i++) {
+			TS_ASSERT(decoder.seekToFrame(targets[i]));
+
+			for (int frame = 0; frame < 3; frame++)
+				TS_ASSERT(decoder.decodeNextFrame());
+
+			testSystem.mix(buffer, kMixFrames);
+
+			int firstDifference = -1;
+			for (uint j = 0; j < kMixFrames && firstDifference < 0; j++) {
+				const int16 expected = audioSample(targets[i] * kAudioPerFrame + j);
+				if (buffer[j * 2] != expected || buffer[j * 2 + 1] != expected)
+					firstDifference = j;
+			}
+
+			TS_ASSERT_EQUALS(firstDifference, -1);
+		}
+
+		decoder.close();
+	}
+};
@@ -92,6 +92,7 @@ static uint16 getStreamType(uint32 tag) {
 AVIDecoder::AVIDecoder(Audio::Mixer::SoundType soundType) : _soundType(soundType) {
 	_decodedHeader = false;
 	_fileStream = 0;
+	_movieListStart = _movieListEnd = 0;
 	memset(&_ixInfo, 0, sizeof(_ixInfo));
 	memset(&_header, 0, sizeof(_header));
 }
@@ -142,6 +143,8 @@ void AVIDecoder::runHandle(uint32 tag) {
 		_fileStream->skip(junkSize + (junkSize & 1)); // Alignment
 		} break;
 	case ID_IDX1:
+		// The index may already have been read by readIndex()
+		delete[] _ixInfo.indices;
 		_ixInfo.size = _fileStream->readUint32LE();
 		_ixInfo.indices = new OldIndex::Index[_ixInfo.size / 16];
 		debug(0, "%d Indices", (_ixInfo.size / 16));
@@ -236,6 +239,7 @@ void AVIDecoder::handleStreamHeader() {
 			track->markPaletteDirty();
 		}
 
+		track->storeInitialPalette();
 		addTrack(track);
 	} else if (sHeader.streamType == ID_AUDS) {
 		PCMWaveFormat wvInfo;
@@ -278,16 +282,182 @@ bool AVIDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	// Ignore the 'movi' LIST
 	if (nextTag == ID_LIST) {
-		_fileStream->readUint32BE(); // Skip size
+		uint32 listSize = _fileStream->readUint32LE();
+		_movieListStart = _fileStream->pos();
+		_movieListEnd = _movieListStart + listSize + (listSize & 1);
+
 		if (_fileStream->readUint32BE() != ID_MOVI)
 			error("Expected 'movi' LIST");
 	} else {
 		error("Expected 'movi' LIST");
 	}
 
+	// Read the index now so that we can seek
+	if (_header.flags & AVIF_HASINDEX)
+		readIndex();
+
 	return true;
 }
 
+void AVIDecoder::readIndex() {
+	uint32 curPos = _fileStream->pos();
+
+	// The index directly follows the 'movi' LIST
+	_fileStream->seek(_movieListEnd);
+
+	if (_fileStream->readUint32BE() == ID_IDX1 && !_fileStream->eos())
+		runHandle(ID_IDX1);
+
+	_fileStream->seek(curPos);
+}
+
+AVIDecoder::AVIVideoTrack *AVIDecoder::getVideoTrack() {
+	for (TrackListIterator it = getTrackListBegin(); it != getTrackListEnd(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
+			return (AVIVideoTrack *)*it;
+
+	return 0;
+}
+
+bool AVIDecoder::isSeekable() const {
+	// Seeking anywhere but the start needs the index
+	return _ixInfo.indices && VideoDecoder::isSeekable();
+}
+
+bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
+	AVIVideoTrack *videoTrack = getVideoTrack();
+
+	if (!videoTrack)
+		return false;
+
+	// The video track has already been set to the requested frame
+	uint32 targetFrame = videoTrack->getCurFrame() + 1;
+
+	videoTrack->restoreInitialPalette();
+
+	if (targetFrame == 0) {
+		_fileStream->seek(_movieListStart + 4);
+		return true;
+	}
+
+	if (!_ixInfo.indices)
+		return false;
+
+	// Find the key frame to start decoding from, and the index entry to
+	// resume reading from, which follows the frame before the target.
+	uint32 entryCount = _ixInfo.size / 16;
+	uint32 frame = 0, keyFrame = 0, keyFrameEntry = 0, resumeEntry = entryCount;
+
+	for (uint32 i = 0; i < entryCount; i++) {
+		uint32 id = _ixInfo.indices[i].id;
+
+		if (getTrack(getStreamIndex(id)) != videoTrack || getStreamType(id) == MKTAG16('p', 'c'))
+			continue;
+
+		if (frame == targetFrame) {
+			resumeEntry = i;
+			break;
+		}
+
+		if (frame == 0 || (_ixInfo.indices[i].flags & AVIIF_KEYFRAME)) {
+			keyFrame = frame;
+			keyFrameEntry = i;
+		}
+
+		frame++;
+		resumeEntry = i + 1;
+	}
+
+	// Audio resumes from the last chunk of each audio track starting at or
+	// before the target time. Audio is usually stored ahead of the video, so
+	// that chunk is often before the key frame; it may also come after the
+	// target frame. Whatever is queued before the target time is dropped by
+	// the track.
+	Common::Array<uint32> audioResumeEntries;
+	for (TrackListIterator it = getTrackListBegin(); it != getTrackListEnd(); it++) {
+		uint32 audioResumeEntry = entryCount;
+
+		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
+			audioResumeEntry = findAudioResumeEntry((AVIAudioTrack *)*it, time, resumeEntry);
+
+		audioResumeEntries.push_back(audioResumeEntry);
+	}
+
+	// Offsets are usually relative to the 'movi' tag, but may be absolute
+	uint32 base = (entryCount != 0 && _ixInfo.indices[0].offset < _movieListStart) ? _movieListStart : 0;
+
+	// Apply the palette changes up to the key frame, then decode the video
+	// chunks (and any palette changes) from there up to the target, along
+	// with the audio chunks from where each audio track resumes
+	videoTrack->setCurFrame(keyFrame - 1);
+
+	for (uint32 i = 0; i < resumeEntry; i++) {
+		uint32 id = _ixInfo.indices[i].id;
+		uint streamIndex = getStreamIndex(id);
+
+		if (getTrack(streamIndex) != videoTrack) {
+			if (streamIndex >= audioResumeEntries.size() || i < audioResumeEntries[streamIndex])
+				continue;
+		} else if (i < keyFrameEntry && getStreamType(id) != MKTAG16('p', 'c')) {
+			continue;
+		}
+
+		_fileStream->seek(base + _ixInfo.indices[i].offset);
+		readNextPacket();
+	}
+
+	if (resumeEntry < entryCount)
+		_fileStream->seek(base + _ixInfo.indices[resumeEntry].offset);
+	else
+		_fileStream->seek(_movieListEnd);
+
+	return true;
+}
+
+uint32 AVIDecoder::findAudioResumeEntry(AVIAudioTrack *audioTrack, const Audio::Timestamp &time, uint32 resumeEntry) {
+	uint32 entryCount = _ixInfo.size / 16;
+	uint32 bytesPerSecond = audioTrack->getBytesPerSecond();
+
+	if (!bytesPerSecond)
+		return entryCount;
+
+	// The position of the audio chunks follows from their size
+	uint64 targetBytes = (uint64)time.msecs() * bytesPerSecond / 1000;
+	uint64 bytes = 0, audioResumeBytes = 0, firstAfterBytes = 0;
+	uint32 audioResumeEntry = entryCount, firstAfterEntry = entryCount;
+
+	for (uint32 i = 0; i < entryCount; i++) {
+		if (getTrack(getStreamIndex(_ixInfo.indices[i].id)) != audioTrack)
+			continue;
+
+		if (i >= resumeEntry && firstAfterEntry == entryCount) {
+			firstAfterEntry = i;
+			firstAfterBytes = bytes;
+		}
+
+		if (bytes <= targetBytes) {
+			audioResumeEntry = i;
+			audioResumeBytes = bytes;
+		}
+
+		bytes += _ixInfo.indices[i].size;
+
+		if (bytes > targetBytes && firstAfterEntry != entryCount)
+			break;
+	}
+
+	if (audioResumeEntry == entryCount)
+		return entryCount;
+
+	// The first chunk queued is either the one audio resumes from, if it is
+	// read before the target frame, or the first one read afterwards
+	uint64 startBytes = (audioResumeEntry < resumeEntry) ? audioResumeBytes : firstAfterBytes;
+	int64 skipFrames = (int64)time.convertToFramerate(audioTrack->getRate()).totalNumberOfFrames() - (int64)(startBytes * audioTrack->getRate() / bytesPerSecond);
+	audioTrack->skipAudio(MAX<int64>(skipFrames, 0));
+
+	return audioResumeEntry;
+}
+
 void AVIDecoder::close() {
 	VideoDecoder::close();
 
@@ -298,6 +468,7 @@ void AVIDecoder::close() {
 	delete[] _ixInfo.indices;
 	memset(&_ixInfo, 0, sizeof(_ixInfo));
 	memset(&_header, 0, sizeof(_header));
+	_movieListStart = _movieListEnd = 0;
 }
 
 void AVIDecoder::readNextPacket() {
@@ -382,6 +553,7 @@ void AVIDecoder::readNextPacket() {
 AVIDecoder::AVIVideoTrack::AVIVideoTrack(int frameCount, const AVIStreamHeader &streamHeader, const BitmapInfoHeader &bitmapInfoHeader)
 		: _frameCount(frameCount), _vidsHeader(streamHeader), _bmInfo(bitmapInfoHeader) {
 	memset(_palette, 0, sizeof(_palette));
+	memset(_initialPalette, 0, sizeof(_initialPalette));
 	_videoCodec = createCodec();
 	_dirtyPalette = false;
 	_lastFrame = 0;
@@ -405,6 +577,16 @@ void AVIDecoder::AVIVideoTrack::decodeFrame(Common::SeekableReadStream *stream)
 	_curFrame++;
 }
 
+bool AVIDecoder::AVIVideoTrack::seek(const Audio::Timestamp &time) {
+	_curFrame = MIN<int>(getFrameAtTime(time), _frameCount) - 1;
+	return true;
+}
+
+void AVIDecoder::AVIVideoTrack::restoreInitialPalette() {
+	memcpy(_palette, _initialPalette, sizeof(_palette));
+	_dirtyPalette = true;
+}
+
 Graphics::PixelFormat AVIDecoder::AVIVideoTrack::getPixelFormat() const {
 	if (_videoCodec)
 		return _videoCodec->getPixelFormat();
@@ -438,6 +620,7 @@ Codec *AVIDecoder::AVIVideoTrack::createCodec() {
 AVIDecoder::AVIAudioTrack::AVIAudioTrack(const AVIStreamHeader &streamHeader, const PCMWaveFormat &waveFormat, Audio::Mixer::SoundType soundType)
 		: _audsHeader(streamHeader), _wvInfo(waveFormat), _soundType(soundType) {
 	_audStream = createAudioStream();
+	_skipFrames = 0;
 }
 
 AVIDecoder::AVIAudioTrack::~AVIAudioTrack() {
@@ -446,6 +629,8 @@ AVIDecoder::AVIAudioTrack::~AVIAudioTrack() {
 
 void AVIDecoder::AVIAudioTrack::queueSound(Common::SeekableReadStream *stream) {
 	if (_audStream) {
+		Audio::AudioStream *audioStream = 0;
+
 		if (_wvInfo.tag == kWaveFormatPCM) {
 			byte flags = 0;
 			if (_audsHeader.sampleSize == 2)
@@ -456,19 +641,46 @@ void AVIDecoder::AVIAudioTrack::queueSound(Common::SeekableReadStream *stream) {
 			if (_wvInfo.channels == 2)
 				flags |= Audio::FLAG_STEREO;
 
-			_audStream->queueAudioStream(Audio::makeRawStream(stream, _wvInfo.samplesPerSec, flags, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			audioStream = Audio::makeRawStream(stream, _wvInfo.samplesPerSec, flags, DisposeAfterUse::YES);
 		} else if (_wvInfo.tag == kWaveFormatMSADPCM) {
-			_audStream->queueAudioStream(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMMS, _wvInfo.samplesPerSec, _wvInfo.channels, _wvInfo.blockAlign), DisposeAfterUse::YES);
+			audioStream = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMMS, _wvInfo.samplesPerSec, _wvInfo.channels, _wvInfo.blockAlign);
 		} else if (_wvInfo.tag == kWaveFormatMSIMAADPCM) {
-			_audStream->queueAudioStream(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMMSIma, _wvInfo.samplesPerSec, _wvInfo.channels, _wvInfo.blockAlign), DisposeAfterUse::YES);
+			audioStream = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMMSIma, _wvInfo.samplesPerSec, _wvInfo.channels, _wvInfo.blockAlign);
 		} else if (_wvInfo.tag == kWaveFormatDK3) {
-			_audStream->queueAudioStream(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMDK3, _wvInfo.samplesPerSec, _wvInfo.channels, _wvInfo.blockAlign), DisposeAfterUse::YES);
+			audioStream = Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMDK3, _wvInfo.samplesPerSec, _wvInfo.channels, _wvInfo.blockAlign);
+		} else {
+			delete stream;
+			return;
 		}
+
+		// Drop the audio before a seek target
+		int16 buffer[1024];
+		const int channels = (_wvInfo.channels == 2) ? 2 : 1;
+		while (_skipFrames > 0) {
+			const int samples = audioStream->readBuffer(buffer, MIN<uint32>(_skipFrames, ARRAYSIZE(buffer) / channels) * channels);
+			if (samples <= 0)
+				break;
+			_skipFrames -= samples / channels;
+		}
+
+		_audStream->queueAudioStream(audioStream, DisposeAfterUse::YES);
 	} else {
 		delete stream;
 	}
 }
 
+bool AVIDecoder::AVIAudioTrack::seek(const Audio::Timestamp &time) {
+	// The audio is queued again while reading onwards from the new position
+	delete _audStream;
+	_audStream = createAudioStream();
+	_skipFrames = 0;
+	return true;
+}
+
+void AVIDecoder::AVIAudioTrack::skipAudio(uint32 frames) {
+	_skipFrames = frames;
+}
+
 Audio::AudioStream *AVIDecoder::AVIAudioTrack::getAudioStream() const {
 	return _audStream;
 }
@@ -63,8 +63,11 @@ public:
 	uint16 getWidth() const { return _header.width; }
 	uint16 getHeight() const { return _header.height; }
 
+	bool isSeekable() const;
+
 protected:
 	 void readNextPacket();
+	 bool seekIntern(const Audio::Timestamp &time);
 
 private:
 	struct BitmapInfoHeader {
@@ -110,7 +113,7 @@ private:
 
 	// Index Flags
 	enum IndexFlags {
-		AVIIF_INDEX = 0x10
+		AVIIF_KEYFRAME = 0x10
 	};
 
 	struct AVIHeader {
@@ -171,6 +174,11 @@ private:
 		const byte *getPalette() const { _dirtyPalette = false; return _palette; }
 		bool hasDirtyPalette() const { return _dirtyPalette; }
 		void markPaletteDirty() { _dirtyPalette = true; }
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time);
+		void setCurFrame(int frame) { _curFrame = frame; }
+		void storeInitialPalette() { memcpy(_initialPalette, _palette, sizeof(_palette)); }
+		void restoreInitialPalette();
 
 	protected:
 		Common::Rational getFrameRate() const { return Common::Rational(_vidsHeader.rate, _vidsHeader.scale); }
@@ -179,6 +187,7 @@ private:
 		AVIStreamHeader _vidsHeader;
 		BitmapInfoHeader _bmInfo;
 		byte _palette[3 * 256];
+		byte _initialPalette[3 * 256];
 		mutable bool _dirtyPalette;
 		int _frameCount, _curFrame;
 
@@ -194,6 +203,14 @@ private:
 
 		void queueSound(Common::SeekableReadStream *stream);
 		Audio::Mixer::SoundType getSoundType() const { return _soundType; }
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time);
+
+		/** Drop the given number of sample frames from the audio queued next. */
+		void skipAudio(uint32 frames);
+
+		uint32 getRate() const { return _wvInfo.samplesPerSec; }
+		uint32 getBytesPerSecond() const { return _wvInfo.avgBytesPerSec; }
 
 	protected:
 		Audio::AudioStream *getAudioStream() const;
@@ -213,6 +230,7 @@ private:
 		Audio::Mixer::SoundType _soundType;
 		Audio::QueuingAudioStream *_audStream;
 		Audio::QueuingAudioStream *createAudioStream();
+		uint32 _skipFrames;
 	};
 
 	OldIndex _ixInfo;
@@ -220,12 +238,23 @@ private:
 
 	Common::SeekableReadStream *_fileStream;
 	bool _decodedHeader;
+	uint32 _movieListStart, _movieListEnd;
 
 	Audio::Mixer::SoundType _soundType;
 
 	void runHandle(uint32 tag);
 	void handleList();
 	void handleStreamHeader();
+	void readIndex();
+	AVIVideoTrack *getVideoTrack();
+
+	/**
+	 * Find the index entry audio has to resume from when seeking, and make
+	 * the track drop the audio before the target time.
+	 * @param resumeEntry the index entry video resumes from
+	 * @return the index entry, or the number of entries if there is none
+	 */
+	uint32 findAudioResumeEntry(AVIAudioTrack *audioTrack, const Audio::Timestamp &time, uint32 resumeEntry);
 };
 
 } // End of namespace Video
@@ -71,6 +71,7 @@ DXADecoder::DXAVideoTrack::DXAVideoTrack(Common::SeekableReadStream *stream) {
 	_fileStream = stream;
 	_curFrame = -1;
 	_frameStartOffset = 0;
+	_frameIndexEnd = 0;
 	_decompBuffer = 0;
 	_inBuffer = 0;
 	memset(_palette, 0, 256 * 3);
@@ -170,6 +171,96 @@ Graphics::PixelFormat DXADecoder::DXAVideoTrack::getPixelFormat() const {
 
 void DXADecoder::DXAVideoTrack::setFrameStartPos() {
 	_frameStartOffset = _fileStream->pos();
+	_frameIndexEnd = _frameStartOffset;
+}
+
+void DXADecoder::DXAVideoTrack::indexFrames(uint32 frameCount) {
+	frameCount = MIN(frameCount, _frameCount);
+
+	if (_frameIndex.size() >= frameCount)
+		return;
+
+	uint32 curPos = _fileStream->pos();
+	_fileStream->seek(_frameIndexEnd);
+
+	// Only the chunk headers need to be read
+	while (_frameIndex.size() < frameCount) {
+		FrameIndexEntry entry;
+		entry.offset = _fileStream->pos();
+		entry.hasPalette = false;
+		entry.isKeyFrame = false;
+
+		if (_fileStream->readUint32BE() == MKTAG('C','M','A','P')) {
+			entry.hasPalette = true;
+			_fileStream->skip(256 * 3);
+		}
+
+		if (_fileStream->readUint32BE() == MKTAG('F','R','A','M')) {
+			byte type = _fileStream->readByte();
+			uint32 size = _fileStream->readUint32BE();
+			entry.isKeyFrame = (type == 2);
+			_fileStream->skip(size);
+		}
+
+		if (_fileStream->eos() || _fileStream->err())
+			break;
+
+		_frameIndex.push_back(entry);
+	}
+
+	_frameIndexEnd = _fileStream->pos();
+	_fileStream->seek(curPos);
+}
+
+bool DXADecoder::DXAVideoTrack::seek(const Audio::Timestamp &time) {
+	uint32 targetFrame = getFrameAtTime(time);
+
+	if (targetFrame == 0)
+		return rewind();
+
+	// Index up to and including the target, since we resume from there
+	indexFrames(targetFrame + 1);
+
+	if (targetFrame > _frameIndex.size())
+		return false;
+
+	// Find the closest key frame before the target. Without one, decode
+	// from the start with empty buffers.
+	uint32 keyFrame = targetFrame - 1;
+
+	while (keyFrame > 0 && !_frameIndex[keyFrame].isKeyFrame)
+		keyFrame--;
+
+	if (keyFrame == 0 && !_frameIndex[0].isKeyFrame) {
+		memset(_frameBuffer1, 0, _frameSize);
+		memset(_frameBuffer2, 0, _frameSize);
+	}
+
+	// Restore the last palette from before the key frame
+	memset(_palette, 0, 256 * 3);
+
+	for (uint32 i = keyFrame; i > 0; i--) {
+		if (_frameIndex[i - 1].hasPalette) {
+			_fileStream->seek(_frameIndex[i - 1].offset + 4);
+			_fileStream->read(_palette, 256 * 3);
+			break;
+		}
+	}
+
+	_dirtyPalette = true;
+
+	// Decode onwards up to the frame before the target
+	_fileStream->seek(_frameIndex[keyFrame].offset);
+
+	for (uint32 i = keyFrame; i < targetFrame; i++)
+		decodeNextFrame();
+
+	_curFrame = targetFrame - 1;
+
+	if (targetFrame < _frameIndex.size())
+		_fileStream->seek(_frameIndex[targetFrame].offset);
+
+	return true;
 }
 
 void DXADecoder::DXAVideoTrack::decodeZlib(byte *data, int size, int totalSize) {
@@ -62,6 +62,8 @@ private:
 
 		bool isRewindable() const { return true; }
 		bool rewind();
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time);
 
 		uint16 getWidth() const { return _width; }
 		uint16 getHeight() const { return _height; }
@@ -79,6 +81,7 @@ private:
 
 	private:
 		void decodeZlib(byte *data, int size, int totalSize);
+		void indexFrames(uint32 frameCount);
 		void decode12(int size);
 		void decode13(int size);
 
@@ -108,6 +111,17 @@ private:
 		mutable bool _dirtyPalette;
 		int _curFrame;
 		uint32 _frameStartOffset;
+
+		// Where each frame starts and whether it can be decoded on its
+		// own. This is only filled in as far as seeking needs it.
+		struct FrameIndexEntry {
+			uint32 offset;
+			bool hasPalette;
+			bool isKeyFrame;
+		};
+
+		Common::Array<FrameIndexEntry> _frameIndex;
+		uint32 _frameIndexEnd;
 	};
 };
 
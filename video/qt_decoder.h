@@ -72,6 +72,9 @@ public:
 protected:
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize);
 
+	// updateAudioBuffer() reads from the same stream as the video tracks
+	bool supportsDecodeAhead() const { return false; }
+
 private:
 	void init();
 
@@ -282,6 +282,8 @@ SmackerDecoder::SmackerDecoder(Audio::Mixer::SoundType soundType) : _soundType(s
 	_firstFrameStart = 0;
 	_frameTypes = 0;
 	_frameSizes = 0;
+	_frameOffsets = 0;
+	_lastIndexedFrame = -1;
 }
 
 SmackerDecoder::~SmackerDecoder() {
@@ -392,6 +394,10 @@ bool SmackerDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	_firstFrameStart = _fileStream->pos();
 
+	_frameOffsets = new uint32[frameCount];
+	for (i = 0; i < frameCount; ++i)
+		_frameOffsets[i] = (i == 0) ? _firstFrameStart : _frameOffsets[i - 1] + (_frameSizes[i - 1] & ~3);
+
 	return true;
 }
 
@@ -406,15 +412,121 @@ void SmackerDecoder::close() {
 
 	delete[] _frameSizes;
 	_frameSizes = 0;
+
+	delete[] _frameOffsets;
+	_frameOffsets = 0;
+
+	_keyFrames.clear();
+	_lastIndexedFrame = -1;
+}
+
+bool SmackerDecoder::seekIntern(const Audio::Timestamp &time) {
+	// The video track has already been set to the requested frame
+	SmackerVideoTrack *videoTrack = (SmackerVideoTrack *)getTrack(0);
+	uint32 targetFrame = videoTrack->getCurFrame() + 1;
+
+	// Find the closest key frame before the target. The first frame
+	// always works, as it is decoded onto an empty surface.
+	uint32 keyFrame = 0;
+	const byte *palette = 0;
+
+	for (uint i = _keyFrames.size(); i > 0; i--) {
+		if (_keyFrames[i - 1].frame <= targetFrame) {
+			keyFrame = _keyFrames[i - 1].frame;
+			palette = _keyFrames[i - 1].palette;
+			break;
+		}
+	}
+
+	videoTrack->restoreKeyFrame(keyFrame, palette);
+	_fileStream->seek(_frameOffsets[keyFrame]);
+
+	// Decode the video up to the target, without queuing its audio
+	while ((uint32)(videoTrack->getCurFrame() + 1) < targetFrame)
+		readFrame(false);
+
+	seekAudio(time, targetFrame);
+	return true;
+}
+
+void SmackerDecoder::seekAudio(const Audio::Timestamp &time, uint32 targetFrame) {
+	const AudioInfo &audioInfo = _header.audioInfo[0];
+
+	if (!audioInfo.hasAudio || (audioInfo.compression != kCompressionNone && audioInfo.compression != kCompressionDPCM))
+		return;
+
+	SmackerVideoTrack *videoTrack = (SmackerVideoTrack *)getTrack(0);
+	SmackerAudioTrack *audioTrack = (SmackerAudioTrack *)getTrack(1);
+	const uint32 frameCount = videoTrack->getFrameCount();
+	const int32 videoPos = _fileStream->pos();
+
+	// Audio is usually stored ahead of the video, so the audio for the
+	// target time is found in an earlier frame. Its position follows from
+	// the unpacked sizes of the audio chunks before it.
+	const uint32 sampleSize = (audioInfo.isStereo ? 2 : 1) * (audioInfo.is16Bits ? 2 : 1);
+	const uint64 targetBytes = (uint64)time.convertToFramerate(audioInfo.sampleRate).totalNumberOfFrames() * sampleSize;
+	uint64 bytes = 0, resumeBytes = 0, firstAfterBytes = 0;
+	uint32 resumeFrame = frameCount, firstAfterFrame = frameCount;
+
+	for (uint32 frame = 0; frame < frameCount; frame++) {
+		uint32 chunkSize, unpackedSize;
+		if (!readAudioChunkHeader(frame, chunkSize, unpackedSize))
+			continue;
+
+		if (frame >= targetFrame && firstAfterFrame == frameCount) {
+			firstAfterFrame = frame;
+			firstAfterBytes = bytes;
+		}
+
+		if (bytes <= targetBytes) {
+			resumeFrame = frame;
+			resumeBytes = bytes;
+		}
+
+		bytes += unpackedSize;
+
+		if (bytes > targetBytes && firstAfterFrame != frameCount)
+			break;
+	}
+
+	if (resumeFrame != frameCount) {
+		// The audio queued first is either the one audio resumes from, if
+		// it is before the target frame, or the first one read afterwards.
+		// The track drops what comes before the target time.
+		const uint64 startBytes = (resumeFrame < targetFrame) ? resumeBytes : firstAfterBytes;
+		audioTrack->skipAudio(targetBytes > startBytes ? targetBytes - startBytes : 0);
+
+		for (uint32 frame = resumeFrame; frame < targetFrame; frame++) {
+			uint32 chunkSize, unpackedSize;
+			if (readAudioChunkHeader(frame, chunkSize, unpackedSize))
+				handleAudioTrack(0, chunkSize, unpackedSize);
+		}
+	}
+
+	_fileStream->seek(videoPos);
 }
 
-bool SmackerDecoder::rewind() {
-	// Call the parent method to rewind the tracks first
-	if (!VideoDecoder::rewind())
+bool SmackerDecoder::readAudioChunkHeader(uint32 frame, uint32 &chunkSize, uint32 &unpackedSize) {
+	if (!(_frameTypes[frame] & 2))
 		return false;
 
-	// And seek back to where the first frame begins
-	_fileStream->seek(_firstFrameStart);
+	_fileStream->seek(_frameOffsets[frame]);
+
+	// Skip the palette, its size includes the size byte
+	if (_frameTypes[frame] & 1) {
+		const int32 palettePos = _fileStream->pos();
+		_fileStream->seek(palettePos + 4 * _fileStream->readByte());
+	}
+
+	chunkSize = _fileStream->readUint32LE() - 4;
+
+	if (_header.audioInfo[0].compression == kCompressionNone) {
+		unpackedSize = chunkSize;
+	} else {
+		unpackedSize = _fileStream->readUint32LE();
+		chunkSize -= 4;
+	}
+
 	return true;
 }
 
@@ -424,6 +536,11 @@ void SmackerDecoder::readNextPacket() {
 	if (videoTrack->endOfTrack())
 		return;
 
+	readFrame(true);
+}
+
+void SmackerDecoder::readFrame(bool queueAudio) {
+	SmackerVideoTrack *videoTrack = (SmackerVideoTrack *)getTrack(0);
 	videoTrack->increaseCurFrame();
 
 	uint i;
@@ -432,6 +549,16 @@ void SmackerDecoder::readNextPacket() {
 
 	uint32 startPos = _fileStream->pos();
 
+	// Frames we have not seen before are checked for being key frames
+	bool indexFrame = videoTrack->getCurFrame() > _lastIndexedFrame;
+	KeyFrame keyFrame;
+
+	if (indexFrame) {
+		keyFrame.frame = videoTrack->getCurFrame();
+		memcpy(keyFrame.palette, videoTrack->peekPalette(), 3 * 256);
+		_lastIndexedFrame = videoTrack->getCurFrame();
+	}
+
 	// Check if we got a frame with palette data, and
 	// call back the virtual setPalette function to set
 	// the current palette
@@ -453,7 +580,10 @@ void SmackerDecoder::readNextPacket() {
 			chunkSize -= 4;    // subtract the next 4 bytes (unpacked data size)
 		}
 
-		handleAudioTrack(i, chunkSize, dataSizeUnpacked);
+		if (queueAudio)
+			handleAudioTrack(i, chunkSize, dataSizeUnpacked);
+		else
+			_fileStream->skip(chunkSize);
 	}
 
 	uint32 frameSize = _frameSizes[videoTrack->getCurFrame()] & ~3;
@@ -471,7 +601,9 @@ void SmackerDecoder::readNextPacket() {
 	_fileStream->read(frameData, frameDataSize);
 
 	Common::BitStream8LSB bs(new Common::MemoryReadStream(frameData, frameDataSize + 1, DisposeAfterUse::YES), true);
-	videoTrack->decodeFrame(bs);
+
+	if (videoTrack->decodeFrame(bs) && indexFrame && keyFrame.frame != 0)
+		_keyFrames.push_back(keyFrame);
 
 	_fileStream->seek(startPos + frameSize);
 }
@@ -551,7 +683,27 @@ void SmackerDecoder::SmackerVideoTrack::readTrees(Common::BitStream &bs, uint32
 	_TypeTree = new BigHuffmanTree(bs, typeSize);
 }
 
-void SmackerDecoder::SmackerVideoTrack::decodeFrame(Common::BitStream &bs) {
+bool SmackerDecoder::SmackerVideoTrack::seek(const Audio::Timestamp &time) {
+	_curFrame = MIN<uint>(getFrameAtTime(time), _frameCount) - 1;
+	return true;
+}
+
+void SmackerDecoder::SmackerVideoTrack::restoreKeyFrame(uint32 frame, const byte *palette) {
+	_curFrame = frame - 1;
+
+	if (palette)
+		memcpy(_palette, palette, 3 * 256);
+	else
+		memset(_palette, 0, 3 * 256);
+
+	_dirtyPalette = true;
+
+	// The first frame may rely on the surface being empty
+	if (frame == 0)
+		memset(_surface->pixels, 0, _surface->pitch * _surface->h);
+}
+
+bool SmackerDecoder::SmackerVideoTrack::decodeFrame(Common::BitStream &bs) {
 	_MMapTree->reset();
 	_MClrTree->reset();
 	_FullTree->reset();
@@ -570,6 +722,7 @@ void SmackerDecoder::SmackerVideoTrack::decodeFrame(Common::BitStream &bs) {
 	uint32 p1, p2, clr, map;
 	byte hi, lo;
 	uint i;
+	bool fullFrame = true;
 
 	while (block < blocks) {
 		type = _TypeTree->getCode(bs);
@@ -674,6 +827,7 @@ void SmackerDecoder::SmackerVideoTrack::decodeFrame(Common::BitStream &bs) {
 		case SMK_BLOCK_SKIP:
 			while (run-- && block < blocks)
 				block++;
+			fullFrame = false;
 			break;
 		case SMK_BLOCK_FILL:
 			uint32 col;
@@ -690,6 +844,8 @@ void SmackerDecoder::SmackerVideoTrack::decodeFrame(Common::BitStream &bs) {
 			break;
 		}
 	}
+
+	return fullFrame;
 }
 
 void SmackerDecoder::SmackerVideoTrack::unpackPalette(Common::SeekableReadStream *stream) {
@@ -748,6 +904,7 @@ void SmackerDecoder::SmackerVideoTrack::unpackPalette(Common::SeekableReadStream
 SmackerDecoder::SmackerAudioTrack::SmackerAudioTrack(const AudioInfo &audioInfo, Audio::Mixer::SoundType soundType) :
 		_audioInfo(audioInfo), _soundType(soundType) {
 	_audioStream = Audio::makeQueuingAudioStream(_audioInfo.sampleRate, _audioInfo.isStereo);
+	_skipBytes = 0;
 }
 
 SmackerDecoder::SmackerAudioTrack::~SmackerAudioTrack() {
@@ -757,6 +914,7 @@ SmackerDecoder::SmackerAudioTrack::~SmackerAudioTrack() {
 bool SmackerDecoder::SmackerAudioTrack::rewind() {
 	delete _audioStream;
 	_audioStream = Audio::makeQueuingAudioStream(_audioInfo.sampleRate, _audioInfo.isStereo);
+	_skipBytes = 0;
 	return true;
 }
 
@@ -853,6 +1011,20 @@ void SmackerDecoder::SmackerAudioTrack::queuePCM(byte *buffer, uint32 bufferSize
 	if (_audioInfo.isStereo)
 		flags |= Audio::FLAG_STEREO;
 
+	// Drop the audio before a seek target
+	if (_skipBytes > 0) {
+		const uint32 skip = MIN<uint64>(_skipBytes, bufferSize);
+		_skipBytes -= skip;
+		bufferSize -= skip;
+
+		if (!bufferSize) {
+			free(buffer);
+			return;
+		}
+
+		memmove(buffer, buffer + skip, bufferSize);
+	}
+
 	_audioStream->queueBuffer(buffer, bufferSize, DisposeAfterUse::YES, flags);
 }
 
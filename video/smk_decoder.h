@@ -65,10 +65,9 @@ public:
 	virtual bool loadStream(Common::SeekableReadStream *stream);
 	void close();
 
-	bool rewind();
-
 protected:
 	void readNextPacket();
+	bool seekIntern(const Audio::Timestamp &time);
 
 	virtual void handleAudioTrack(byte track, uint32 chunkSize, uint32 unpackedSize);
 
@@ -79,6 +78,8 @@ protected:
 
 		bool isRewindable() const { return true; }
 		bool rewind() { _curFrame = -1; return true; }
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time);
 
 		uint16 getWidth() const;
 		uint16 getHeight() const;
@@ -91,9 +92,16 @@ protected:
 
 		void readTrees(Common::BitStream &bs, uint32 mMapSize, uint32 mClrSize, uint32 fullSize, uint32 typeSize);
 		void increaseCurFrame() { _curFrame++; }
-		void decodeFrame(Common::BitStream &bs);
+		bool decodeFrame(Common::BitStream &bs);
 		void unpackPalette(Common::SeekableReadStream *stream);
 
+		/**
+		 * Prepare the track for decoding from the given key frame, using
+		 * the palette as it was before that frame (or a black one if 0).
+		 */
+		void restoreKeyFrame(uint32 frame, const byte *palette);
+		const byte *peekPalette() const { return _palette; }
+
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
 
@@ -151,8 +159,23 @@ protected:
 	} _header;
 
 	uint32 *_frameSizes;
+	uint32 *_frameOffsets;
 
 private:
+	void readFrame(bool queueAudio);
+
+	/**
+	 * Queue the audio of the first audio track from the target time on,
+	 * after the video has been seeked to the target frame.
+	 */
+	void seekAudio(const Audio::Timestamp &time, uint32 targetFrame);
+
+	/**
+	 * Position the stream at the audio data of the first audio track in a
+	 * frame.
+	 * @return false if the frame has no such audio
+	 */
+	bool readAudioChunkHeader(uint32 frame, uint32 &chunkSize, uint32 &unpackedSize);
 
 	class SmackerAudioTrack : public AudioTrack {
 	public:
@@ -161,6 +184,11 @@ private:
 
 		bool isRewindable() const { return true; }
 		bool rewind();
+		bool isSeekable() const { return true; }
+		bool seek(const Audio::Timestamp &time) { return rewind(); }
+
+		/** Drop the given number of bytes from the audio queued next. */
+		void skipAudio(uint64 bytes) { _skipBytes = bytes; }
 
 		Audio::Mixer::SoundType getSoundType() const { return _soundType; }
 
@@ -174,6 +202,7 @@ private:
 		Audio::Mixer::SoundType _soundType;
 		Audio::QueuingAudioStream *_audioStream;
 		AudioInfo _audioInfo;
+		uint64 _skipBytes;
 	};
 
 	// The FrameTypes section of a Smacker file contains an array of bytes, where
@@ -185,6 +214,17 @@ private:
 
 	uint32 _firstFrameStart;
 
+	// Frames which redraw the whole surface, along with the palette from
+	// before that frame. Seeking decodes onwards from the closest one.
+	// The list is filled in while frames are decoded.
+	struct KeyFrame {
+		uint32 frame;
+		byte palette[3 * 256];
+	};
+
+	Common::Array<KeyFrame> _keyFrames;
+	int32 _lastIndexedFrame;
+
 	Audio::Mixer::SoundType _soundType;
 };
 
@@ -27,12 +27,106 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/singleton.h"
 #include "common/system.h"
+#include "common/timer.h"
 
+#include "graphics/conversion.h"
 #include "graphics/palette.h"
 
 namespace Video {
 
+/**
+ * Runs the decoding ahead of time of all decoders from a single timer
+ * callback, since the timer manager only allows installing a callback once.
+ */
+class DecodeAheadWorker : public Common::Singleton<DecodeAheadWorker> {
+public:
+	void addDecoder(VideoDecoder *decoder);
+
+	/**
+	 * Remove a decoder from the worker. When this returns, the worker is
+	 * guaranteed not to touch the decoder anymore.
+	 */
+	void removeDecoder(VideoDecoder *decoder);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+
+	DecodeAheadWorker() : _installed(false) {}
+
+	static void timerProc(void *refCon);
+
+	Common::Array<VideoDecoder *> _decoders;
+	bool _installed;
+
+	// The timer thread walks the list while the engine adds and removes
+	// decoders
+	Common::Mutex _mutex;
+
+	// Guards _installed. The timer manager calls timerProc() with its own
+	// mutex held, which then takes _mutex, so the timer must be installed
+	// and removed without holding _mutex.
+	Common::Mutex _installMutex;
+};
+
+} // End of namespace Video
+
+namespace Common {
+DECLARE_SINGLETON(Video::DecodeAheadWorker);
+}
+
+namespace Video {
+
+// How often the decode-ahead timer runs (in microseconds)
+static const int32 kDecodeAheadInterval = 10000;
+
+void DecodeAheadWorker::addDecoder(VideoDecoder *decoder) {
+	Common::StackLock installLock(_installMutex);
+
+	{
+		Common::StackLock lock(_mutex);
+		_decoders.push_back(decoder);
+	}
+
+	if (!_installed) {
+		g_system->getTimerManager()->installTimerProc(&timerProc, kDecodeAheadInterval, this, "videoDecodeAhead");
+		_installed = true;
+	}
+}
+
+void DecodeAheadWorker::removeDecoder(VideoDecoder *decoder) {
+	Common::StackLock installLock(_installMutex);
+	bool empty;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _decoders.size(); i++) {
+			if (_decoders[i] == decoder) {
+				_decoders.remove_at(i);
+				break;
+			}
+		}
+
+		empty = _decoders.empty();
+	}
+
+	// Don't keep waking up without anything to do
+	if (empty && _installed) {
+		g_system->getTimerManager()->removeTimerProc(&timerProc);
+		_installed = false;
+	}
+}
+
+void DecodeAheadWorker::timerProc(void *refCon) {
+	DecodeAheadWorker *worker = (DecodeAheadWorker *)refCon;
+	Common::StackLock lock(worker->_mutex);
+
+	for (uint i = 0; i < worker->_decoders.size(); i++)
+		worker->_decoders[i]->decodeAhead();
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -46,6 +140,16 @@ VideoDecoder::VideoDecoder() {
 	_endTime = 0;
 	_endTimeSet = false;
 	_nextVideoTrack = 0;
+	_decodeAheadSize = 0;
+	_decodeAheadHead = 0;
+	_decodeAheadCount = 0;
+	_decodeAheadCurFrame = -1;
+	memset(&_decodeAheadStats, 0, sizeof(_decodeAheadStats));
+	_outputPixels = 0;
+	_outputPitch = 0;
+	memset(_outputPalette, 0, sizeof(_outputPalette));
+	memset(_outputPaletteMap, 0, sizeof(_outputPaletteMap));
+	_outputPaletteMapValid = false;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -54,7 +158,19 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	setDecodeAhead(0);
+	_outputSurface.free();
+}
+
 void VideoDecoder::close() {
+	// Stop decoding ahead before the tracks go away. This must happen
+	// without holding _decodeMutex, which the worker takes while holding
+	// its own mutex.
+	setDecodeAhead(0);
+
+	Common::StackLock lock(_decodeMutex);
+
 	if (isPlaying())
 		stop();
 
@@ -73,6 +189,7 @@ void VideoDecoder::close() {
 	_endTime = 0;
 	_endTimeSet = false;
 	_nextVideoTrack = 0;
+	flushDecodeAhead();
 }
 
 bool VideoDecoder::loadFile(const Common::String &filename) {
@@ -103,6 +220,8 @@ void VideoDecoder::pauseVideo(bool pause) {
 		return;
 	}
 
+	Common::StackLock lock(_decodeMutex);
+
 	if (_pauseLevel == 1 && pause) {
 		_pauseStartTime = g_system->getMillis(); // Store the starting time from pausing to keep it for later
 
@@ -158,6 +277,9 @@ uint16 VideoDecoder::getHeight() const {
 }
 
 Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
+	if (_outputFormat.bytesPerPixel != 0)
+		return _outputFormat;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
 			return ((VideoTrack *)*it)->getPixelFormat();
@@ -168,6 +290,9 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 
+	if (isDecodingAhead())
+		return popDecodedFrame();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -182,6 +307,12 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 		_dirtyPalette = true;
 	}
 
+	if (frame && needsOutputConversion(*frame)) {
+		Graphics::Surface *output = getOutputSurface(frame->w, frame->h);
+		convertFrame(*frame, _nextVideoTrack->getPalette(), *output);
+		frame = output;
+	}
+
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
 
@@ -193,6 +324,8 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	Common::StackLock lock(_decodeMutex);
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -204,6 +337,7 @@ bool VideoDecoder::setReverse(bool reverse) {
 	}
 
 	findNextVideoTrack();
+	flushDecodeAhead();
 	return true;
 }
 
@@ -213,6 +347,13 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (isDecodingAhead())
+		return _decodeAheadCurFrame;
+
+	return getTrackCurFrame();
+}
+
+int VideoDecoder::getTrackCurFrame() const {
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -254,13 +395,26 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool reversed;
+
+	if (isDecodingAhead()) {
+		if (!getNextDecodedFrameTime(nextFrameStartTime, reversed))
+			return 0;
+	} else {
+		if (!_nextVideoTrack)
+			return 0;
+
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		reversed = _nextVideoTrack->isReversed();
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (reversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -276,6 +430,14 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	if (isDecodingAhead()) {
+		for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+			if ((*it)->getTrackType() == Track::kTrackTypeAudio && !(*it)->endOfTrack())
+				return false;
+
+		return !hasFramesLeft();
+	}
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->endOfTrack() && (!isPlaying() || (*it)->getTrackType() != Track::kTrackTypeVideo || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return false;
@@ -298,6 +460,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	Common::StackLock lock(_decodeMutex);
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -306,6 +470,9 @@ bool VideoDecoder::rewind() {
 		if (!(*it)->rewind())
 			return false;
 
+	if (!seekIntern(Audio::Timestamp(0, 1000)))
+		return false;
+
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
 		startAudio();
@@ -314,6 +481,7 @@ bool VideoDecoder::rewind() {
 	_startTime = g_system->getMillis();
 	resetPauseStartTime();
 	findNextVideoTrack();
+	flushDecodeAhead();
 	return true;
 }
 
@@ -332,6 +500,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	Common::StackLock lock(_decodeMutex);
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -340,6 +510,9 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 		if (!(*it)->seek(time))
 			return false;
 
+	if (!seekIntern(time))
+		return false;
+
 	_lastTimeChange = time;
 
 	// Now that we've seeked, start all tracks again
@@ -351,6 +524,7 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 
 	resetPauseStartTime();
 	findNextVideoTrack();
+	flushDecodeAhead();
 	_needsUpdate = true;
 	return true;
 }
@@ -393,6 +567,8 @@ void VideoDecoder::stop() {
 	if (!isPlaying())
 		return;
 
+	Common::StackLock lock(_decodeMutex);
+
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
@@ -530,7 +706,14 @@ uint VideoDecoder::FixedRateVideoTrack::getFrameAtTime(const Audio::Timestamp &t
 		return time.totalNumberOfFrames();
 
 	// Default case
-	return (time.totalNumberOfFrames() * frameRate / time.framerate()).toInt();
+	uint frame = (time.totalNumberOfFrames() * frameRate / time.framerate()).toInt();
+
+	// getFrameTime() rounds down to whole milliseconds for fractional
+	// frame rates, so make sure a frame's own start time maps back to it
+	if (getFrameTime(frame + 1) <= time)
+		frame++;
+
+	return frame;
 }
 
 Audio::Timestamp VideoDecoder::FixedRateVideoTrack::getDuration() const {
@@ -642,6 +825,8 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::String &base
 }
 
 void VideoDecoder::addTrack(Track *track) {
+	Common::StackLock lock(_decodeMutex);
+
 	_tracks.push_back(track);
 
 	if (track->getTrackType() == Track::kTrackTypeAudio) {
@@ -704,14 +889,14 @@ void VideoDecoder::setEndTime(const Audio::Timestamp &endTime) {
 }
 
 VideoDecoder::Track *VideoDecoder::getTrack(uint track) {
-	if (track > _tracks.size())
+	if (track >= _tracks.size())
 		return 0;
 
 	return _tracks[track];
 }
 
 const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
-	if (track > _tracks.size())
+	if (track >= _tracks.size())
 		return 0;
 
 	return _tracks[track];
@@ -770,6 +955,16 @@ void VideoDecoder::startAudioLimit(const Audio::Timestamp &limit) {
 }
 
 bool VideoDecoder::hasFramesLeft() const {
+	if (isDecodingAhead()) {
+		uint32 nextFrameStartTime;
+		bool reversed;
+
+		if (!getNextDecodedFrameTime(nextFrameStartTime, reversed))
+			return false;
+
+		return !isPlaying() || !_endTimeSet || nextFrameStartTime < (uint)_endTime.msecs();
+	}
+
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
@@ -788,4 +983,311 @@ bool VideoDecoder::hasAudio() const {
 	return false;
 }
 
+void VideoDecoder::setDecodeAhead(uint queueSize) {
+	if (queueSize == _decodeAheadSize)
+		return;
+
+	if (queueSize != 0 && _decodeAheadSize == 0)
+		DecodeAheadWorker::instance().addDecoder(this);
+	else if (queueSize == 0)
+		DecodeAheadWorker::instance().removeDecoder(this);
+
+	Common::StackLock lock(_decodeMutex);
+	Common::StackLock queueLock(_decodeAheadMutex);
+
+	for (uint i = 0; i < _decodeAheadQueue.size(); i++)
+		_decodeAheadQueue[i].surface.free();
+
+	// One more frame than queued is needed, since the frame returned
+	// last must stay valid while the queue is refilled.
+	_decodeAheadSize = queueSize;
+	_decodeAheadQueue.clear();
+
+	if (queueSize != 0)
+		_decodeAheadQueue.resize(queueSize + 1);
+
+	_decodeAheadHead = 0;
+	_decodeAheadCount = 0;
+	_decodeAheadCurFrame = getTrackCurFrame();
+	memset(&_decodeAheadStats, 0, sizeof(_decodeAheadStats));
+}
+
+VideoDecoder::DecodeAheadStats VideoDecoder::getDecodeAheadStats() const {
+	Common::StackLock lock(_decodeAheadMutex);
+	DecodeAheadStats stats = _decodeAheadStats;
+	stats.queueDepth = _decodeAheadCount;
+	return stats;
+}
+
+bool VideoDecoder::isDecodingAhead() const {
+	return _decodeAheadSize != 0 && supportsDecodeAhead();
+}
+
+void VideoDecoder::decodeAhead() {
+	if (!isDecodingAhead() || !isPlaying() || isPaused())
+		return;
+
+	Common::StackLock lock(_decodeMutex);
+
+	// Check again, now that the engine thread cannot change the state
+	if (!isPlaying() || isPaused() || !_nextVideoTrack)
+		return;
+
+	// Don't decode past the end time
+	if (_endTimeSet && _nextVideoTrack->getNextFrameStartTime() >= (uint)_endTime.msecs())
+		return;
+
+	decodeAheadFrame();
+}
+
+bool VideoDecoder::decodeAheadFrame() {
+	// The caller has to hold _decodeMutex
+	uint slot;
+
+	{
+		Common::StackLock lock(_decodeAheadMutex);
+
+		if (_decodeAheadCount >= _decodeAheadSize)
+			return false;
+
+		slot = (_decodeAheadHead + _decodeAheadCount) % _decodeAheadQueue.size();
+	}
+
+	readNextPacket();
+
+	if (!_nextVideoTrack)
+		return false;
+
+	// The slot is not visible to the engine thread until it is queued below
+	DecodedFrame &frame = _decodeAheadQueue[slot];
+	frame.startTime = _nextVideoTrack->getNextFrameStartTime();
+	frame.reversed = _nextVideoTrack->isReversed();
+
+	const Graphics::Surface *surface = _nextVideoTrack->decodeNextFrame();
+	frame.hasSurface = (surface != 0);
+
+	// Check the palette first, since getPalette() clears the dirty flag in
+	// most tracks
+	frame.dirtyPalette = _nextVideoTrack->hasDirtyPalette();
+
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _nextVideoTrack->getPalette(), 256 * 3);
+
+	if (surface) {
+		// Queue the frame already converted to the output format
+		Graphics::PixelFormat format = (_outputFormat.bytesPerPixel != 0) ? _outputFormat : surface->format;
+
+		if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != format) {
+			frame.surface.free();
+			frame.surface.create(surface->w, surface->h, format);
+		}
+
+		convertFrame(*surface, _nextVideoTrack->getPalette(), frame.surface);
+	}
+
+	frame.curFrame = getTrackCurFrame();
+
+	findNextVideoTrack();
+
+	Common::StackLock lock(_decodeAheadMutex);
+	_decodeAheadCount++;
+	_decodeAheadStats.framesDecoded++;
+	_decodeAheadStats.maxQueueDepth = MAX<uint32>(_decodeAheadStats.maxQueueDepth, _decodeAheadCount);
+	return true;
+}
+
+const VideoDecoder::DecodedFrame *VideoDecoder::peekDecodedFrame() const {
+	// Only the engine thread removes frames from the queue, so the
+	// returned frame stays valid until it calls popDecodedFrame().
+	Common::StackLock lock(_decodeAheadMutex);
+	return _decodeAheadCount ? &_decodeAheadQueue[_decodeAheadHead] : 0;
+}
+
+const Graphics::Surface *VideoDecoder::popDecodedFrame() {
+	if (!peekDecodedFrame()) {
+		// Nothing has been decoded yet, so decode the frame right away
+		Common::StackLock lock(_decodeMutex);
+
+		if (!peekDecodedFrame()) {
+			if (isPlaying()) {
+				Common::StackLock queueLock(_decodeAheadMutex);
+				_decodeAheadStats.underruns++;
+			}
+
+			if (!decodeAheadFrame())
+				return 0;
+		}
+	}
+
+	const DecodedFrame *frame;
+
+	{
+		Common::StackLock lock(_decodeAheadMutex);
+		frame = &_decodeAheadQueue[_decodeAheadHead];
+		_decodeAheadHead = (_decodeAheadHead + 1) % _decodeAheadQueue.size();
+		_decodeAheadCount--;
+	}
+
+	_decodeAheadCurFrame = frame->curFrame;
+
+	if (frame->dirtyPalette) {
+		memcpy(_decodeAheadPalette, frame->palette, 256 * 3);
+		_palette = _decodeAheadPalette;
+		_dirtyPalette = true;
+	}
+
+	// Check if we're already behind the following frame
+	if (isPlaying() && !isPaused() && !frame->reversed) {
+		const DecodedFrame *nextFrame = peekDecodedFrame();
+
+		if (nextFrame && nextFrame->startTime <= getTime()) {
+			Common::StackLock lock(_decodeAheadMutex);
+			_decodeAheadStats.lateFrames++;
+		}
+	}
+
+	if (!frame->hasSurface)
+		return 0;
+
+	// The frame is already converted, so just copy it if requested
+	if (_outputFormat.bytesPerPixel != 0 && _outputPixels) {
+		Graphics::Surface *output = getOutputSurface(frame->surface.w, frame->surface.h);
+		convertFrame(frame->surface, 0, *output);
+		return output;
+	}
+
+	return &frame->surface;
+}
+
+bool VideoDecoder::getNextDecodedFrameTime(uint32 &startTime, bool &reversed) const {
+	const DecodedFrame *frame = peekDecodedFrame();
+
+	if (frame) {
+		startTime = frame->startTime;
+		reversed = frame->reversed;
+		return true;
+	}
+
+	// Wait for a decode in progress, which might queue a frame
+	Common::StackLock lock(_decodeMutex);
+	frame = peekDecodedFrame();
+
+	if (frame) {
+		startTime = frame->startTime;
+		reversed = frame->reversed;
+		return true;
+	}
+
+	if (!_nextVideoTrack)
+		return false;
+
+	startTime = _nextVideoTrack->getNextFrameStartTime();
+	reversed = _nextVideoTrack->isReversed();
+	return true;
+}
+
+void VideoDecoder::flushDecodeAhead() {
+	// The caller has to hold _decodeMutex
+	Common::StackLock lock(_decodeAheadMutex);
+	_decodeAheadHead = 0;
+	_decodeAheadCount = 0;
+	_decodeAheadCurFrame = getTrackCurFrame();
+}
+
+void VideoDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	_outputFormat = format;
+	_outputSurface.free();
+	_outputPaletteMapValid = false;
+
+	// Let YUV videos decode straight to the requested format
+	if (format.bytesPerPixel > 1)
+		_defaultHighColorFormat = format;
+}
+
+void VideoDecoder::setOutputBuffer(void *pixels, uint16 pitch) {
+	_outputPixels = pixels;
+	_outputPitch = pitch;
+}
+
+bool VideoDecoder::needsOutputConversion(const Graphics::Surface &frame) const {
+	return _outputFormat.bytesPerPixel != 0 && (frame.format != _outputFormat || _outputPixels);
+}
+
+Graphics::Surface *VideoDecoder::getOutputSurface(uint16 width, uint16 height) {
+	if (_outputPixels) {
+		_outputBufferSurface.w = width;
+		_outputBufferSurface.h = height;
+		_outputBufferSurface.pitch = _outputPitch;
+		_outputBufferSurface.pixels = _outputPixels;
+		_outputBufferSurface.format = _outputFormat;
+		return &_outputBufferSurface;
+	}
+
+	if (_outputSurface.w != width || _outputSurface.h != height || _outputSurface.format != _outputFormat) {
+		_outputSurface.free();
+		_outputSurface.create(width, height, _outputFormat);
+	}
+
+	return &_outputSurface;
+}
+
+void VideoDecoder::convertFrame(const Graphics::Surface &src, const byte *palette, Graphics::Surface &dst) {
+	const byte *srcRow = (const byte *)src.pixels;
+	byte *dstRow = (byte *)dst.pixels;
+
+	if (src.format == dst.format) {
+		for (int y = 0; y < src.h; y++) {
+			memcpy(dstRow, srcRow, src.w * src.format.bytesPerPixel);
+			srcRow += src.pitch;
+			dstRow += dst.pitch;
+		}
+
+		return;
+	}
+
+	if (src.format.bytesPerPixel != 1) {
+		if (!Graphics::crossBlit(dstRow, srcRow, dst.pitch, src.pitch, src.w, src.h, dst.format, src.format))
+			warning("VideoDecoder::convertFrame(): Unsupported conversion from %dbpp to %dbpp", src.format.bytesPerPixel, dst.format.bytesPerPixel);
+
+		return;
+	}
+
+	// Palettized frames go through a color lookup table, which only
+	// needs to be updated when the palette changes
+	if (palette && (!_outputPaletteMapValid || memcmp(palette, _outputPalette, sizeof(_outputPalette)))) {
+		memcpy(_outputPalette, palette, sizeof(_outputPalette));
+		_outputPaletteMapValid = true;
+
+		for (int i = 0; i < 256; i++)
+			_outputPaletteMap[i] = dst.format.RGBToColor(palette[i * 3], palette[i * 3 + 1], palette[i * 3 + 2]);
+	}
+
+	switch (dst.format.bytesPerPixel) {
+	case 2:
+		for (int y = 0; y < src.h; y++) {
+			uint16 *dstPixel = (uint16 *)dstRow;
+
+			for (int x = 0; x < src.w; x++)
+				dstPixel[x] = _outputPaletteMap[srcRow[x]];
+
+			srcRow += src.pitch;
+			dstRow += dst.pitch;
+		}
+		break;
+	case 4:
+		for (int y = 0; y < src.h; y++) {
+			uint32 *dstPixel = (uint32 *)dstRow;
+
+			for (int x = 0; x < src.w; x++)
+				dstPixel[x] = _outputPaletteMap[srcRow[x]];
+
+			srcRow += src.pitch;
+			dstRow += dst.pitch;
+		}
+		break;
+	default:
+		warning("VideoDecoder::convertFrame(): Unsupported conversion from 1bpp to %dbpp", dst.format.bytesPerPixel);
+	}
+}
+
 } // End of namespace Video
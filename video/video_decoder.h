@@ -26,9 +26,11 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/mutex.h"
 #include "common/rational.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
+#include "graphics/surface.h"
 
 namespace Audio {
 class AudioStream;
@@ -40,10 +42,6 @@ namespace Common {
 class SeekableReadStream;
 }
 
-namespace Graphics {
-struct Surface;
-}
-
 namespace Video {
 
 /**
@@ -52,7 +50,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -285,6 +283,8 @@ public:
 
 	/**
 	 * Get the pixel format of the currently loaded video.
+	 *
+	 * If an output pixel format has been set, that format is returned.
 	 */
 	Graphics::PixelFormat getPixelFormat() const;
 
@@ -353,6 +353,37 @@ public:
 	 */
 	void setDefaultHighColorFormat(const Graphics::PixelFormat &format) { _defaultHighColorFormat = format; }
 
+	/**
+	 * Set the pixel format of the frames returned by decodeNextFrame().
+	 *
+	 * Videos that convert from YUV will decode straight to this format,
+	 * and frames in any other format, including palettized ones, are
+	 * converted to it in a single pass. This saves the caller from
+	 * converting each frame itself before showing it.
+	 *
+	 * By default, frames are returned in the format of their track.
+	 *
+	 * This must be set before calling loadStream().
+	 *
+	 * @param format the format to use, or a format with 0 bytes per pixel
+	 *               to return frames in the format of their track
+	 */
+	void setOutputPixelFormat(const Graphics::PixelFormat &format);
+
+	/**
+	 * Set a buffer for decodeNextFrame() to write the frames to instead
+	 * of an internal surface. The surface returned by decodeNextFrame()
+	 * then refers to this buffer.
+	 *
+	 * The buffer must be large enough to hold getWidth() x getHeight()
+	 * pixels in the output pixel format, and it is only used once an
+	 * output pixel format has been set.
+	 *
+	 * @param pixels the buffer to write to, or 0 to use an internal surface
+	 * @param pitch  the number of bytes per line of the buffer
+	 */
+	void setOutputBuffer(void *pixels, uint16 pitch);
+
 	/**
 	 * Set the video to decode frames in reverse.
 	 *
@@ -365,6 +396,48 @@ public:
 	 */
 	bool setReverse(bool reverse);
 
+	/**
+	 * Set the number of frames to decode ahead of time.
+	 *
+	 * When this is non-zero, frames are decoded from the timer thread
+	 * while the video is playing and kept in a queue of at most the
+	 * given number of surfaces. decodeNextFrame() then just hands out
+	 * the next queued frame. Seeking, rewinding and changing the
+	 * playback direction flush the queue, and no frames are decoded
+	 * ahead while the video is paused.
+	 *
+	 * By default, VideoDecoder decodes each frame when it is requested.
+	 *
+	 * @note This should be called after loading the video and before
+	 * start(), since changing it discards any frames already queued.
+	 * close() turns decoding ahead off again.
+	 * @note Decoders that do not support it just ignore the setting.
+	 * @param queueSize the number of frames to decode ahead, or 0 to disable
+	 */
+	void setDecodeAhead(uint queueSize);
+
+	/**
+	 * Get the number of frames to decode ahead of time.
+	 */
+	uint getDecodeAhead() const { return _decodeAheadSize; }
+
+	/**
+	 * Statistics about decoding ahead of time.
+	 */
+	struct DecodeAheadStats {
+		uint32 queueDepth;      ///< Number of frames currently queued
+		uint32 maxQueueDepth;   ///< Highest number of frames queued at once
+		uint32 framesDecoded;   ///< Number of frames decoded into the queue
+		uint32 lateFrames;      ///< Frames handed out after the following frame was already due
+		uint32 underruns;       ///< Frames that had to be decoded on request while playing
+	};
+
+	/**
+	 * Get the statistics about decoding ahead of time since the last
+	 * call to setDecodeAhead().
+	 */
+	DecodeAheadStats getDecodeAheadStats() const;
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -756,6 +829,17 @@ protected:
 	 */
 	virtual void readNextPacket() {}
 
+	/**
+	 * Function called by seek() and rewind() after all tracks have been
+	 * seeked, for subclasses to reposition any state shared between the
+	 * tracks, such as the file stream. No frames are decoded ahead of
+	 * time while this is called.
+	 *
+	 * @param time The time that was seeked to
+	 * @return true on success, false otherwise
+	 */
+	virtual bool seekIntern(const Audio::Timestamp &time) { return true; }
+
 	/**
 	 * Define a track to be used by this class.
 	 *
@@ -770,6 +854,15 @@ protected:
 	 */
 	virtual bool useAudioSync() const { return true; }
 
+	/**
+	 * Whether or not frames may be decoded ahead of time on the timer thread.
+	 *
+	 * A subclass which accesses its tracks or its stream from the engine
+	 * thread outside of readNextPacket() and the tracks should override
+	 * this to disable the feature.
+	 */
+	virtual bool supportsDecodeAhead() const { return true; }
+
 	/**
 	 * Get the given track based on its index.
 	 *
@@ -838,12 +931,56 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Output conversion settings
+	Graphics::PixelFormat _outputFormat;
+	Graphics::Surface _outputSurface, _outputBufferSurface;
+	void *_outputPixels;
+	uint16 _outputPitch;
+	byte _outputPalette[256 * 3];
+	uint32 _outputPaletteMap[256];
+	bool _outputPaletteMapValid;
+
+	bool needsOutputConversion(const Graphics::Surface &frame) const;
+	Graphics::Surface *getOutputSurface(uint16 width, uint16 height);
+	void convertFrame(const Graphics::Surface &src, const byte *palette, Graphics::Surface &dst);
+
 	// Internal helper functions
 	void stopAudio();
 	void startAudio();
 	void startAudioLimit(const Audio::Timestamp &limit);
 	bool hasFramesLeft() const;
 	bool hasAudio() const;
+	int getTrackCurFrame() const;
+
+	// Frames decoded ahead of time
+	struct DecodedFrame {
+		Graphics::Surface surface;
+		bool hasSurface;
+		uint32 startTime;
+		bool reversed;
+		int curFrame;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	Common::Array<DecodedFrame> _decodeAheadQueue;
+	uint _decodeAheadSize, _decodeAheadHead, _decodeAheadCount;
+	int _decodeAheadCurFrame;
+	byte _decodeAheadPalette[256 * 3];
+	DecodeAheadStats _decodeAheadStats;
+
+	// _decodeMutex is held while the tracks are used from the timer
+	// thread; _decodeAheadMutex only guards the queue itself.
+	Common::Mutex _decodeMutex, _decodeAheadMutex;
+
+	friend class DecodeAheadWorker;
+	bool isDecodingAhead() const;
+	void decodeAhead();
+	bool decodeAheadFrame();
+	const Graphics::Surface *popDecodedFrame();
+	const DecodedFrame *peekDecodedFrame() const;
+	bool getNextDecodedFrameTime(uint32 &startTime, bool &reversed) const;
+	void flushDecodeAhead();
 
 	int32 _startTime;
 	uint32 _pauseLevel;